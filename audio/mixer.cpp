@@ -22,6 +22,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/atomic.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -40,11 +41,14 @@ namespace Audio {
 
 /**
  * Channel used by the default Mixer implementation.
+ *
+ * When rendering ahead, the channel is its own worker job: run() converts
+ * the stream into the render ring, which mix() then consumes.
  */
-class Channel {
+class Channel : public Common::WorkerJob {
 public:
 	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
-	~Channel();
+	virtual ~Channel();
 
 	/**
 	 * Mixes the channel's samples into the given buffer.
@@ -60,7 +64,33 @@ public:
 	/**
 	 * Queries whether the channel is still playing or not.
 	 */
-	bool isFinished() const { return _stream->endOfStream(); }
+	bool isFinished() const;
+
+	/**
+	 * Allocates the render ring. Called on the engine side, rendering only
+	 * starts once startRenderAhead() is called on the mixing side.
+	 *
+	 * @param frames how many frames to render ahead at most
+	 */
+	void prepareRenderAhead(uint frames);
+
+	/**
+	 * Queries whether prepareRenderAhead() was called.
+	 */
+	bool isRenderAhead() const { return _renderBuffer != 0; }
+
+	/**
+	 * Switches mixing over to the render ring and queues the first job.
+	 *
+	 * @param pool      the pool to render on
+	 * @param underruns counter to increment when the ring runs dry
+	 */
+	void startRenderAhead(Common::WorkerPool *pool, uint32 *underruns);
+
+	/**
+	 * Fills the render ring. Runs on a worker thread.
+	 */
+	virtual void run();
 
 	/**
 	 * Queries whether the channel is a permanent channel.
@@ -74,19 +104,41 @@ public:
 	 */
 	int getId() const { return _id; }
 
+	/**
+	 * Returns the sample rate of the channel's stream.
+	 */
+	uint32 getStreamRate() const { return _stream->getRate(); }
+
 	/**
 	 * Pauses or unpaused the channel in a recursive fashion.
 	 *
-	 * @param paused true, when the channel should be paused.
-	 *               false when it should be unpaused.
+	 * @param paused    true, when the channel should be paused.
+	 *                  false when it should be unpaused.
+	 * @param pauseTime set to the time spent paused, when the channel
+	 *                  is unpaused.
+	 * @return true when the channel got paused or unpaused, i.e. the
+	 *         change has to be passed on with setMixPaused().
 	 */
-	void pause(bool paused);
+	bool pause(bool paused, uint32 &pauseTime);
 
 	/**
 	 * Queries whether the channel is currently paused.
 	 */
 	bool isPaused() const { return (_pauseLevel != 0); }
 
+	/**
+	 * Sets the paused state used while mixing.
+	 *
+	 * @param paused    whether mixing the channel should be skipped
+	 * @param pauseTime time spent paused, see pause()
+	 */
+	void setMixPaused(bool paused, uint32 pauseTime);
+
+	/**
+	 * Queries whether mixing the channel is currently skipped.
+	 */
+	bool isMixPaused() const { return _mixPaused; }
+
 	/**
 	 * Sets the channel's own volume.
 	 *
@@ -116,10 +168,15 @@ public:
 	int8 getBalance();
 
 	/**
-	 * Notifies the channel that the global sound type
-	 * volume settings changed.
+	 * Computes the effective volume for the left and right channel from
+	 * the channel volume and balance and the global sound type volume.
 	 */
-	void notifyGlobalVolChange() { updateChannelVolumes(); }
+	void computeVolumes(st_volume_t &volL, st_volume_t &volR) const;
+
+	/**
+	 * Sets the effective volumes used while mixing.
+	 */
+	void setMixVolumes(st_volume_t volL, st_volume_t volR) { _volL = volL; _volR = volR; }
 
 	/**
 	 * Queries how long the channel has been playing.
@@ -153,7 +210,8 @@ private:
 	byte _volume;
 	int8 _balance;
 
-	void updateChannelVolumes();
+	// The following are only accessed while mixing
+	bool _mixPaused;
 	st_volume_t _volL, _volR;
 
 	Mixer *_mixer;
@@ -166,24 +224,60 @@ private:
 
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
+
+	enum {
+		RENDER_CHUNK_SIZE = 256
+	};
+
+	int mixRendered(int16 *data, uint len);
+	void scheduleRender();
+
+	// Render-ahead state. The ring is written by the worker and read while
+	// mixing, _renderRead and _renderWrite count frames and wrap around.
+	int16 *_renderBuffer;
+	uint32 _renderSize;
+	uint32 _renderLimit;
+	uint32 _renderRead;
+	uint32 _renderWrite;
+	bool _renderQueued;
+	bool _renderDone;
+	bool _renderCancel;
+	Common::WorkerPool *_renderPool;
+	uint32 *_renderUnderruns;
 };
 
 #pragma mark -
 #pragma mark --- Mixer ---
 #pragma mark -
 
-MixerImpl::MixerImpl(uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+MixerImpl::MixerImpl(uint sampleRate, bool lockFree)
+	: _mutex(), _mixMutex(), _sampleRate(sampleRate), _lockFree(lockFree), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _renderAheadFrames(0), _renderPool(0), _renderUnderruns(0) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+#ifdef OUTPUT_UNSIGNED_AUDIO
+	// The block mixer accumulates signed samples
+	_lockFree = false;
+#endif
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		_channels[i] = 0;
+		_mixChannels[i] = 0;
+	}
 }
 
 MixerImpl::~MixerImpl() {
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		delete _channels[i];
+	Common::StackLock lock(_mutex);
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		if (_channels[i])
+			removeChannel(i);
+	}
+
+	syncMixer();
+
+	delete _renderPool;
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -196,6 +290,124 @@ uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
 
+void MixerImpl::setRenderAhead(uint msecs, uint numThreads) {
+	Common::StackLock lock(_mutex);
+
+	_renderAheadFrames = (uint)(((uint64)msecs * _sampleRate) / 1000);
+	if (_renderAheadFrames && !_renderPool)
+		_renderPool = new Common::WorkerPool(numThreads);
+}
+
+uint32 MixerImpl::getRenderAheadUnderruns() const {
+	return Common::atomicLoadAcquire(_renderUnderruns);
+}
+
+void MixerImpl::sendCommand(const Command &cmd) {
+	if (!_lockFree) {
+		executeCommand(cmd);
+		return;
+	}
+
+	// If the audio thread is lagging behind, apply the pending commands
+	// ourselves to make room.
+	if (_commands.full())
+		syncMixer();
+
+	bool queued = _commands.push(cmd);
+	assert(queued);
+	(void)queued;
+}
+
+void MixerImpl::executeCommand(const Command &cmd) {
+	switch (cmd.type) {
+	case Command::kInsert:
+		_mixChannels[cmd.index] = cmd.chan;
+		break;
+
+	case Command::kRemove:
+		if (_mixChannels[cmd.index] == cmd.chan)
+			_mixChannels[cmd.index] = 0;
+		releaseChannel(cmd.index, cmd.chan);
+		break;
+
+	case Command::kVolume:
+		cmd.chan->setMixVolumes(cmd.volL, cmd.volR);
+		break;
+
+	case Command::kPause:
+		cmd.chan->setMixPaused(cmd.paused, cmd.pauseTime);
+		break;
+
+	case Command::kRenderAhead:
+		cmd.chan->startRenderAhead(_renderPool, &_renderUnderruns);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void MixerImpl::processCommands() {
+	Command cmd;
+	while (_commands.peek(cmd)) {
+		// Every command causes at most one event, so stop draining instead of
+		// losing one if the engine side has not caught up yet.
+		if (_events.full())
+			break;
+
+		_commands.pop(cmd);
+		executeCommand(cmd);
+	}
+}
+
+void MixerImpl::releaseChannel(int index, Channel *chan) {
+	if (!_lockFree) {
+		delete chan;
+		return;
+	}
+
+	// Hand the channel back, so that its stream is destroyed on the
+	// engine side and not in the audio thread.
+	bool queued = _events.push(Event(Event::kReleased, index, chan));
+	assert(queued);
+	(void)queued;
+}
+
+void MixerImpl::processEvents() {
+	if (!_lockFree)
+		return;
+
+	Event event;
+	while (_events.pop(event)) {
+		switch (event.type) {
+		case Event::kFinished:
+			// The channel might have been stopped in the meantime, in which
+			// case its removal is already queued.
+			if (_channels[event.index] == event.chan)
+				removeChannel(event.index);
+			break;
+
+		case Event::kReleased:
+			delete event.chan;
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+void MixerImpl::syncMixer() {
+	if (!_lockFree)
+		return;
+
+	Common::StackLock lock(_mixMutex);
+	do {
+		processCommands();
+		processEvents();
+	} while (!_commands.empty());
+}
+
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
@@ -219,6 +431,40 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	updateChannelVolumes(chan);
+	sendCommand(Command(Command::kInsert, index, chan));
+}
+
+void MixerImpl::removeChannel(int index) {
+	Channel *chan = _channels[index];
+	assert(chan);
+
+	_channels[index] = 0;
+	sendCommand(Command(Command::kRemove, index, chan));
+}
+
+void MixerImpl::updateChannelVolumes(Channel *chan) {
+	Command cmd(Command::kVolume, 0, chan);
+	chan->computeVolumes(cmd.volL, cmd.volR);
+	sendCommand(cmd);
+}
+
+void MixerImpl::pauseChannel(Channel *chan, bool paused) {
+	Command cmd(Command::kPause, 0, chan);
+	if (!chan->pause(paused, cmd.pauseTime))
+		return;
+
+	cmd.paused = paused;
+	sendCommand(cmd);
+}
+
+Channel *MixerImpl::findChannel(SoundHandle handle) const {
+	const int index = handle._val % NUM_CHANNELS;
+	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+		return 0;
+
+	return _channels[index];
 }
 
 void MixerImpl::playStream(
@@ -239,6 +485,8 @@ void MixerImpl::playStream(
 
 	assert(_mixerReady);
 
+	processEvents();
+
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
@@ -269,7 +517,7 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(mutex());
 
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
@@ -279,18 +527,22 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
+	if (_lockFree) {
+		processCommands();
+		return mixBlocks(buf, len);
+	}
+
 	//  zero the buf
 	memset(buf, 0, 2 * len * sizeof(int16));
 
 	// mix all channels
 	int res = 0, tmp;
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i]) {
-			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = 0;
-			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
+		if (_mixChannels[i]) {
+			if (_mixChannels[i]->isFinished()) {
+				removeChannel(i);
+			} else if (!_mixChannels[i]->isMixPaused()) {
+				tmp = _mixChannels[i]->mix(buf, len);
 
 				if (tmp > res)
 					res = tmp;
@@ -300,45 +552,94 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	return res;
 }
 
+int MixerImpl::mixBlocks(int16 *buf, uint len) {
+	int processed[NUM_CHANNELS];
+	memset(processed, 0, sizeof(processed));
+
+	for (uint pos = 0; pos < len; pos += MIX_BLOCK_SIZE) {
+		const uint blockLen = MIN<uint>(MIX_BLOCK_SIZE, len - pos);
+		memset(_accumBuffer, 0, 2 * blockLen * sizeof(int32));
+
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			Channel *chan = _mixChannels[i];
+			if (!chan)
+				continue;
+
+			if (chan->isFinished()) {
+				// Stop mixing it and let the engine side remove it. The event
+				// queue is sized so that this cannot fail.
+				_mixChannels[i] = 0;
+				bool queued = _events.push(Event(Event::kFinished, i, chan));
+				assert(queued);
+				(void)queued;
+				continue;
+			}
+
+			if (chan->isMixPaused())
+				continue;
+
+			// Let the rate converter mix into a silent block and sum it up
+			// with full headroom, so that clipping happens only once.
+			memset(_blockBuffer, 0, 2 * blockLen * sizeof(int16));
+			processed[i] += chan->mix(_blockBuffer, blockLen);
+
+			for (uint j = 0; j < 2 * blockLen; j++)
+				_accumBuffer[j] += _blockBuffer[j];
+		}
+
+		int16 *out = buf + 2 * pos;
+		for (uint j = 0; j < 2 * blockLen; j++)
+			out[j] = (int16)CLIP<int32>(_accumBuffer[j], ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+	}
+
+	int res = 0;
+	for (int i = 0; i != NUM_CHANNELS; i++)
+		res = MAX(res, processed[i]);
+
+	return res;
+}
+
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
+	processEvents();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+		if (_channels[i] != 0 && !_channels[i]->isPermanent())
+			removeChannel(i);
 	}
+	syncMixer();
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
+	processEvents();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+		if (_channels[i] != 0 && _channels[i]->getId() == id)
+			removeChannel(i);
 	}
+	syncMixer();
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	processEvents();
 
 	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!findChannel(handle))
 		return;
 
-	delete _channels[index];
-	_channels[index] = 0;
+	removeChannel(handle._val % NUM_CHANNELS);
+	syncMixer();
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
+
+	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].mute = mute;
 
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
 		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
+			updateChannelVolumes(_channels[i]);
 	}
 }
 
@@ -349,38 +650,67 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 	Common::StackLock lock(_mutex);
+	processEvents();
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return;
 
-	_channels[index]->setVolume(volume);
+	chan->setVolume(volume);
+	updateChannelVolumes(chan);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_mutex);
+
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return 0;
 
-	return _channels[index]->getVolume();
+	return chan->getVolume();
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 	Common::StackLock lock(_mutex);
+	processEvents();
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return;
 
-	_channels[index]->setBalance(balance);
+	chan->setBalance(balance);
+	updateChannelVolumes(chan);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_mutex);
+
+	Channel *chan = findChannel(handle);
+	if (!chan)
+		return 0;
+
+	return chan->getBalance();
+}
+
+uint32 MixerImpl::enableRenderAhead(SoundHandle handle) {
+	Common::StackLock lock(_mutex);
+	processEvents();
+
+	if (!_renderAheadFrames)
 		return 0;
 
-	return _channels[index]->getBalance();
+	Channel *chan = findChannel(handle);
+	if (!chan)
+		return 0;
+
+	if (!chan->isRenderAhead()) {
+		chan->prepareRenderAhead(_renderAheadFrames);
+		sendCommand(Command(Command::kRenderAhead, 0, chan));
+	}
+
+	// The rate converter reads a bit further than it fills the ring
+	const uint32 streamRate = chan->getStreamRate();
+	return (_renderAheadFrames * 1000 + _sampleRate - 1) / _sampleRate + (ST_MAX_READ_AHEAD * 1000 + streamRate - 1) / streamRate;
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -389,28 +719,33 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	processEvents();
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return Timestamp(0, _sampleRate);
 
-	return _channels[index]->getElapsedTime();
+	// The play position is updated while mixing
+	Common::StackLock mixLock(mutex());
+	return chan->getElapsedTime();
 }
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
+	processEvents();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0) {
-			_channels[i]->pause(paused);
+			pauseChannel(_channels[i], paused);
 		}
 	}
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
+	processEvents();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
+			pauseChannel(_channels[i], paused);
 			return;
 		}
 	}
@@ -418,13 +753,14 @@ void MixerImpl::pauseID(int id, bool paused) {
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 	Common::StackLock lock(_mutex);
+	processEvents();
 
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return;
 
-	_channels[index]->pause(paused);
+	pauseChannel(chan, paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
@@ -434,6 +770,8 @@ bool MixerImpl::isSoundIDActive(int id) {
 	g_eventRec.updateSubsystems();
 #endif
 
+	processEvents();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i] && _channels[i]->getId() == id)
 			return true;
@@ -442,9 +780,11 @@ bool MixerImpl::isSoundIDActive(int id) {
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	processEvents();
+
+	Channel *chan = findChannel(handle);
+	if (chan)
+		return chan->getId();
 	return 0;
 }
 
@@ -455,12 +795,14 @@ bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	processEvents();
+
+	return findChannel(handle) != 0;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
+	processEvents();
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i] && _channels[i]->getType() == type)
 			return true;
@@ -481,7 +823,7 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
 		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
+			updateChannelVolumes(_channels[i]);
 	}
 }
 
@@ -500,8 +842,10 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
 	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
 	  _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-	  _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
-	  _stream(stream, autofreeStream) {
+	  _pauseStartTime(0), _pauseTime(0), _converter(0), _mixPaused(false), _volL(0), _volR(0),
+	  _stream(stream, autofreeStream), _renderBuffer(0), _renderSize(0), _renderLimit(0),
+	  _renderRead(0), _renderWrite(0), _renderQueued(false), _renderDone(false), _renderCancel(false),
+	  _renderPool(0), _renderUnderruns(0) {
 	assert(mixer);
 	assert(stream);
 
@@ -510,12 +854,112 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 }
 
 Channel::~Channel() {
+	if (_renderPool) {
+		// The job only checks for cancellation between chunks
+		Common::atomicStoreRelease(_renderCancel, true);
+		if (Common::atomicLoadAcquire(_renderQueued))
+			_renderPool->wait();
+	}
+
+	delete[] _renderBuffer;
 	delete _converter;
 }
 
+bool Channel::isFinished() const {
+	if (!_renderPool)
+		return _stream->endOfStream();
+
+	return Common::atomicLoadAcquire(_renderDone) && _renderRead == Common::atomicLoadAcquire(_renderWrite);
+}
+
+void Channel::prepareRenderAhead(uint frames) {
+	assert(!_renderBuffer && frames > 0);
+
+	_renderLimit = frames;
+	_renderSize = 1;
+	while (_renderSize < frames)
+		_renderSize <<= 1;
+
+	_renderBuffer = new int16[2 * _renderSize];
+}
+
+void Channel::startRenderAhead(Common::WorkerPool *pool, uint32 *underruns) {
+	assert(_renderBuffer && pool);
+
+	_renderPool = pool;
+	_renderUnderruns = underruns;
+	scheduleRender();
+}
+
+void Channel::scheduleRender() {
+	// Only the mixing side queues jobs, and only the job itself clears the
+	// flag, so there is never more than one job per channel.
+	if (Common::atomicLoadAcquire(_renderQueued) || Common::atomicLoadAcquire(_renderDone))
+		return;
+
+	Common::atomicStoreRelease(_renderQueued, true);
+	_renderPool->addJob(this);
+}
+
+void Channel::run() {
+	const uint32 mask = _renderSize - 1;
+
+	while (!Common::atomicLoadAcquire(_renderCancel)) {
+		const uint32 write = _renderWrite;
+		const uint32 space = _renderLimit - (write - Common::atomicLoadAcquire(_renderRead));
+		const uint len = MIN<uint32>(MIN<uint32>(space, RENDER_CHUNK_SIZE), _renderSize - (write & mask));
+		if (len == 0)
+			break;
+
+		// Render at full volume, the channel volume is applied while mixing
+		int16 *dst = _renderBuffer + 2 * (write & mask);
+		memset(dst, 0, 2 * len * sizeof(int16));
+
+		int res = 0;
+		if (!_stream->endOfData())
+			res = _converter->flow(*_stream, dst, len, Mixer::kMaxMixerVolume, Mixer::kMaxMixerVolume);
+
+		Common::atomicStoreRelease(_renderWrite, write + res);
+
+		if ((uint)res < len) {
+			if (_stream->endOfStream())
+				Common::atomicStoreRelease(_renderDone, true);
+			break;
+		}
+	}
+
+	Common::atomicStoreRelease(_renderQueued, false);
+}
+
+int Channel::mixRendered(int16 *data, uint len) {
+	const uint32 mask = _renderSize - 1;
+	const uint32 available = Common::atomicLoadAcquire(_renderWrite) - _renderRead;
+	const uint count = MIN<uint32>(available, len);
+
+	for (uint i = 0; i < count; ++i) {
+		const int16 *frame = _renderBuffer + 2 * ((_renderRead + i) & mask);
+		clampedAdd(data[2 * i], (frame[0] * (int)_volL) / Mixer::kMaxMixerVolume);
+		clampedAdd(data[2 * i + 1], (frame[1] * (int)_volR) / Mixer::kMaxMixerVolume);
+	}
+
+	Common::atomicStoreRelease(_renderRead, _renderRead + count);
+
+	if (count < len && !Common::atomicLoadAcquire(_renderDone))
+		Common::atomicStoreRelease(*_renderUnderruns, *_renderUnderruns + 1);
+
+	if (count > 0) {
+		_samplesConsumed = _samplesDecoded;
+		_mixerTimeStamp = g_system->getMillis(true);
+		_pauseTime = 0;
+		_samplesDecoded += count;
+	}
+
+	scheduleRender();
+	return count;
+}
+
 void Channel::setVolume(const byte volume) {
 	_volume = volume;
-	updateChannelVolumes();
 }
 
 byte Channel::getVolume() {
@@ -524,14 +968,13 @@ byte Channel::getVolume() {
 
 void Channel::setBalance(const int8 balance) {
 	_balance = balance;
-	updateChannelVolumes();
 }
 
 int8 Channel::getBalance() {
 	return _balance;
 }
 
-void Channel::updateChannelVolumes() {
+void Channel::computeVolumes(st_volume_t &volL, st_volume_t &volR) const {
 	// From the channel balance/volume and the global volume, we compute
 	// the effective volume for the left and right channel. Note the
 	// slightly odd divisor: the 255 reflects the fact that the maximal
@@ -544,36 +987,49 @@ void Channel::updateChannelVolumes() {
 		int vol = _mixer->getVolumeForSoundType(_type) * _volume;
 
 		if (_balance == 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = vol / Mixer::kMaxChannelVolume;
+			volL = vol / Mixer::kMaxChannelVolume;
+			volR = vol / Mixer::kMaxChannelVolume;
 		} else if (_balance < 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = ((127 + _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
+			volL = vol / Mixer::kMaxChannelVolume;
+			volR = ((127 + _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
 		} else {
-			_volL = ((127 - _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
-			_volR = vol / Mixer::kMaxChannelVolume;
+			volL = ((127 - _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
+			volR = vol / Mixer::kMaxChannelVolume;
 		}
 	} else {
-		_volL = _volR = 0;
+		volL = volR = 0;
 	}
 }
 
-void Channel::pause(bool paused) {
+bool Channel::pause(bool paused, uint32 &pauseTime) {
 	//assert((paused && _pauseLevel >= 0) || (!paused && _pauseLevel));
 
+	pauseTime = 0;
+
 	if (paused) {
 		_pauseLevel++;
 
-		if (_pauseLevel == 1)
+		if (_pauseLevel == 1) {
 			_pauseStartTime = g_system->getMillis(true);
+			return true;
+		}
 	} else if (_pauseLevel > 0) {
 		_pauseLevel--;
 
 		if (!_pauseLevel) {
-			_pauseTime = (g_system->getMillis(true) - _pauseStartTime);
+			pauseTime = (g_system->getMillis(true) - _pauseStartTime);
 			_pauseStartTime = 0;
+			return true;
 		}
 	}
+
+	return false;
+}
+
+void Channel::setMixPaused(bool paused, uint32 pauseTime) {
+	_mixPaused = paused;
+	if (!paused)
+		_pauseTime = pauseTime;
 }
 
 Timestamp Channel::getElapsedTime() {
@@ -607,6 +1063,9 @@ Timestamp Channel::getElapsedTime() {
 int Channel::mix(int16 *data, uint len) {
 	assert(_stream);
 
+	if (_renderPool)
+		return mixRendered(data, len);
+
 	int res = 0;
 	if (_stream->endOfData()) {
 		// TODO: call drain method
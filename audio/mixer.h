@@ -255,6 +255,27 @@ public:
 	 */
 	virtual int8 getChannelBalance(SoundHandle handle) = 0;
 
+	/**
+	 * Allow the mixer to render the given sound ahead of time on a worker
+	 * thread, to keep expensive streams (e.g. software synthesizers) from
+	 * stalling the audio callback. Whether and how far the mixer renders
+	 * ahead depends on the user's latency settings; if it does, it stays
+	 * enabled until the sound stops.
+	 *
+	 * The stream's readBuffer() may then be called from a thread other than
+	 * the audio thread, without mutex() being held, and must not call back
+	 * into the mixer. It also runs ahead of time, so it must not drive any
+	 * engine code either. MidiDriver_Emulated based drivers, whose
+	 * readBuffer() runs the engine's music timer callbacks, have to keep
+	 * those on a channel of their own and delay the events they produce by
+	 * the returned time, as the MT-32 emulator does.
+	 *
+	 * @param handle  The sound to affect.
+	 * @return How many milliseconds ahead of its playback the stream may be
+	 *         read at most, or 0 if it is not rendered ahead.
+	 */
+	virtual uint32 enableRenderAhead(SoundHandle handle) = 0;
+
 	/**
 	 * Get an approximation of for how long the channel has been playing.
 	 */
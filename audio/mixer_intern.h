@@ -25,6 +25,8 @@
 
 #include "common/scummsys.h"
 #include "common/mutex.h"
+#include "common/spsc-queue.h"
+#include "common/worker-pool.h"
 #include "audio/mixer.h"
 
 namespace Audio {
@@ -54,17 +56,82 @@ namespace Audio {
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
  *
+ * By default, every call into the mixer and the whole of mixCallback() run
+ * under the same mutex. Backends with a real-time audio thread can instead
+ * construct the mixer in lock-free mode: engine-side calls then only update
+ * the engine's view of the channels and post commands to a single-producer/
+ * single-consumer queue, which mixCallback() drains before mixing. Channels
+ * are mixed into a 32-bit accumulator in fixed-size blocks and clipped once.
+ * The audio thread only waits for the engine side when a channel is stopped
+ * (the stream must no longer be in use when stopHandle() and friends
+ * return) or while someone holds mutex(), which then only guards mixing.
+ *
+ * Independently of the mode, channels for which enableRenderAhead() was
+ * called can be rendered ahead on a worker pool, see setRenderAhead(). Such
+ * a channel is converted to the output rate into a ring buffer holding up to
+ * the configured latency budget, and mixCallback() only applies the volume
+ * when summing it up. When the ring runs dry before the stream ended, an
+ * underrun is counted and the missing part stays silent.
+ *
  * @see OSystem::getMixer()
  */
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32
+		NUM_CHANNELS = 32,
+		COMMAND_QUEUE_SIZE = 256,
+		EVENT_QUEUE_SIZE = 1024,
+		MIX_BLOCK_SIZE = 256
+	};
+
+	/**
+	 * A change to the set of mixed channels or to their mixing parameters.
+	 * Commands are applied by the mixing side, see sendCommand().
+	 */
+	struct Command {
+		enum Type {
+			kInsert,
+			kRemove,
+			kVolume,
+			kPause,
+			kRenderAhead
+		};
+
+		Command() : type(kInsert), index(0), chan(0), volL(0), volR(0), paused(false), pauseTime(0) {}
+		Command(Type t, int i, Channel *c) : type(t), index(i), chan(c), volL(0), volR(0), paused(false), pauseTime(0) {}
+
+		Type type;
+		int index;
+		Channel *chan;
+		uint16 volL, volR;
+		bool paused;
+		uint32 pauseTime;
+	};
+
+	/**
+	 * Notification from the mixing side to the engine side (lock-free mode only).
+	 */
+	struct Event {
+		enum Type {
+			kFinished, ///< The channel's stream ended, it was removed from mixing
+			kReleased  ///< The channel was removed and can be deleted
+		};
+
+		Event() : type(kFinished), index(0), chan(0) {}
+		Event(Type t, int i, Channel *c) : type(t), index(i), chan(c) {}
+
+		Type type;
+		int index;
+		Channel *chan;
 	};
 
+	/** Protects the engine-side state; in the default mode also held while mixing. */
 	Common::Mutex _mutex;
+	/** Held while mixing in lock-free mode. */
+	Common::Mutex _mixMutex;
 
 	const uint _sampleRate;
+	bool _lockFree;
 	bool _mixerReady;
 	uint32 _handleSeed;
 
@@ -76,17 +143,40 @@ private:
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
+
+	/** The channels as seen by the engine side, guarded by _mutex. */
 	Channel *_channels[NUM_CHANNELS];
+	/** The channels as seen by mixCallback(), guarded by mutex(). */
+	Channel *_mixChannels[NUM_CHANNELS];
+
+	Common::SPSCQueue<Command, COMMAND_QUEUE_SIZE> _commands;
+	Common::SPSCQueue<Event, EVENT_QUEUE_SIZE> _events;
 
+	int16 _blockBuffer[2 * MIX_BLOCK_SIZE];
+	int32 _accumBuffer[2 * MIX_BLOCK_SIZE];
+
+	/** Render-ahead buffer size in frames, 0 when disabled. Guarded by _mutex. */
+	uint _renderAheadFrames;
+	Common::WorkerPool *_renderPool;
+	/** Callbacks in which a render-ahead channel ran out of data. */
+	uint32 _renderUnderruns;
 
 public:
 
-	MixerImpl(uint sampleRate);
+	/**
+	 * @param sampleRate Hardware output sample rate.
+	 * @param lockFree   Whether to use the lock-free command queue and block
+	 *                   mixing, see the class description.
+	 */
+	MixerImpl(uint sampleRate, bool lockFree = false);
 	~MixerImpl();
 
 	virtual bool isReady() const { Common::StackLock lock(_mutex); return _mixerReady; }
 
-	virtual Common::Mutex &mutex() { return _mutex; }
+	virtual Common::Mutex &mutex() { return _lockFree ? _mixMutex : _mutex; }
+
+	/** Whether the mixer was created in lock-free mode. */
+	bool isLockFree() const { return _lockFree; }
 
 	virtual void playStream(
 		SoundType type,
@@ -118,6 +208,8 @@ public:
 	virtual void setChannelBalance(SoundHandle handle, int8 balance);
 	virtual int8 getChannelBalance(SoundHandle handle);
 
+	virtual uint32 enableRenderAhead(SoundHandle handle);
+
 	virtual uint32 getSoundElapsedTime(SoundHandle handle);
 	virtual Timestamp getElapsedTime(SoundHandle handle);
 
@@ -128,8 +220,49 @@ public:
 
 	virtual uint getOutputRate() const;
 
+	/**
+	 * Set how far channels may be rendered ahead, see enableRenderAhead().
+	 * The budget only affects channels enabled afterwards, the worker pool
+	 * is started by the first call with a non-zero budget and kept.
+	 *
+	 * @param msecs      Latency budget in milliseconds, 0 to disable.
+	 * @param numThreads Number of worker threads to render with.
+	 */
+	void setRenderAhead(uint msecs, uint numThreads);
+
+	/**
+	 * Get the number of times a render-ahead channel could not deliver
+	 * enough samples in time.
+	 */
+	uint32 getRenderAheadUnderruns() const;
+
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
+	void removeChannel(int index);
+	void updateChannelVolumes(Channel *chan);
+	void pauseChannel(Channel *chan, bool paused);
+	Channel *findChannel(SoundHandle handle) const;
+
+	/**
+	 * Apply a command to the mixing side. In the default mode it is executed
+	 * right away, in lock-free mode it is queued for the next mixCallback().
+	 * Must be called with _mutex held.
+	 */
+	void sendCommand(const Command &cmd);
+	void executeCommand(const Command &cmd);
+	void processCommands();
+	void releaseChannel(int index, Channel *chan);
+
+	/** Handle notifications from the mixing side. Must be called with _mutex held. */
+	void processEvents();
+
+	/**
+	 * Wait for the mixing side to apply all queued commands, and delete the
+	 * channels it released. Must be called with _mutex held.
+	 */
+	void syncMixer();
+
+	int mixBlocks(int16 *buf, uint len);
 
 public:
 	/**
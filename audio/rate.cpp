@@ -26,15 +26,31 @@
  * Max Horn adapted that code to the needs of ScummVM and rewrote it partial,
  * in the process removing any use of floating point arithmetic. Various other
  * improvements over the original code were made.
+ *
+ * The polyphase converter is not based on SoX. It only uses floating point
+ * arithmetic to set up its filter bank.
  */
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
 #include "audio/mixer.h"
+#include "common/algorithm.h"
+#include "common/config-manager.h"
 #include "common/frac.h"
+#include "common/mutex.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2_POLYPHASE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define USE_NEON_POLYPHASE
+#include <arm_neon.h>
+#endif
+
 namespace Audio {
 
 
@@ -277,6 +293,299 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 #pragma mark -
 
 
+/**
+ * Windowed-sinc filter bank shared by all PolyphaseRateConverter instances
+ * converting between the same pair of rates.
+ */
+struct PolyphaseFilterBank {
+	/** Interpolation (L) and decimation (M) factors, i.e. outrate/inrate = L/M */
+	uint upFactor, downFactor;
+	/** Number of filter phases. Equal to upFactor unless that is too large. */
+	uint phases;
+	/** Number of taps per phase, a multiple of 8. */
+	uint taps;
+	/** phases * taps coefficients, in 1.15 fixed point. */
+	int16 *coeffs;
+
+	PolyphaseFilterBank(uint up, uint down);
+	~PolyphaseFilterBank() { delete[] coeffs; }
+};
+
+enum {
+	/** Maximum number of phases, above this phases are shared by nearby positions. */
+	kPolyphaseMaxPhases = 1024,
+	/** Number of taps when upsampling; downsampling widens the filter. */
+	kPolyphaseBaseTaps = 16,
+	kPolyphaseMaxTaps = 64,
+	/** Number of filter banks kept around for reuse. */
+	kPolyphaseCacheSize = 16
+};
+
+STATIC_ASSERT(INTERMEDIATE_BUFFER_SIZE + kPolyphaseMaxTaps <= ST_MAX_READ_AHEAD, rate_converters_must_not_read_further_ahead);
+
+/** Modified Bessel function of the first kind, order 0, used by the Kaiser window. */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 50 && term > sum * 1e-12; ++k) {
+		const double t = x / (2.0 * k);
+		term *= t * t;
+		sum += term;
+	}
+	return sum;
+}
+
+PolyphaseFilterBank::PolyphaseFilterBank(uint up, uint down) : upFactor(up), downFactor(down) {
+	// Pass 90% of the lower of the two Nyquist frequencies. Keep the kernel
+	// length constant in units of the filter's cutoff, so the transition
+	// band scales along when downsampling.
+	const double ratio = MIN<double>(1.0, (double)up / down);
+	const double cutoff = 0.9 * ratio;
+	const double beta = 7.0;
+
+	phases = MIN<uint>(up, kPolyphaseMaxPhases);
+	taps = (uint)ceil(kPolyphaseBaseTaps / ratio);
+	taps = MIN<uint>((taps + 7) & ~7, kPolyphaseMaxTaps);
+	coeffs = new int16[phases * taps];
+
+	const double halfLength = taps / 2;
+	const double windowNorm = besselI0(beta);
+	double *h = new double[taps];
+
+	for (uint p = 0; p < phases; ++p) {
+		// Distance of tap k from the output position, in input samples
+		const double frac = (double)p / phases;
+		double sum = 0.0;
+		for (uint k = 0; k < taps; ++k) {
+			const double x = (double)k - (halfLength - 1) - frac;
+			const double w = x / halfLength;
+			const double window = (w <= -1.0 || w >= 1.0) ? 0.0 : besselI0(beta * sqrt(1.0 - w * w)) / windowNorm;
+			const double arg = M_PI * cutoff * x;
+			const double sinc = (x == 0.0) ? 1.0 : sin(arg) / arg;
+			h[k] = cutoff * sinc * window;
+			sum += h[k];
+		}
+
+		// Normalize every phase to unity gain, so that there is no ripple on
+		// constant signals.
+		int16 *c = coeffs + p * taps;
+		for (uint k = 0; k < taps; ++k)
+			c[k] = (int16)floor(h[k] / sum * 32768.0 + 0.5);
+	}
+
+	delete[] h;
+}
+
+/**
+ * Return a filter bank for the given factors, using a cached one if possible.
+ * The caller owns the returned bank if isCached is false.
+ */
+static PolyphaseFilterBank *getPolyphaseFilterBank(uint up, uint down, bool &isCached) {
+	// The cache lives for the whole run, so is the mutex guarding it. Rate
+	// converters may be created by the engine and by timer threads.
+	static Common::Mutex *cacheMutex = new Common::Mutex();
+	static PolyphaseFilterBank *cache[kPolyphaseCacheSize];
+
+	Common::StackLock lock(*cacheMutex);
+
+	for (int i = 0; i < kPolyphaseCacheSize; ++i) {
+		if (!cache[i]) {
+			cache[i] = new PolyphaseFilterBank(up, down);
+			isCached = true;
+			return cache[i];
+		}
+
+		if (cache[i]->upFactor == up && cache[i]->downFactor == down) {
+			isCached = true;
+			return cache[i];
+		}
+	}
+
+	isCached = false;
+	return new PolyphaseFilterBank(up, down);
+}
+
+/**
+ * Dot product of taps coefficients and samples, with taps a multiple of 8.
+ */
+static inline int32 polyphaseDotProduct(const int16 *coeffs, const int16 *samples, uint taps) {
+#if defined(USE_SSE2_POLYPHASE)
+	__m128i acc = _mm_setzero_si128();
+	for (uint i = 0; i < taps; i += 8) {
+		const __m128i c = _mm_loadu_si128((const __m128i *)(coeffs + i));
+		const __m128i s = _mm_loadu_si128((const __m128i *)(samples + i));
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(c, s));
+	}
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(acc);
+#elif defined(USE_NEON_POLYPHASE)
+	int32x4_t acc = vdupq_n_s32(0);
+	for (uint i = 0; i < taps; i += 8) {
+		const int16x8_t c = vld1q_s16(coeffs + i);
+		const int16x8_t s = vld1q_s16(samples + i);
+		acc = vmlal_s16(acc, vget_low_s16(c), vget_low_s16(s));
+		acc = vmlal_s16(acc, vget_high_s16(c), vget_high_s16(s));
+	}
+	int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+	sum = vpadd_s32(sum, sum);
+	return vget_lane_s32(sum, 0);
+#else
+	int32 acc = 0;
+	for (uint i = 0; i < taps; ++i)
+		acc += coeffs[i] * samples[i];
+	return acc;
+#endif
+}
+
+/**
+ * Audio rate converter based on a windowed-sinc polyphase filter.
+ *
+ * Considerably better quality than the linear interpolation, especially when
+ * upsampling low rate sounds, for a moderate amount of extra CPU time. The
+ * filtering is done in fixed point, with SSE2 or NEON when available.
+ */
+template<bool stereo, bool reverseStereo>
+class PolyphaseRateConverter : public RateConverter {
+protected:
+	enum {
+		kBufferSize = INTERMEDIATE_BUFFER_SIZE + kPolyphaseMaxTaps
+	};
+
+	PolyphaseFilterBank *_bank;
+	bool _isBankCached;
+
+	/** Interleaved input, as read from the stream */
+	st_sample_t _inBuf[INTERMEDIATE_BUFFER_SIZE];
+	/** Planar input history for the left and right channel */
+	st_sample_t _history[stereo ? 2 : 1][kBufferSize];
+	/** Number of valid frames in _history */
+	uint _historyLen;
+	/** Index of the first frame in _history used for the next output frame */
+	uint _historyPos;
+
+	/** Position between two input frames, in 1/upFactor units */
+	uint _phaseAcc;
+	uint _stepInt, _stepFrac;
+
+	bool refill(AudioStream &input);
+
+public:
+	PolyphaseRateConverter(st_rate_t inrate, st_rate_t outrate);
+	~PolyphaseRateConverter();
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
+template<bool stereo, bool reverseStereo>
+PolyphaseRateConverter<stereo, reverseStereo>::PolyphaseRateConverter(st_rate_t inrate, st_rate_t outrate) {
+	const st_rate_t div = Common::gcd(inrate, outrate);
+	_bank = getPolyphaseFilterBank(outrate / div, inrate / div, _isBankCached);
+
+	_stepInt = _bank->downFactor / _bank->upFactor;
+	_stepFrac = _bank->downFactor % _bank->upFactor;
+	_phaseAcc = 0;
+
+	// Start with silence, so that the first output frame is centered on the
+	// first input frame.
+	_historyLen = _bank->taps / 2 - 1;
+	_historyPos = 0;
+	memset(_history, 0, sizeof(_history));
+}
+
+template<bool stereo, bool reverseStereo>
+PolyphaseRateConverter<stereo, reverseStereo>::~PolyphaseRateConverter() {
+	if (!_isBankCached)
+		delete _bank;
+}
+
+template<bool stereo, bool reverseStereo>
+bool PolyphaseRateConverter<stereo, reverseStereo>::refill(AudioStream &input) {
+	// Drop the frames which are not needed anymore
+	if (_historyPos <= _historyLen) {
+		const uint keep = _historyLen - _historyPos;
+		for (int c = 0; c < (stereo ? 2 : 1); ++c)
+			memmove(_history[c], _history[c] + _historyPos, keep * sizeof(st_sample_t));
+		_historyLen = keep;
+		_historyPos = 0;
+	} else {
+		// When downsampling, we may skip over frames not read yet
+		_historyPos -= _historyLen;
+		_historyLen = 0;
+	}
+
+	const uint frames = MIN<uint>(kBufferSize - _historyLen, INTERMEDIATE_BUFFER_SIZE / (stereo ? 2 : 1));
+	const int len = input.readBuffer(_inBuf, frames * (stereo ? 2 : 1));
+	if (len <= 0)
+		return false;
+
+	const st_sample_t *in = _inBuf;
+	for (int i = 0; i < len; i += (stereo ? 2 : 1)) {
+		_history[0][_historyLen] = *in++;
+		if (stereo)
+			_history[1][_historyLen] = *in++;
+		++_historyLen;
+	}
+
+	return true;
+}
+
+template<bool stereo, bool reverseStereo>
+int PolyphaseRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t *ostart, *oend;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	const uint taps = _bank->taps;
+	const uint up = _bank->upFactor;
+	const uint phases = _bank->phases;
+
+	while (obuf < oend) {
+		// Make sure all taps of the filter are covered by the input
+		if (_historyPos + taps > _historyLen) {
+			if (!refill(input))
+				return (obuf - ostart) / 2;
+			continue;
+		}
+
+		const uint phase = (phases == up) ? _phaseAcc : (_phaseAcc * phases) / up;
+		const int16 *coeffs = _bank->coeffs + phase * taps;
+
+		int out0, out1;
+		out0 = (polyphaseDotProduct(coeffs, _history[0] + _historyPos, taps) + (1 << 14)) >> 15;
+		out0 = CLIP<int>(out0, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		if (stereo) {
+			out1 = (polyphaseDotProduct(coeffs, _history[stereo ? 1 : 0] + _historyPos, taps) + (1 << 14)) >> 15;
+			out1 = CLIP<int>(out1, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		} else {
+			out1 = out0;
+		}
+
+		// output left channel
+		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+		obuf += 2;
+
+		// Increment input position
+		_historyPos += _stepInt;
+		_phaseAcc += _stepFrac;
+		if (_phaseAcc >= up) {
+			_phaseAcc -= up;
+			_historyPos++;
+		}
+	}
+	return (obuf - ostart) / 2;
+}
+
+
+#pragma mark -
+
+
 /**
  * Simple audio rate converter for the case that the inrate equals the outrate.
  */
@@ -341,9 +650,11 @@ public:
 #pragma mark -
 
 template<bool stereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool polyphase) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0 && (inrate < 65536)) {
+		if (polyphase) {
+			return new PolyphaseRateConverter<stereo, reverseStereo>(inrate, outrate);
+		} else if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
 			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
@@ -357,13 +668,17 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
  * Create and return a RateConverter object for the specified input and output rates.
  */
 RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+	// The polyphase resampler is opt-in for now, through the "audio_resampler"
+	// config key. The default is the linear resampler.
+	const bool polyphase = ConfMan.hasKey("audio_resampler") && ConfMan.get("audio_resampler") == "polyphase";
+
 	if (stereo) {
 		if (reverseStereo)
-			return makeRateConverter<true, true>(inrate, outrate);
+			return makeRateConverter<true, true>(inrate, outrate, polyphase);
 		else
-			return makeRateConverter<true, false>(inrate, outrate);
+			return makeRateConverter<true, false>(inrate, outrate, polyphase);
 	} else
-		return makeRateConverter<false, false>(inrate, outrate);
+		return makeRateConverter<false, false>(inrate, outrate, polyphase);
 }
 
 } // End of namespace Audio
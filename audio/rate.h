@@ -52,6 +52,14 @@ enum {
 	ST_SUCCESS = 0
 };
 
+/**
+ * How many frames a RateConverter reads from its input at most ahead of the
+ * output it produced: one intermediate buffer plus the filter taps.
+ */
+enum {
+	ST_MAX_READ_AHEAD = 512 + 64
+};
+
 static inline void clampedAdd(int16& a, int b) {
 	int val;
 #ifdef OUTPUT_UNSIGNED_AUDIO
@@ -29,6 +29,7 @@
 #include "audio/musicplugin.h"
 #include "audio/mpu401.h"
 
+#include "common/array.h"
 #include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/error.h"
@@ -111,6 +112,31 @@ class MidiChannel_MT32 : public MidiChannel_MPU401 {
 
 class MidiDriver_MT32 : public MidiDriver_Emulated {
 private:
+	/**
+	 * Renders the synth on a mixer channel of its own, which the mixer may
+	 * render ahead on a worker thread. The driver's channel then only keeps
+	 * running the timer callbacks in time, and MIDI events are queued in the
+	 * synth with a timestamp instead of being played right away. The synth
+	 * allows queueing events while another thread renders.
+	 */
+	class RenderStream : public Audio::AudioStream {
+	public:
+		RenderStream(MT32Emu::Service &service, int rate) : _service(service), _rate(rate) {}
+
+		int readBuffer(int16 *data, const int numSamples) override {
+			_service.renderBit16s(data, numSamples / 2);
+			return numSamples;
+		}
+
+		bool isStereo() const override { return true; }
+		int getRate() const override { return _rate; }
+		bool endOfData() const override { return false; }
+
+	private:
+		MT32Emu::Service &_service;
+		int _rate;
+	};
+
 	MidiChannel_MT32 _midiChannels[16];
 	uint16 _channelMask;
 	MT32Emu::Service _service;
@@ -120,6 +146,16 @@ private:
 
 	int _outputRate;
 
+	RenderStream *_renderStream;
+	Audio::SoundHandle _renderHandle;
+	/** Frames played on the driver's channel, while rendering ahead */
+	uint32 _playbackPosition;
+	/** Frames by which MIDI events are delayed, while rendering ahead */
+	uint32 _renderLatency;
+
+	uint32 getEventTimestamp();
+	void writeSysex(byte channel, const byte *data, uint16 length);
+
 protected:
 	void generateSamples(int16 *buf, int len) override;
 
@@ -157,6 +193,9 @@ MidiDriver_MT32::MidiDriver_MT32(Audio::Mixer *mixer) : MidiDriver_Emulated(mixe
 	_outputRate = 0;
 	_controlData = nullptr;
 	_pcmData = nullptr;
+	_renderStream = nullptr;
+	_playbackPosition = 0;
+	_renderLatency = 0;
 }
 
 MidiDriver_MT32::~MidiDriver_MT32() {
@@ -216,16 +255,66 @@ int MidiDriver_MT32::open() {
 
 	MidiDriver_Emulated::open();
 
+	// Start the synth's own channel first, so that it is never rendered
+	// by both channels
+	RenderStream *renderStream = new RenderStream(_service, _outputRate);
+	_mixer->playStream(Audio::Mixer::kPlainSoundType, &_renderHandle, renderStream, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
+	const uint32 renderAhead = _mixer->enableRenderAhead(_renderHandle);
+	if (renderAhead) {
+		Common::StackLock lock(_mutex);
+		_renderStream = renderStream;
+		_playbackPosition = 0;
+		_renderLatency = (uint32)(((uint64)renderAhead * _outputRate + 999) / 1000);
+	} else {
+		_mixer->stopHandle(_renderHandle);
+		delete renderStream;
+	}
+
 	_mixer->playStream(Audio::Mixer::kPlainSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 
 	return 0;
 }
 
+uint32 MidiDriver_MT32::getEventTimestamp() {
+	// The synth is rendered at most _renderLatency frames ahead of the
+	// driver's channel, so this keeps the timing of the events intact
+	return _service.convertOutputToSynthTimestamp(_playbackPosition + _renderLatency);
+}
+
+void MidiDriver_MT32::writeSysex(byte channel, const byte *data, uint16 length) {
+	if (!_renderStream) {
+		_service.writeSysex(channel, data, length);
+		return;
+	}
+
+	// Writing to the synth's memory directly would race with rendering, so
+	// queue the equivalent DT1 message instead
+	Common::Array<byte> sysex;
+	sysex.reserve(length + 7);
+	sysex.push_back(0xF0);
+	sysex.push_back(0x41);
+	sysex.push_back(channel);
+	sysex.push_back(0x16);
+	sysex.push_back(0x12);
+	byte checksum = 0;
+	for (uint16 i = 0; i < length; ++i) {
+		sysex.push_back(data[i]);
+		checksum -= data[i];
+	}
+	sysex.push_back(checksum & 0x7F);
+	sysex.push_back(0xF7);
+
+	_service.playSysexAt(sysex.begin(), sysex.size(), getEventTimestamp());
+}
+
 void MidiDriver_MT32::send(uint32 b) {
 	midiDriverCommonSend(b);
 
 	Common::StackLock lock(_mutex);
-	_service.playMsg(b);
+	if (_renderStream)
+		_service.playMsgAt(b, getEventTimestamp());
+	else
+		_service.playMsg(b);
 }
 
 // Indiana Jones and the Fate of Atlantis (including the demo) uses
@@ -236,14 +325,17 @@ void MidiDriver_MT32::setPitchBendRange(byte channel, uint range) {
 	}
 	byte benderRangeSysex[4] = { 0, 0, 4, (uint8)range };
 	Common::StackLock lock(_mutex);
-	_service.writeSysex(channel, benderRangeSysex, 4);
+	writeSysex(channel, benderRangeSysex, 4);
 }
 
 void MidiDriver_MT32::sysEx(const byte *msg, uint16 length) {
 	midiDriverCommonSysEx(msg, length);
 	if (msg[0] == 0xf0) {
 		Common::StackLock lock(_mutex);
-		_service.playSysex(msg, length);
+		if (_renderStream)
+			_service.playSysexAt(msg, length, getEventTimestamp());
+		else
+			_service.playSysex(msg, length);
 	} else {
 		enum {
 			SYSEX_CMD_DT1 = 0x12,
@@ -252,7 +344,7 @@ void MidiDriver_MT32::sysEx(const byte *msg, uint16 length) {
 
 		if (msg[3] == SYSEX_CMD_DT1 || msg[3] == SYSEX_CMD_DAT) {
 			Common::StackLock lock(_mutex);
-			_service.writeSysex(msg[1], msg + 4, length - 5);
+			writeSysex(msg[1], msg + 4, length - 5);
 		} else {
 			warning("Unused sysEx command %d", msg[3]);
 		}
@@ -268,6 +360,11 @@ void MidiDriver_MT32::close() {
 	setTimerCallback(NULL, NULL);
 	// Detach the mixer callback handler
 	_mixer->stopHandle(_mixerSoundHandle);
+	if (_renderStream) {
+		_mixer->stopHandle(_renderHandle);
+		delete _renderStream;
+		_renderStream = nullptr;
+	}
 
 	Common::StackLock lock(_mutex);
 	_service.closeSynth();
@@ -280,6 +377,13 @@ void MidiDriver_MT32::close() {
 
 void MidiDriver_MT32::generateSamples(int16 *data, int len) {
 	Common::StackLock lock(_mutex);
+	if (_renderStream) {
+		// The synth plays on its own channel, only keep track of the time
+		memset(data, 0, len * 2 * sizeof(int16));
+		_playbackPosition += len;
+		return;
+	}
+
 	_service.renderBit16s(data, len);
 }
 
@@ -173,6 +173,15 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Retrieves the size and the last modification time of the file referred
+	 * by this node, without opening it. The time is only meant to be compared
+	 * with other times of the same node.
+	 *
+	 * @return bool true if the backend provides them, false otherwise.
+	 */
+	virtual bool getFileStats(int64 &size, int64 &modificationTime) const { return false; }
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -183,6 +192,15 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Creates a SeekableReadStream instance corresponding to the file
+	 * referred by this node, mapping the file into memory if the backend
+	 * supports it. Otherwise, this is the same as createReadStream().
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::SeekableReadStream *createMappedReadStream() { return createReadStream(); }
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
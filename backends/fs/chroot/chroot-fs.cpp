@@ -66,6 +66,10 @@ bool ChRootFilesystemNode::isReadable() const {
 	return _realNode->isReadable();
 }
 
+bool ChRootFilesystemNode::getFileStats(int64 &size, int64 &modificationTime) const {
+	return _realNode->getFileStats(size, modificationTime);
+}
+
 bool ChRootFilesystemNode::isWritable() const {
 	return _realNode->isWritable();
 }
@@ -96,6 +100,10 @@ Common::SeekableReadStream *ChRootFilesystemNode::createReadStream() {
 	return _realNode->createReadStream();
 }
 
+Common::SeekableReadStream *ChRootFilesystemNode::createMappedReadStream() {
+	return _realNode->createMappedReadStream();
+}
+
 Common::WriteStream *ChRootFilesystemNode::createWriteStream() {
 	return _realNode->createWriteStream();
 }
@@ -41,6 +41,7 @@ public:
 	virtual Common::String getPath() const;
 	virtual bool isDirectory() const;
 	virtual bool isReadable() const;
+	virtual bool getFileStats(int64 &size, int64 &modificationTime) const;
 	virtual bool isWritable() const;
 
 	virtual AbstractFSNode *getChild(const Common::String &n) const;
@@ -48,6 +49,7 @@ public:
 	virtual AbstractFSNode *getParent() const;
 
 	virtual Common::SeekableReadStream *createReadStream();
+	virtual Common::SeekableReadStream *createMappedReadStream();
 	virtual Common::WriteStream *createWriteStream();
 	virtual bool createDirectory();
 
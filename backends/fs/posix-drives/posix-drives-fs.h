@@ -62,6 +62,7 @@ public:
 
 	// AbstractFSNode API
 	Common::SeekableReadStream *createReadStream() override;
+	Common::SeekableReadStream *createMappedReadStream() override { return createReadStream(); }
 	Common::WriteStream *createWriteStream() override;
 	AbstractFSNode *getChild(const Common::String &n) const override;
 	bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const override;
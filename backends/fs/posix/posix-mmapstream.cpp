@@ -0,0 +1,112 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "backends/fs/posix/posix-mmapstream.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(_POSIX_MAPPED_FILES) && _POSIX_MAPPED_FILES > 0
+#include <sys/mman.h>
+#define HAVE_POSIX_MMAP
+#endif
+
+PosixMmapStream *PosixMmapStream::makeFromPath(const Common::String &path) {
+#ifdef HAVE_POSIX_MMAP
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size <= 0 || st.st_size > 0x7FFFFFFF) {
+		close(fd);
+		return nullptr;
+	}
+
+	// The mapping keeps the file referenced, the descriptor isn't needed anymore
+	void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+		return nullptr;
+
+	Common::SharedPtr<Mapping> mapping(new Mapping(addr, st.st_size));
+	return new PosixMmapStream(mapping, (const byte *)addr, st.st_size);
+#else
+	return nullptr;
+#endif
+}
+
+PosixMmapStream::Mapping::~Mapping() {
+#ifdef HAVE_POSIX_MMAP
+	munmap(_addr, _length);
+#endif
+}
+
+PosixMmapStream::PosixMmapStream(const Common::SharedPtr<Mapping> &mapping, const byte *data, uint32 size) :
+		_mapping(mapping), _data(data), _size(size), _pos(0), _eos(false) {
+}
+
+uint32 PosixMmapStream::read(void *dataPtr, uint32 dataSize) {
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	memcpy(dataPtr, _data + _pos, dataSize);
+	_pos += dataSize;
+	return dataSize;
+}
+
+Common::SeekableReadStream *PosixMmapStream::readStream(uint32 dataSize) {
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	Common::SeekableReadStream *stream = new PosixMmapStream(_mapping, _data + _pos, dataSize);
+	_pos += dataSize;
+	return stream;
+}
+
+bool PosixMmapStream::seek(int64 offset, int whence) {
+	switch (whence) {
+	case SEEK_END:
+		offset = _size + offset;
+		break;
+	case SEEK_CUR:
+		offset = _pos + offset;
+		break;
+	case SEEK_SET:
+	default:
+		break;
+	}
+
+	if (offset < 0 || offset > _size)
+		return false;
+
+	_pos = offset;
+	_eos = false;
+	return true;
+}
@@ -0,0 +1,73 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_FS_POSIX_POSIXMMAPSTREAM_H
+#define BACKENDS_FS_POSIX_POSIXMMAPSTREAM_H
+
+#include "common/ptr.h"
+#include "common/stream.h"
+#include "common/str.h"
+
+/**
+ * A file input stream reading from a memory mapping of the file.
+ *
+ * Reads are plain memory copies, and readStream() returns streams which
+ * share the mapping instead of copying the data. The mapping stays alive
+ * until the last of these streams is deleted.
+ */
+class PosixMmapStream : public Common::SeekableReadStream {
+public:
+	/**
+	 * Map the file at the given path. Returns nullptr if the file can't be
+	 * opened, is empty, or memory mapping isn't supported.
+	 */
+	static PosixMmapStream *makeFromPath(const Common::String &path);
+
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+	Common::SeekableReadStream *readStream(uint32 dataSize) override;
+
+	bool eos() const override { return _eos; }
+	void clearErr() override { _eos = false; }
+
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+	bool seek(int64 offset, int whence = SEEK_SET) override;
+
+private:
+	struct Mapping {
+		void *_addr;
+		size_t _length;
+
+		Mapping(void *addr, size_t length) : _addr(addr), _length(length) {}
+		~Mapping();
+	};
+
+	PosixMmapStream(const Common::SharedPtr<Mapping> &mapping, const byte *data, uint32 size);
+
+	Common::SharedPtr<Mapping> _mapping;
+	const byte *_data;
+	uint32 _size;
+	uint32 _pos;
+	bool _eos;
+};
+
+#endif
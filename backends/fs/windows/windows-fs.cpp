@@ -55,6 +55,16 @@ bool WindowsFilesystemNode::isWritable() const {
 	return _taccess(charToTchar(_path.c_str()), W_OK) == 0;
 }
 
+bool WindowsFilesystemNode::getFileStats(int64 &size, int64 &modificationTime) const {
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesEx(charToTchar(_path.c_str()), GetFileExInfoStandard, &data) || (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+		return false;
+
+	size = ((int64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+	modificationTime = ((int64)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+	return true;
+}
+
 void WindowsFilesystemNode::addFile(AbstractFSList &list, ListMode mode, const char *base, bool hidden, WIN32_FIND_DATA* find_data) {
 	// Skip local directory (.) and parent (..)
 	if (!_tcscmp(find_data->cFileName, TEXT(".")) ||
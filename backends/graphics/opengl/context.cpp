@@ -43,6 +43,10 @@ void Context::reset() {
 	framebufferObjectSupported = false;
 	packedPixelsSupported = false;
 	textureEdgeClampSupported = false;
+	unpackSubimageSupported = false;
+	pixelBufferObjectSupported = false;
+
+	frameStats = FrameStats();
 
 #define GL_FUNC_DEF(ret, name, param) name = nullptr;
 #include "backends/graphics/opengl/opengl-func.h"
@@ -139,6 +143,8 @@ void OpenGLGraphicsManager::initializeGLContext() {
 	bool ARBShadingLanguage100 = false;
 	bool ARBVertexShader = false;
 	bool ARBFragmentShader = false;
+	bool ARBVertexBufferObject = false;
+	bool ARBPixelBufferObject = false;
 
 	Common::StringTokenizer tokenizer(extString, " ");
 	while (!tokenizer.empty()) {
@@ -162,6 +168,12 @@ void OpenGLGraphicsManager::initializeGLContext() {
 			g_context.packedPixelsSupported = true;
 		} else if (token == "GL_SGIS_texture_edge_clamp") {
 			g_context.textureEdgeClampSupported = true;
+		} else if (token == "GL_EXT_unpack_subimage") {
+			g_context.unpackSubimageSupported = true;
+		} else if (token == "GL_ARB_vertex_buffer_object") {
+			ARBVertexBufferObject = true;
+		} else if (token == "GL_ARB_pixel_buffer_object") {
+			ARBPixelBufferObject = true;
 		}
 	}
 
@@ -187,6 +199,24 @@ void OpenGLGraphicsManager::initializeGLContext() {
 		g_context.textureEdgeClampSupported = true;
 	}
 
+	// Desktop OpenGL always has GL_UNPACK_ROW_LENGTH, GLES 2.0 needs an
+	// extension for it and GLES 1 lacks it
+	if (g_context.type == kContextGL || (g_context.type == kContextGLES2 && g_context.majorVersion >= 3)) {
+		g_context.unpackSubimageSupported = true;
+	} else if (g_context.type == kContextGLES) {
+		g_context.unpackSubimageSupported = false;
+	}
+
+	// GLES 3.0 has pixel buffers but lacks glMapBuffer, so they are only
+	// used with desktop OpenGL. The buffer functions are loaded by their ARB
+	// names there, so the extensions are required even though pixel buffers
+	// are core in OpenGL 2.1.
+	if (g_context.type == kContextGL) {
+		g_context.pixelBufferObjectSupported = ARBVertexBufferObject && ARBPixelBufferObject &&
+			g_context.glGenBuffers && g_context.glDeleteBuffers && g_context.glBindBuffer &&
+			g_context.glBufferData && g_context.glMapBuffer && g_context.glUnmapBuffer;
+	}
+
 	// Log context type.
 	switch (g_context.type) {
 	case kContextGL:
@@ -213,6 +243,8 @@ void OpenGLGraphicsManager::initializeGLContext() {
 	debug(5, "OpenGL: FBO support: %d", g_context.framebufferObjectSupported);
 	debug(5, "OpenGL: Packed pixels support: %d", g_context.packedPixelsSupported);
 	debug(5, "OpenGL: Texture edge clamping support: %d", g_context.textureEdgeClampSupported);
+	debug(5, "OpenGL: Unpack subimage support: %d", g_context.unpackSubimageSupported);
+	debug(5, "OpenGL: Pixel buffer object support: %d", g_context.pixelBufferObjectSupported);
 }
 
 } // End of namespace OpenGL
@@ -63,6 +63,12 @@ void Framebuffer::setClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {
 }
 
 void Framebuffer::enableBlend(BlendMode mode) {
+	// The same modes are set for every frame, skip the GL calls when they
+	// would not change anything
+	if (isActive() && _blendState == mode) {
+		return;
+	}
+
 	_blendState = mode;
 
 	// Directly apply changes when we are active.
@@ -72,6 +78,10 @@ void Framebuffer::enableBlend(BlendMode mode) {
 }
 
 void Framebuffer::enableScissorTest(bool enable) {
+	if (isActive() && _scissorTestState == enable) {
+		return;
+	}
+
 	_scissorTestState = enable;
 
 	// Directly apply changes when we are active.
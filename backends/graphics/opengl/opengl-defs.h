@@ -76,6 +76,7 @@ typedef float  GLclampf; /* single precision float in [0,1] */
 typedef double GLdouble; /* double precision float */
 typedef double GLclampd; /* double precision float in [0,1] */
 typedef char   GLchar;
+typedef uintptr GLsizeiptr; /* pointer sized, only used for positive sizes */
 #if defined(MACOSX)
 typedef void  *GLhandleARB;
 #else
@@ -187,6 +188,7 @@ typedef GLhandleARB GLshader;
 #define GL_R8                             0x8229
 
 /* PixelStoreParameter */
+#define GL_UNPACK_ROW_LENGTH              0x0CF2
 #define GL_UNPACK_ALIGNMENT               0x0CF5
 #define GL_PACK_ALIGNMENT                 0x0D05
 
@@ -260,4 +262,9 @@ typedef GLhandleARB GLshader;
 #define GL_COLOR_ATTACHMENT0              0x8CE0
 #define GL_FRAMEBUFFER                    0x8D40
 
+/* Buffer objects */
+#define GL_PIXEL_UNPACK_BUFFER            0x88EC
+#define GL_STREAM_DRAW                    0x88E0
+#define GL_WRITE_ONLY                     0x88B9
+
 #endif
@@ -29,6 +29,7 @@
 #include "backends/graphics/opengl/shader.h"
 
 #include "common/array.h"
+#include "common/debug.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #include "common/algorithm.h"
@@ -470,6 +471,8 @@ void OpenGLGraphicsManager::updateScreen() {
 		return;
 	}
 
+	g_context.frameStats = Context::FrameStats();
+
 #ifdef USE_OSD
 	if (_osdMessageChangeRequest) {
 		osdMessageUpdateSurface();
@@ -594,6 +597,9 @@ void OpenGLGraphicsManager::updateScreen() {
 	_cursorNeedsRedraw = false;
 	_forceRedraw = false;
 	refreshScreen();
+
+	_frameStats = g_context.frameStats;
+	debug(9, "OpenGL: %u draw calls, %u texture uploads of %u bytes", _frameStats.drawCalls, _frameStats.uploads, _frameStats.uploadedBytes);
 }
 
 Graphics::Surface *OpenGLGraphicsManager::lockScreen() {
@@ -119,6 +119,12 @@ public:
 	virtual void setPalette(const byte *colors, uint start, uint num) override;
 	virtual void grabPalette(byte *colors, uint start, uint num) const override;
 
+	/**
+	 * Query the number of draw calls and texture uploads of the last frame
+	 * drawn.
+	 */
+	const Context::FrameStats &getFrameStats() const { return _frameStats; }
+
 protected:
 	/**
 	 * Whether an GLES or GLES2 context is active.
@@ -414,6 +420,11 @@ protected:
 	 */
 	byte _cursorPalette[3 * 256];
 
+	/**
+	 * The rendering statistics of the last frame drawn.
+	 */
+	Context::FrameStats _frameStats;
+
 #ifdef USE_OSD
 	//
 	// OSD
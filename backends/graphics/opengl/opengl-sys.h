@@ -132,6 +132,24 @@ struct Context {
 	/** Whether texture coordinate edge clamping is available or not. */
 	bool textureEdgeClampSupported;
 
+	/** Whether GL_UNPACK_ROW_LENGTH is available or not. */
+	bool unpackSubimageSupported;
+
+	/** Whether texture uploads can go through pixel buffer objects or not. */
+	bool pixelBufferObjectSupported;
+
+	/** Statistics about the rendering work of a frame. */
+	struct FrameStats {
+		FrameStats() : drawCalls(0), uploads(0), uploadedBytes(0) {}
+
+		uint32 drawCalls;     ///< Number of textured rectangles drawn.
+		uint32 uploads;       ///< Number of texture updates.
+		uint32 uploadedBytes; ///< Amount of pixel data sent to textures.
+	};
+
+	/** Work done since the statistics were last reset. */
+	FrameStats frameStats;
+
 #define GL_FUNC_DEF(ret, name, param) ret (GL_CALL_CONV *name)param
 #include "backends/graphics/opengl/opengl-func.h"
 #undef GL_FUNC_DEF
@@ -34,7 +34,8 @@ public:
 
 	void setPaletteTexture(const GLTexture *paletteTexture) { _paletteTexture = paletteTexture; }
 
-	virtual void drawTexture(const GLTexture &texture, const GLfloat *coordinates);
+protected:
+	virtual void drawTextureInternal(const GLTexture &texture, const GLfloat *coordinates);
 
 private:
 	const GLTexture *_paletteTexture;
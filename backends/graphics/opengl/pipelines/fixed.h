@@ -32,12 +32,11 @@ class FixedPipeline : public Pipeline {
 public:
 	virtual void setColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
 
-	virtual void drawTexture(const GLTexture &texture, const GLfloat *coordinates);
-
 	virtual void setProjectionMatrix(const GLfloat *projectionMatrix);
 
 protected:
 	virtual void activateInternal();
+	virtual void drawTextureInternal(const GLTexture &texture, const GLfloat *coordinates);
 };
 #endif // !USE_FORCED_GLES2
 
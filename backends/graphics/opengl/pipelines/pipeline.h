@@ -80,7 +80,10 @@ public:
 	 * @param texture     Texture to use for drawing.
 	 * @param coordinates x1, y1, x2, y2 coordinates where to draw the texture.
 	 */
-	virtual void drawTexture(const GLTexture &texture, const GLfloat *coordinates) = 0;
+	void drawTexture(const GLTexture &texture, const GLfloat *coordinates) {
+		++g_context.frameStats.drawCalls;
+		drawTextureInternal(texture, coordinates);
+	}
 
 	void drawTexture(const GLTexture &texture, GLfloat x, GLfloat y, GLfloat w, GLfloat h) {
 		const GLfloat coordinates[4*2] = {
@@ -113,6 +116,11 @@ protected:
 	 */
 	virtual void deactivateInternal() {}
 
+	/**
+	 * Draw a texture rectangle to the currently active framebuffer.
+	 */
+	virtual void drawTextureInternal(const GLTexture &texture, const GLfloat *coordinates) = 0;
+
 	bool isActive() const { return _isActive; }
 
 	Framebuffer *_activeFramebuffer;
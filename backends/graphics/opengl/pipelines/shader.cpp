@@ -78,7 +78,7 @@ void ShaderPipeline::setColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {
 	}
 }
 
-void ShaderPipeline::drawTexture(const GLTexture &texture, const GLfloat *coordinates) {
+void ShaderPipeline::drawTextureInternal(const GLTexture &texture, const GLfloat *coordinates) {
 	texture.bind();
 
 	GL_CALL(glVertexAttribPointer(_texCoordAttribLocation, 2, GL_FLOAT, GL_FALSE, 0, texture.getTexCoords()));
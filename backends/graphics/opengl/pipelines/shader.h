@@ -36,13 +36,12 @@ public:
 
 	virtual void setColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
 
-	virtual void drawTexture(const GLTexture &texture, const GLfloat *coordinates);
-
 	virtual void setProjectionMatrix(const GLfloat *projectionMatrix);
 
 protected:
 	virtual void activateInternal();
 	virtual void deactivateInternal();
+	virtual void drawTextureInternal(const GLTexture &texture, const GLfloat *coordinates);
 
 	GLint _vertexAttribLocation;
 	GLint _texCoordAttribLocation;
@@ -39,12 +39,17 @@ GLTexture::GLTexture(GLenum glIntFormat, GLenum glFormat, GLenum glType)
 	: _glIntFormat(glIntFormat), _glFormat(glFormat), _glType(glType),
 	  _width(0), _height(0), _logicalWidth(0), _logicalHeight(0),
 	  _texCoords(), _glFilter(GL_NEAREST),
-	  _glTexture(0) {
+	  _glTexture(0), _glPixelBuffer(0) {
 	create();
 }
 
 GLTexture::~GLTexture() {
 	GL_CALL_SAFE(glDeleteTextures, (1, &_glTexture));
+#if !USE_FORCED_GLES
+	if (_glPixelBuffer) {
+		GL_CALL_SAFE(glDeleteBuffers, (1, &_glPixelBuffer));
+	}
+#endif
 }
 
 void GLTexture::enableLinearFiltering(bool enable) {
@@ -63,6 +68,13 @@ void GLTexture::enableLinearFiltering(bool enable) {
 void GLTexture::destroy() {
 	GL_CALL(glDeleteTextures(1, &_glTexture));
 	_glTexture = 0;
+
+#if !USE_FORCED_GLES
+	if (_glPixelBuffer) {
+		GL_CALL(glDeleteBuffers(1, &_glPixelBuffer));
+		_glPixelBuffer = 0;
+	}
+#endif
 }
 
 void GLTexture::create() {
@@ -145,25 +157,83 @@ void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &sr
 	bind();
 
 	// Update the actual texture.
-	// Although we have the area of the texture buffer we want to update we
-	// cannot take advantage of the left/right boundries here because it is
-	// not possible to specify a pitch to glTexSubImage2D. To be precise, with
-	// plain OpenGL we could set GL_UNPACK_ROW_LENGTH to achieve this. However,
-	// OpenGL ES 1.0 does not support GL_UNPACK_ROW_LENGTH. Thus, we are left
-	// with the following options:
-	//
-	// 1) (As we do right now) Simply always update the whole texture lines of
-	//    rect changed. This is simplest to implement. In case performance is
-	//    really an issue we can think of switching to another method.
-	//
-	// 2) Copy the dirty rect to a temporary buffer and upload that by using
-	//    glTexSubImage2D. This is what the Android backend does. It is more
-	//    complicated though.
-	//
-	// 3) Use glTexSubImage2D per line changed. This is what the old OpenGL
-	//    graphics manager did but it is much slower! Thus, we do not use it.
-	GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
-	                       _glFormat, _glType, src.getBasePtr(0, area.top)));
+	// Without GL_UNPACK_ROW_LENGTH it is not possible to specify a pitch to
+	// glTexSubImage2D, which OpenGL ES 1.0 and 2.0 lack. In that case we
+	// simply update the whole texture lines of the rect changed. Copying the
+	// dirty rect to a temporary buffer would be more complicated, and
+	// using glTexSubImage2D per line changed, as the old OpenGL graphics
+	// manager did, is much slower.
+	Common::Rect uploadArea = area;
+	if (!g_context.unpackSubimageSupported) {
+		uploadArea.left = 0;
+		uploadArea.right = src.w;
+	}
+
+	++g_context.frameStats.uploads;
+	g_context.frameStats.uploadedBytes += uploadArea.width() * uploadArea.height() * src.format.bytesPerPixel;
+
+#if !USE_FORCED_GLES
+	if (g_context.pixelBufferObjectSupported && updateAreaBuffered(uploadArea, src)) {
+		return;
+	}
+
+	if (g_context.unpackSubimageSupported) {
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, src.pitch / src.format.bytesPerPixel));
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, uploadArea.left, uploadArea.top, uploadArea.width(), uploadArea.height(),
+		                        _glFormat, _glType, src.getBasePtr(uploadArea.left, uploadArea.top)));
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+		return;
+	}
+#endif
+
+	GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, uploadArea.top, src.w, uploadArea.height(),
+	                       _glFormat, _glType, src.getBasePtr(0, uploadArea.top)));
+}
+
+bool GLTexture::updateAreaBuffered(const Common::Rect &area, const Graphics::Surface &src) {
+#if !USE_FORCED_GLES
+	const uint lineSize = area.width() * src.format.bytesPerPixel;
+
+	if (!_glPixelBuffer) {
+		GL_CALL(glGenBuffers(1, &_glPixelBuffer));
+	}
+	GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _glPixelBuffer));
+
+	// Replace the storage of the buffer instead of writing to it. The
+	// driver may still be uploading the previous contents, and would
+	// otherwise make us wait until it is done.
+	GL_CALL(glBufferData(GL_PIXEL_UNPACK_BUFFER, lineSize * area.height(), nullptr, GL_STREAM_DRAW));
+
+	void *buffer;
+	GL_ASSIGN(buffer, glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+	if (!buffer) {
+		GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+		return false;
+	}
+
+	// Only the dirty area is copied, so the lines are packed in the buffer
+	byte *dst = (byte *)buffer;
+	const byte *srcLine = (const byte *)src.getBasePtr(area.left, area.top);
+	for (int y = area.top; y < area.bottom; ++y) {
+		memcpy(dst, srcLine, lineSize);
+		dst += lineSize;
+		srcLine += src.pitch;
+	}
+
+	GLboolean unmapped;
+	GL_ASSIGN(unmapped, glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+
+	// The pointer is an offset into the bound pixel buffer
+	if (unmapped) {
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, area.left, area.top, area.width(), area.height(),
+		                        _glFormat, _glType, nullptr));
+	}
+
+	GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+	return unmapped;
+#else
+	return false;
+#endif
 }
 
 //
@@ -92,6 +92,9 @@ public:
 	/**
 	 * Copy image data to the texture.
 	 *
+	 * When the context supports pixel buffer objects, the data is staged
+	 * in one so that the driver can upload it asynchronously.
+	 *
 	 * @param area     The area to update.
 	 * @param src      Surface for the whole texture containing the pixel data
 	 *                 to upload. Only the area described by area will be
@@ -143,6 +146,14 @@ private:
 	GLint _glFilter;
 
 	GLuint _glTexture;
+	GLuint _glPixelBuffer;
+
+	/**
+	 * Upload the area through the pixel buffer.
+	 *
+	 * @return false if the buffer could not be mapped.
+	 */
+	bool updateAreaBuffered(const Common::Rect &area, const Graphics::Surface &src);
 };
 
 /**
@@ -613,6 +613,7 @@ void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 
 		_scalerPlugin = &_scalerPlugins[_videoMode.scalerIndex]->get<ScalerPluginObject>();
 		_scalerPlugin->initialize(format);
+		_scalerPlugin->setWorkerPool(ScalerMan.getWorkerPool());
 	}
 
 	_scalerPlugin->setFactor(_videoMode.scaleFactor);
@@ -29,6 +29,7 @@
 #include "common/system.h"
 #include "common/config-manager.h"
 #include "common/textconsole.h"
+#include "common/worker-pool.h"
 
 #if defined(GP2X)
 #define SAMPLES_PER_SEC 11025
@@ -111,8 +112,29 @@ void SdlMixerManager::init() {
 		error("SDL mixer output requires stereo output device");
 #endif
 
-	_mixer = new Audio::MixerImpl(_obtained.freq);
+	// Advanced users with small audio buffers can opt into the lock-free
+	// mixer, so that engine calls into the mixer don't stall the audio
+	// callback.
+	bool lockFree = false;
+	if (ConfMan.hasKey("audio_lockfree_mixer", Common::ConfigManager::kApplicationDomain))
+		lockFree = ConfMan.getBool("audio_lockfree_mixer", Common::ConfigManager::kApplicationDomain);
+
+	_mixer = new Audio::MixerImpl(_obtained.freq, lockFree);
 	assert(_mixer);
+
+	// Let software synthesizers render ahead on spare cores. This trades
+	// latency for robustness against stalls, so it is off by default.
+	int renderAhead = 0;
+	if (ConfMan.hasKey("audio_render_ahead", Common::ConfigManager::kApplicationDomain))
+		renderAhead = ConfMan.getInt("audio_render_ahead", Common::ConfigManager::kApplicationDomain);
+	if (renderAhead > 0) {
+		const uint threads = Common::WorkerPool::getDefaultThreadCount(2);
+		if (threads > 0)
+			_mixer->setRenderAhead(renderAhead, threads);
+		else
+			debug(1, "Not rendering audio ahead, no spare CPU core");
+	}
+
 	_mixer->setReady(true);
 
 	startAudio();
@@ -335,3 +335,38 @@ void ModularMutexBackend::deleteMutex(MutexRef mutex) {
 	assert(_mutexManager);
 	_mutexManager->deleteMutex(mutex);
 }
+
+OSystem::ThreadRef ModularMutexBackend::createThread(ThreadProc proc, void *param) {
+	assert(_mutexManager);
+	return _mutexManager->createThread(proc, param);
+}
+
+void ModularMutexBackend::joinThread(ThreadRef thread) {
+	assert(_mutexManager);
+	_mutexManager->joinThread(thread);
+}
+
+OSystem::SemaphoreRef ModularMutexBackend::createSemaphore(uint initialCount) {
+	assert(_mutexManager);
+	return _mutexManager->createSemaphore(initialCount);
+}
+
+void ModularMutexBackend::waitSemaphore(SemaphoreRef semaphore) {
+	assert(_mutexManager);
+	_mutexManager->waitSemaphore(semaphore);
+}
+
+void ModularMutexBackend::signalSemaphore(SemaphoreRef semaphore) {
+	assert(_mutexManager);
+	_mutexManager->signalSemaphore(semaphore);
+}
+
+void ModularMutexBackend::deleteSemaphore(SemaphoreRef semaphore) {
+	assert(_mutexManager);
+	_mutexManager->deleteSemaphore(semaphore);
+}
+
+uint ModularMutexBackend::getCPUCount() {
+	assert(_mutexManager);
+	return _mutexManager->getCPUCount();
+}
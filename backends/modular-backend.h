@@ -178,6 +178,19 @@ public:
 
 	//@}
 
+	/** @name Worker threads */
+	//@{
+
+	virtual ThreadRef createThread(ThreadProc proc, void *param) override final;
+	virtual void joinThread(ThreadRef thread) override final;
+	virtual SemaphoreRef createSemaphore(uint initialCount) override final;
+	virtual void waitSemaphore(SemaphoreRef semaphore) override final;
+	virtual void signalSemaphore(SemaphoreRef semaphore) override final;
+	virtual void deleteSemaphore(SemaphoreRef semaphore) override final;
+	virtual uint getCPUCount() override final;
+
+	//@}
+
 protected:
 	/** @name Managers variables */
 	//@{
@@ -29,6 +29,9 @@
 /**
  * Abstract class for mutex manager. Subclasses
  * implement the real functionality.
+ *
+ * Support for threads and semaphores is optional, the default
+ * implementations report them as unsupported.
  */
 class MutexManager : Common::NonCopyable {
 public:
@@ -38,6 +41,16 @@ public:
 	virtual void lockMutex(OSystem::MutexRef mutex) = 0;
 	virtual void unlockMutex(OSystem::MutexRef mutex) = 0;
 	virtual void deleteMutex(OSystem::MutexRef mutex) = 0;
+
+	virtual OSystem::ThreadRef createThread(OSystem::ThreadProc proc, void *param) { return 0; }
+	virtual void joinThread(OSystem::ThreadRef thread) {}
+
+	virtual OSystem::SemaphoreRef createSemaphore(uint initialCount) { return 0; }
+	virtual void waitSemaphore(OSystem::SemaphoreRef semaphore) {}
+	virtual void signalSemaphore(OSystem::SemaphoreRef semaphore) {}
+	virtual void deleteSemaphore(OSystem::SemaphoreRef semaphore) {}
+
+	virtual uint getCPUCount() { return 1; }
 };
 
 #endif
@@ -21,14 +21,16 @@
  */
 
 #define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
 
 #include "common/scummsys.h"
 
-#if defined(__ANDROID__) || defined(IPHONE)
+#if defined(__ANDROID__) || defined(IPHONE) || defined(POSIX)
 
 #include "backends/mutex/pthread/pthread-mutex.h"
 
 #include <pthread.h>
+#include <unistd.h>
 
 
 OSystem::MutexRef PthreadMutexManager::createMutex() {
@@ -67,4 +69,106 @@ void PthreadMutexManager::deleteMutex(OSystem::MutexRef mutex) {
 		delete m;
 }
 
+namespace {
+
+struct PthreadThread {
+	pthread_t thread;
+	OSystem::ThreadProc proc;
+	void *param;
+};
+
+void *pthreadThreadProc(void *data) {
+	PthreadThread *thread = (PthreadThread *)data;
+	thread->proc(thread->param);
+	return NULL;
+}
+
+// Unnamed POSIX semaphores are not available everywhere (e.g. iOS), so
+// build them from a mutex and a condition variable.
+struct PthreadSemaphore {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	uint count;
+};
+
+} // End of anonymous namespace
+
+OSystem::ThreadRef PthreadMutexManager::createThread(OSystem::ThreadProc proc, void *param) {
+	PthreadThread *thread = new PthreadThread;
+	thread->proc = proc;
+	thread->param = param;
+
+	if (pthread_create(&thread->thread, NULL, pthreadThreadProc, thread) != 0) {
+		warning("pthread_create() failed");
+		delete thread;
+		return NULL;
+	}
+
+	return (OSystem::ThreadRef)thread;
+}
+
+void PthreadMutexManager::joinThread(OSystem::ThreadRef thread) {
+	PthreadThread *t = (PthreadThread *)thread;
+
+	if (pthread_join(t->thread, NULL) != 0)
+		warning("pthread_join() failed");
+	delete t;
+}
+
+OSystem::SemaphoreRef PthreadMutexManager::createSemaphore(uint initialCount) {
+	PthreadSemaphore *sem = new PthreadSemaphore;
+
+	if (pthread_mutex_init(&sem->mutex, NULL) != 0) {
+		warning("pthread_mutex_init() failed");
+		delete sem;
+		return NULL;
+	}
+
+	if (pthread_cond_init(&sem->cond, NULL) != 0) {
+		warning("pthread_cond_init() failed");
+		pthread_mutex_destroy(&sem->mutex);
+		delete sem;
+		return NULL;
+	}
+
+	sem->count = initialCount;
+	return (OSystem::SemaphoreRef)sem;
+}
+
+void PthreadMutexManager::waitSemaphore(OSystem::SemaphoreRef semaphore) {
+	PthreadSemaphore *sem = (PthreadSemaphore *)semaphore;
+
+	pthread_mutex_lock(&sem->mutex);
+	while (sem->count == 0)
+		pthread_cond_wait(&sem->cond, &sem->mutex);
+	sem->count--;
+	pthread_mutex_unlock(&sem->mutex);
+}
+
+void PthreadMutexManager::signalSemaphore(OSystem::SemaphoreRef semaphore) {
+	PthreadSemaphore *sem = (PthreadSemaphore *)semaphore;
+
+	pthread_mutex_lock(&sem->mutex);
+	sem->count++;
+	pthread_cond_signal(&sem->cond);
+	pthread_mutex_unlock(&sem->mutex);
+}
+
+void PthreadMutexManager::deleteSemaphore(OSystem::SemaphoreRef semaphore) {
+	PthreadSemaphore *sem = (PthreadSemaphore *)semaphore;
+
+	pthread_cond_destroy(&sem->cond);
+	pthread_mutex_destroy(&sem->mutex);
+	delete sem;
+}
+
+uint PthreadMutexManager::getCPUCount() {
+#ifdef _SC_NPROCESSORS_ONLN
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	if (count > 0)
+		return (uint)count;
+#endif
+	return 1;
+}
+
 #endif
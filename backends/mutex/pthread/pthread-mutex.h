@@ -34,6 +34,16 @@ public:
 	virtual void lockMutex(OSystem::MutexRef mutex) override;
 	virtual void unlockMutex(OSystem::MutexRef mutex) override;
 	virtual void deleteMutex(OSystem::MutexRef mutex) override;
+
+	virtual OSystem::ThreadRef createThread(OSystem::ThreadProc proc, void *param) override;
+	virtual void joinThread(OSystem::ThreadRef thread) override;
+
+	virtual OSystem::SemaphoreRef createSemaphore(uint initialCount) override;
+	virtual void waitSemaphore(OSystem::SemaphoreRef semaphore) override;
+	virtual void signalSemaphore(OSystem::SemaphoreRef semaphore) override;
+	virtual void deleteSemaphore(OSystem::SemaphoreRef semaphore) override;
+
+	virtual uint getCPUCount() override;
 };
 
 
@@ -27,6 +27,9 @@
 #include "backends/mutex/sdl/sdl-mutex.h"
 #include "backends/platform/sdl/sdl-sys.h"
 
+#include "common/textconsole.h"
+#include "common/util.h"
+
 
 OSystem::MutexRef SdlMutexManager::createMutex() {
 	return (OSystem::MutexRef) SDL_CreateMutex();
@@ -44,4 +47,70 @@ void SdlMutexManager::deleteMutex(OSystem::MutexRef mutex) {
 	SDL_DestroyMutex((SDL_mutex *)mutex);
 }
 
+namespace {
+
+struct SdlThread {
+	SDL_Thread *thread;
+	OSystem::ThreadProc proc;
+	void *param;
+};
+
+int SDLCALL sdlThreadProc(void *data) {
+	SdlThread *thread = (SdlThread *)data;
+	thread->proc(thread->param);
+	return 0;
+}
+
+} // End of anonymous namespace
+
+OSystem::ThreadRef SdlMutexManager::createThread(OSystem::ThreadProc proc, void *param) {
+	SdlThread *thread = new SdlThread();
+	thread->proc = proc;
+	thread->param = param;
+
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	thread->thread = SDL_CreateThread(sdlThreadProc, "ScummVM worker", thread);
+#else
+	thread->thread = SDL_CreateThread(sdlThreadProc, thread);
+#endif
+
+	if (!thread->thread) {
+		warning("SDL_CreateThread() failed: %s", SDL_GetError());
+		delete thread;
+		return 0;
+	}
+
+	return (OSystem::ThreadRef)thread;
+}
+
+void SdlMutexManager::joinThread(OSystem::ThreadRef thread) {
+	SdlThread *t = (SdlThread *)thread;
+	SDL_WaitThread(t->thread, NULL);
+	delete t;
+}
+
+OSystem::SemaphoreRef SdlMutexManager::createSemaphore(uint initialCount) {
+	return (OSystem::SemaphoreRef)SDL_CreateSemaphore(initialCount);
+}
+
+void SdlMutexManager::waitSemaphore(OSystem::SemaphoreRef semaphore) {
+	SDL_SemWait((SDL_sem *)semaphore);
+}
+
+void SdlMutexManager::signalSemaphore(OSystem::SemaphoreRef semaphore) {
+	SDL_SemPost((SDL_sem *)semaphore);
+}
+
+void SdlMutexManager::deleteSemaphore(OSystem::SemaphoreRef semaphore) {
+	SDL_DestroySemaphore((SDL_sem *)semaphore);
+}
+
+uint SdlMutexManager::getCPUCount() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	return MAX(SDL_GetCPUCount(), 1);
+#else
+	return 1;
+#endif
+}
+
 #endif
@@ -34,6 +34,16 @@ public:
 	virtual void lockMutex(OSystem::MutexRef mutex);
 	virtual void unlockMutex(OSystem::MutexRef mutex);
 	virtual void deleteMutex(OSystem::MutexRef mutex);
+
+	virtual OSystem::ThreadRef createThread(OSystem::ThreadProc proc, void *param);
+	virtual void joinThread(OSystem::ThreadRef thread);
+
+	virtual OSystem::SemaphoreRef createSemaphore(uint initialCount);
+	virtual void waitSemaphore(OSystem::SemaphoreRef semaphore);
+	virtual void signalSemaphore(OSystem::SemaphoreRef semaphore);
+	virtual void deleteSemaphore(OSystem::SemaphoreRef semaphore);
+
+	virtual uint getCPUCount();
 };
 
 
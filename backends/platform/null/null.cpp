@@ -49,15 +49,19 @@ typedef void (*sighandler_t)(int);
 
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
+#include "backends/graphics/null/null-graphics.h"
+#include "backends/mutex/null/null-mutex.h"
 #include "base/main.h"
 
+#if defined(POSIX) && defined(NULL_DRIVER_USE_FOR_TEST)
+#include "backends/mutex/pthread/pthread-mutex.h"
+#endif
+
 #ifndef NULL_DRIVER_USE_FOR_TEST
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 #include "backends/events/default/default-events.h"
 #include "backends/mixer/null/null-mixer.h"
-#include "backends/mutex/null/null-mutex.h"
-#include "backends/graphics/null/null-graphics.h"
 #include "gui/debugger.h"
 #endif
 
@@ -86,6 +90,9 @@ public:
 	virtual bool pollEvent(Common::Event &event);
 
 	virtual uint32 getMillis(bool skipRecord = false);
+#ifdef POSIX
+	virtual uint64 getMicros();
+#endif
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &td, bool skipRecord = false) const;
 
@@ -117,6 +124,20 @@ OSystem_NULL::OSystem_NULL() {
 	#else
 		#error Unknown and unsupported FS backend
 	#endif
+
+	// The unit tests don't call initBackend(), and the command line detects
+	// games before it is called, but both need mutexes. The unit tests also
+	// need real threads to exercise the worker pools.
+#if defined(POSIX) && defined(NULL_DRIVER_USE_FOR_TEST)
+	_mutexManager = new PthreadMutexManager();
+#else
+	_mutexManager = new NullMutexManager();
+#endif
+
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	// Video decoders ask for the screen format when they are created
+	_graphicsManager = new NullGraphicsManager();
+#endif
 }
 
 OSystem_NULL::~OSystem_NULL() {
@@ -145,7 +166,6 @@ void OSystem_NULL::initBackend() {
 	last_handler = signal(SIGINT, intHandler);
 #endif
 
-	_mutexManager = new NullMutexManager();
 	_timerManager = new DefaultTimerManager();
 	_eventManager = new DefaultEventManager(this);
 	_savefileManager = new DefaultSaveFileManager();
@@ -200,6 +220,16 @@ uint32 OSystem_NULL::getMillis(bool skipRecord) {
 #endif
 }
 
+#ifdef POSIX
+uint64 OSystem_NULL::getMicros() {
+	timeval curTime;
+
+	gettimeofday(&curTime, 0);
+
+	return (uint64)(curTime.tv_sec - _startTime.tv_sec) * 1000000 + (curTime.tv_usec - _startTime.tv_usec);
+}
+#endif
+
 void OSystem_NULL::delayMillis(uint msecs) {
 #ifdef POSIX
 	usleep(msecs * 1000);
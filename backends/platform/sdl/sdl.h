@@ -82,6 +82,7 @@ public:
 	virtual void setWindowCaption(const Common::U32String &caption) override;
 	virtual void addSysArchivesToSearchSet(Common::SearchSet &s, int priority = 0) override;
 	virtual uint32 getMillis(bool skipRecord = false) override;
+	virtual uint64 getMicros() override;
 	virtual void delayMillis(uint msecs) override;
 	virtual void getTimeAndDate(TimeDate &td, bool skipRecord = false) const override;
 	virtual MixerManager *getMixerManager() override;
@@ -27,12 +27,15 @@
 
 #include <limits.h>
 
+#include "engines/advancedDetector.h"
 #include "engines/metaengine.h"
 #include "base/commandLine.h"
 #include "base/plugins.h"
 #include "base/version.h"
 
+#include "common/algorithm.h"
 #include "common/config-manager.h"
+#include "common/debug-channels.h"
 #include "common/fs.h"
 #include "common/rendermode.h"
 #include "common/system.h"
@@ -91,6 +94,8 @@ static const char HELP_STRING[] =
 	"  --auto-detect            Display a list of games from current or specified directory\n"
 	"                           and start the first one. Use --path=PATH to specify a directory.\n"
 	"  --recursive              In combination with --add or --detect recurse down all subdirectories\n"
+	"  --benchmark              In combination with --detect time the detection of each engine\n"
+	"                           and of the whole scan, instead of listing the games\n"
 #if defined(WIN32) && !defined(__SYMBIAN32__)
 	"  --console                Enable the console window (default:enabled)\n"
 #endif
@@ -808,6 +813,9 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_LONG_OPTION_BOOL("recursive")
 			END_OPTION
 
+			DO_LONG_OPTION_BOOL("benchmark")
+			END_OPTION
+
 			DO_LONG_OPTION("themepath")
 				Common::FSNode path(option);
 				if (!path.exists()) {
@@ -1160,44 +1168,140 @@ static void listAudioDevices() {
 	}
 }
 
-/** Display all games in the given directory, or current directory if empty */
-static DetectedGames getGameList(const Common::FSNode &dir) {
-	Common::FSList files;
-
-	// Collect all files from directory
-	if (!dir.getChildren(files, Common::FSNode::kListAll)) {
+/**
+ * List the games in the given directory, and in all of its subdirectories if
+ * recursive. Games found in subdirectories are filtered by engine and game ID.
+ */
+static DetectedGames getGameList(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
+	if (!dir.isDirectory()) {
 		printf("Path %s does not exist or is not a directory.\n", dir.getPath().c_str());
 		return DetectedGames();
 	}
 
-	// detect Games
-	DetectionResults detectionResults = EngineMan.detectGames(files);
+	// Detect games, in parallel where possible
+	DetectionScan scan(dir, recursive);
+	Common::Array<DetectionScan::Result> results;
+	while (!scan.update(results, 1000))
+		;
+
+	DetectedGames list;
+	for (uint i = 0; i < results.size(); i++) {
+		DetectionResults detectionResults(results[i].games);
 
-	if (detectionResults.foundUnknownGames()) {
-		Common::U32String report = detectionResults.generateUnknownGameReport(false, 80);
-		g_system->logMessage(LogMessageType::kInfo, report.encode().c_str());
+		if (detectionResults.foundUnknownGames()) {
+			Common::U32String report = detectionResults.generateUnknownGameReport(false, 80);
+			g_system->logMessage(LogMessageType::kInfo, report.encode().c_str());
+		}
+
+		DetectedGames games = detectionResults.listRecognizedGames();
+		for (DetectedGames::const_iterator game = games.begin(); game != games.end(); ++game) {
+			if (i == 0 || (game->engineId == engineId && game->gameId == gameId) || gameId.empty())
+				list.push_back(*game);
+		}
 	}
 
-	return detectionResults.listRecognizedGames();
+	return list;
 }
 
-static DetectedGames recListGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
-	DetectedGames list = getGameList(dir);
+struct DetectionTime {
+	const char *engineId;
+	uint32 time;
+	uint games;
+};
+
+struct DetectionTimeGreater {
+	bool operator()(const DetectionTime &x, const DetectionTime &y) const {
+		return x.time > y.time;
+	}
+};
+
+/** Time the detection in the given directory, for --detect --benchmark */
+static void benchmarkDetection(const Common::String &path, bool recursive) {
+	Common::FSNode dir(path);
+	if (!dir.isDirectory()) {
+		printf("Path %s does not exist or is not a directory.\n", dir.getPath().c_str());
+		return;
+	}
+
+	// List the directories first, so that only the detectors are timed
+	Common::Array<Common::FSList> directories;
+	Common::Array<Common::FSNode> stack;
+	stack.push_back(dir);
+	while (!stack.empty()) {
+		Common::FSNode node = stack.back();
+		stack.pop_back();
 
-	if (recursive) {
 		Common::FSList files;
-		dir.getChildren(files, Common::FSNode::kListDirectoriesOnly);
-		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-			DetectedGames rec = recListGames(*file, engineId, gameId, recursive);
-			for (DetectedGames::const_iterator game = rec.begin(); game != rec.end(); ++game) {
-				if ((game->engineId == engineId && game->gameId == gameId)
-				    || gameId.empty())
-					list.push_back(*game);
+		if (!node.getChildren(files, Common::FSNode::kListAll))
+			continue;
+		if (!files.empty())
+			directories.push_back(files);
+
+		if (recursive) {
+			for (Common::FSList::const_iterator file = files.end(); file != files.begin();) {
+				--file;
+				if (file->isDirectory())
+					stack.push_back(*file);
 			}
 		}
 	}
 
-	return list;
+	printf("Timing the detection in %d directories\n\n", directories.size());
+
+	const PluginList &plugins = EngineMan.getPlugins(PLUGIN_TYPE_ENGINE_DETECTION);
+	for (PluginList::const_iterator iter = plugins.begin(); iter != plugins.end(); ++iter)
+		DebugMan.addAllDebugChannels((*iter)->get<MetaEngineDetection>().getDebugChannels());
+
+	// One engine at a time, so that short detections still add up to a
+	// measurable time. Each engine computes the MD5s it needs itself, unless
+	// they are in the persistent cache.
+	Common::Array<DetectionTime> times;
+	uint32 total = 0;
+	for (PluginList::const_iterator iter = plugins.begin(); iter != plugins.end(); ++iter) {
+		const MetaEngineDetection &metaEngine = (*iter)->get<MetaEngineDetection>();
+		MD5Man.clear();
+
+		DetectionTime engineTime;
+		engineTime.engineId = metaEngine.getEngineId();
+		engineTime.games = 0;
+
+		const uint32 start = g_system->getMillis();
+		for (uint i = 0; i < directories.size(); i++)
+			engineTime.games += metaEngine.detectGames(directories[i]).size();
+		engineTime.time = g_system->getMillis() - start;
+
+		total += engineTime.time;
+		times.push_back(engineTime);
+	}
+
+	Common::sort(times.begin(), times.end(), DetectionTimeGreater());
+
+	printf("Engine               Time (ms)  Games\n");
+	printf("-------------------- ---------- ----------\n");
+	for (uint i = 0; i < times.size(); i++)
+		printf("%-20s %10u %10u\n", times[i].engineId, times[i].time, times[i].games);
+	printf("%-20s %10u\n\n", "All engines", total);
+
+	// Then the whole scan, including the listing of the directories
+	const int threadCounts[] = { 0, -1 };
+	for (uint i = 0; i < ARRAYSIZE(threadCounts); i++) {
+		const uint32 start = g_system->getMillis();
+		DetectionScan scan(dir, recursive, threadCounts[i]);
+		if (threadCounts[i] < 0 && scan.getThreadCount() == 0) {
+			printf("No worker threads available\n");
+			break;
+		}
+
+		Common::Array<DetectionScan::Result> results;
+		while (!scan.update(results, 1000))
+			;
+
+		uint games = 0;
+		for (uint j = 0; j < results.size(); j++)
+			games += results[j].games.size();
+
+		printf("Scan with %d worker threads: %u ms, %u games\n", scan.getThreadCount(), g_system->getMillis() - start, games);
+	}
 }
 
 /** Display all games in the given directory, return ID of first detected game */
@@ -1205,7 +1309,7 @@ static Common::String detectGames(const Common::String &path, const Common::Stri
 	bool noPath = path.empty();
 	//Current directory
 	Common::FSNode dir(path);
-	DetectedGames candidates = recListGames(dir, engineId, gameId, recursive);
+	DetectedGames candidates = getGameList(dir, engineId, gameId, recursive);
 
 	if (candidates.empty()) {
 		printf("WARNING: ScummVM could not find any game in %s\n", dir.getPath().c_str());
@@ -1230,9 +1334,9 @@ static Common::String detectGames(const Common::String &path, const Common::Stri
 	return buildQualifiedGameName(candidates[0].engineId, candidates[0].gameId);
 }
 
-static int recAddGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
+static int addGameList(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
 	int count = 0;
-	DetectedGames list = getGameList(dir);
+	DetectedGames list = getGameList(dir, Common::String(), Common::String(), recursive);
 	for (DetectedGames::const_iterator v = list.begin(); v != list.end(); ++v) {
 		if ((v->engineId != engineId || v->gameId != gameId)
 		    && !gameId.empty()) {
@@ -1258,22 +1362,13 @@ static int recAddGames(const Common::FSNode &dir, const Common::String &engineId
 		}
 	}
 
-	if (recursive) {
-		Common::FSList files;
-		if (dir.getChildren(files, Common::FSNode::kListDirectoriesOnly)) {
-			for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-				count += recAddGames(*file, engineId, gameId, recursive);
-			}
-		}
-	}
-
 	return count;
 }
 
 static bool addGames(const Common::String &path, const Common::String &engineId, const Common::String &gameId, bool recursive) {
 	//Current directory
 	Common::FSNode dir(path);
-	int added = recAddGames(dir, engineId, gameId, recursive);
+	int added = addGameList(dir, engineId, gameId, recursive);
 	printf("Added %d games\n", added);
 	if (added == 0 && !recursive) {
 		printf("Consider using --recursive to search inside subdirectories\n");
@@ -1556,7 +1651,10 @@ bool processSettings(Common::String &command, Common::StringMap &settings, Commo
 			}
 		}
 	} else if (command == "detect") {
-		detectGames(settings["path"], gameOption.engineId, gameOption.gameId, settings["recursive"] == "true");
+		if (settings["benchmark"] == "true")
+			benchmarkDetection(settings["path"], settings["recursive"] == "true");
+		else
+			detectGames(settings["path"], gameOption.engineId, gameOption.gameId, settings["recursive"] == "true");
 		return true;
 	} else if (command == "add") {
 		addGames(settings["path"], gameOption.engineId, gameOption.gameId, settings["recursive"] == "true");
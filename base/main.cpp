@@ -31,6 +31,7 @@
 // FIXME: Avoid using printf
 #define FORBIDDEN_SYMBOL_EXCEPTION_printf
 
+#include "engines/advancedDetector.h"
 #include "engines/engine.h"
 #include "engines/metaengine.h"
 #include "base/commandLine.h"
@@ -465,6 +466,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 		if (res.getCode() != Common::kNoError)
 			warning("%s", res.getDesc().c_str());
 
+		MD5Man.savePersistent(true);
 		PluginManager::instance().unloadDetectionPlugin();
 		PluginManager::instance().unloadAllPlugins();
 		PluginManager::destroy();
@@ -694,6 +696,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	Cloud::CloudManager::destroy();
 #endif
 #endif
+	MD5Man.savePersistent(true);
 	PluginManager::instance().unloadDetectionPlugin();
 	PluginManager::instance().unloadAllPlugins();
 	PluginManager::destroy();
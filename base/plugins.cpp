@@ -720,24 +720,39 @@ QualifiedGameList EngineManager::findGameInLoadedPlugins(const Common::String &g
 }
 
 DetectionResults EngineManager::detectGames(const Common::FSList &fslist) const {
-	DetectedGames candidates;
-	PluginList plugins;
-	PluginList::const_iterator iter;
-
 	// MetaEngines are always loaded into memory, so, get them and
 	// run detection for all of them.
-	plugins = getPlugins(PLUGIN_TYPE_ENGINE_DETECTION);
+	PluginList plugins = getPlugins(PLUGIN_TYPE_ENGINE_DETECTION);
+
+	// set the debug flags
+	for (PluginList::const_iterator iter = plugins.begin(); iter != plugins.end(); ++iter)
+		DebugMan.addAllDebugChannels((*iter)->get<MetaEngineDetection>().getDebugChannels());
 
 	// Clear md5 cache before each detection starts, just in case.
 	MD5Man.clear();
 
+	DetectedGames candidates = detectGames(plugins, fslist);
+
+	// Keep the MD5s computed so far for the next runs
+	MD5Man.savePersistent(false);
+
+	return DetectionResults(candidates);
+}
+
+DetectedGames EngineManager::detectGames(const PluginList &plugins, const Common::FSList &fslist) const {
+	DetectedGames candidates;
+
 	// Iterate over all known games and for each check if it might be
 	// the game in the presented directory.
-	for (iter = plugins.begin(); iter != plugins.end(); ++iter) {
+	for (PluginList::const_iterator iter = plugins.begin(); iter != plugins.end(); ++iter) {
 		const MetaEngineDetection &metaEngine = (*iter)->get<MetaEngineDetection>();
-		// set the debug flags
-		DebugMan.addAllDebugChannels(metaEngine.getDebugChannels());
-		DetectedGames engineCandidates = metaEngine.detectGames(fslist);
+		DetectedGames engineCandidates;
+		if (metaEngine.isDetectionThreadSafe()) {
+			engineCandidates = metaEngine.detectGames(fslist);
+		} else {
+			DetectionLock lock;
+			engineCandidates = metaEngine.detectGames(fslist);
+		}
 
 		for (uint i = 0; i < engineCandidates.size(); i++) {
 			engineCandidates[i].path = fslist.begin()->getParent().getPath();
@@ -746,7 +761,7 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist) const
 		}
 	}
 
-	return DetectionResults(candidates);
+	return candidates;
 }
 
 const PluginList &EngineManager::getPlugins(const PluginType fetchPluginType) const {
@@ -976,6 +991,221 @@ void EngineManager::upgradeTargetForEngineId(const Common::String &target) const
 	ConfMan.flushToDisk();
 }
 
+// Detection scans
+
+#include "common/worker-pool.h"
+
+struct DetectionScan::Directory {
+	explicit Directory(const Common::FSNode &node_) : node(node_), scanned(false) {}
+
+	Common::FSNode node;
+	bool scanned;
+	DetectedGames games;
+	/** The subdirectories, owned by this directory until it is handed out */
+	Common::Array<Directory *> children;
+};
+
+/** Job queued once per directory, scanning whichever is next in the queue */
+struct DetectionScan::Job : public Common::WorkerJob {
+	explicit Job(DetectionScan *scan_) : scan(scan_) {}
+
+	void run() override {
+		scan->scanNext();
+	}
+
+	DetectionScan *scan;
+};
+
+EngineManager::~EngineManager() {
+	delete _detectionMutex;
+}
+
+DetectionLock::DetectionLock() : _mutex(EngineMan._detectionMutex) {
+	if (_mutex)
+		_mutex->lock();
+}
+
+DetectionLock::DetectionLock(Common::Mutex *mutex) : _mutex(mutex) {
+	if (_mutex)
+		_mutex->lock();
+}
+
+DetectionLock::~DetectionLock() {
+	if (_mutex)
+		_mutex->unlock();
+}
+
+DetectionScan::DetectionScan(const Common::FSNode &startDir, bool recursive, int threads) :
+		_recursive(recursive), _workerPool(nullptr), _job(nullptr), _mutex(nullptr),
+		_scannedCount(0), _directoryCount(1), _cancelled(false), _finished(false) {
+	_plugins = EngineMan.getPlugins(PLUGIN_TYPE_ENGINE_DETECTION);
+
+	// The detectors run on the worker threads, set up what they share
+	// while nothing else is running
+	for (PluginList::const_iterator iter = _plugins.begin(); iter != _plugins.end(); ++iter)
+		DebugMan.addAllDebugChannels((*iter)->get<MetaEngineDetection>().getDebugChannels());
+	MD5Man.clear();
+
+	Directory *root = new Directory(startDir);
+	_pending.push_back(root);
+	_queue.push_back(root);
+
+	if (threads < 0) {
+		if (ConfMan.hasKey("detection_threads", Common::ConfigManager::kApplicationDomain))
+			threads = MAX(ConfMan.getInt("detection_threads", Common::ConfigManager::kApplicationDomain), 0);
+		else
+			threads = Common::WorkerPool::getDefaultThreadCount(7);
+	}
+
+	if (threads > 0) {
+		_workerPool = new Common::WorkerPool(threads);
+		if (_workerPool->getThreadCount() == 0) {
+			delete _workerPool;
+			_workerPool = nullptr;
+		}
+	}
+
+	if (_workerPool) {
+		if (!EngineMan._detectionMutex)
+			EngineMan._detectionMutex = new Common::Mutex();
+		MD5Man.enableLocking();
+		_mutex = new Common::Mutex();
+
+		EngineMan._parallelScans++;
+		_job = new Job(this);
+		_workerPool->addJob(_job);
+	}
+}
+
+DetectionScan::~DetectionScan() {
+	cancel();
+
+	if (_workerPool) {
+		delete _workerPool;
+		delete _job;
+		EngineMan._parallelScans--;
+	}
+
+	for (uint i = 0; i < _pending.size(); i++)
+		deleteDirectory(_pending[i]);
+	delete _mutex;
+
+	MD5Man.savePersistent(true);
+}
+
+void DetectionScan::deleteDirectory(Directory *dir) {
+	for (uint i = 0; i < dir->children.size(); i++)
+		deleteDirectory(dir->children[i]);
+	delete dir;
+}
+
+bool DetectionScan::scanNext() {
+	Directory *dir;
+	{
+		DetectionLock lock(_mutex);
+		if (_cancelled || _queue.empty())
+			return false;
+		dir = _queue.back();
+		_queue.pop_back();
+	}
+
+	// Until it is marked as scanned, only this thread uses the directory
+	Common::FSList files;
+	if (dir->node.getChildren(files, Common::FSNode::kListAll)) {
+		if (!files.empty())
+			dir->games = EngineMan.detectGames(_plugins, files);
+
+		if (_recursive) {
+			for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
+				if (file->isDirectory())
+					dir->children.push_back(new Directory(*file));
+			}
+		}
+	}
+
+	// FSNodes are reference counted without locking, so the list has to go
+	// before the subdirectories are handed to other threads
+	files.clear();
+
+	uint children;
+	{
+		DetectionLock lock(_mutex);
+		dir->scanned = true;
+		_scannedCount++;
+		_directoryCount += dir->children.size();
+		children = dir->children.size();
+		for (uint i = children; i > 0; i--)
+			_queue.push_back(dir->children[i - 1]);
+	}
+
+	if (_workerPool) {
+		for (uint i = 0; i < children; i++)
+			_workerPool->addJob(_job);
+	}
+
+	return true;
+}
+
+bool DetectionScan::update(Common::Array<Result> &results, uint32 maxTime) {
+	const uint32 start = g_system->getMillis();
+
+	while (!_finished) {
+		{
+			DetectionLock lock(_mutex);
+			if (_cancelled)
+				return true;
+
+			// Hand out the scanned directories, depth first
+			while (!_pending.empty() && _pending.back()->scanned) {
+				Directory *dir = _pending.back();
+				_pending.pop_back();
+
+				results.push_back(Result());
+				results.back().directory = dir->node;
+				results.back().games = dir->games;
+
+				for (uint i = dir->children.size(); i > 0; i--)
+					_pending.push_back(dir->children[i - 1]);
+				delete dir;
+			}
+
+			_finished = _pending.empty();
+		}
+
+		if (_finished || g_system->getMillis() - start >= maxTime)
+			break;
+
+		// Lend a hand to the worker threads, or wait for them if all the
+		// remaining directories are being scanned already
+		if (!scanNext())
+			g_system->delayMillis(1);
+	}
+
+	// Keep the MD5s computed so far for the next runs
+	MD5Man.savePersistent(_finished);
+
+	return _finished;
+}
+
+void DetectionScan::cancel() {
+	DetectionLock lock(_mutex);
+	_cancelled = true;
+}
+
+uint DetectionScan::getScannedCount() const {
+	DetectionLock lock(_mutex);
+	return _scannedCount;
+}
+
+uint DetectionScan::getDirectoryCount() const {
+	DetectionLock lock(_mutex);
+	return _directoryCount;
+}
+
+uint DetectionScan::getThreadCount() const {
+	return _workerPool ? _workerPool->getThreadCount() : 0;
+}
+
 // Music plugins
 
 #include "audio/musicplugin.h"
@@ -996,6 +1226,35 @@ namespace Common {
 DECLARE_SINGLETON(ScalerManager);
 }
 
+ScalerManager::ScalerManager() : _workerPool(nullptr), _workerPoolCreated(false) {
+}
+
+ScalerManager::~ScalerManager() {
+	delete _workerPool;
+}
+
+Common::WorkerPool *ScalerManager::getWorkerPool() {
+	if (!_workerPoolCreated) {
+		_workerPoolCreated = true;
+
+		uint threads;
+		if (ConfMan.hasKey("scaler_threads", Common::ConfigManager::kApplicationDomain))
+			threads = MAX(ConfMan.getInt("scaler_threads", Common::ConfigManager::kApplicationDomain), 0);
+		else
+			threads = Common::WorkerPool::getDefaultThreadCount(3);
+
+		if (threads > 0) {
+			_workerPool = new Common::WorkerPool(threads);
+			if (_workerPool->getThreadCount() == 0) {
+				delete _workerPool;
+				_workerPool = nullptr;
+			}
+		}
+	}
+
+	return _workerPool;
+}
+
 const PluginList &ScalerManager::getPlugins() const {
 	return PluginManager::instance().getPlugins(PLUGIN_TYPE_SCALER);
 }
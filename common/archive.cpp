@@ -21,6 +21,7 @@
  */
 
 #include "common/archive.h"
+#include "common/atomic.h"
 #include "common/fs.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -40,6 +41,10 @@ SeekableReadStream *GenericArchiveMember::createReadStream() const {
 }
 
 
+SeekableReadStream *Archive::createMappedReadStreamForMember(const String &name, uint32 minSize) const {
+	return createReadStreamForMember(name);
+}
+
 int Archive::listMatchingMembers(ArchiveMemberList &list, const String &pattern) const {
 	// Get all "names" (TODO: "files" ?)
 	ArchiveMemberList allNames;
@@ -61,6 +66,54 @@ int Archive::listMatchingMembers(ArchiveMemberList &list, const String &pattern)
 }
 
 
+/**
+ * Bumped whenever any SearchSet changes. A SearchSet can contain other
+ * SearchSets, so a change to one of them can invalidate the index of another.
+ */
+static uint32 s_searchSetGeneration = 1;
+
+/**
+ * Names no archive has are kept so that probing for optional files stays
+ * cheap, but engines can probe many names once. Past this number, the
+ * index starts over.
+ */
+enum {
+	kMaxIndexMissing = 1024
+};
+
+void SearchSet::invalidateIndex() {
+	atomicFetchAdd(s_searchSetGeneration, 1U);
+}
+
+bool SearchSet::lookupIndex(const String &name, Archive *&arc) const {
+	StackLock lock(_indexMutex);
+
+	const uint32 generation = atomicLoadAcquire(s_searchSetGeneration);
+	if (_indexGeneration != generation) {
+		_index.clear();
+		_indexMissing = 0;
+		_indexGeneration = generation;
+	}
+
+	if (_index.tryGetVal(name, arc)) {
+		++_indexHits;
+		return true;
+	}
+
+	++_indexMisses;
+	return false;
+}
+
+void SearchSet::storeIndex(const String &name, Archive *arc) const {
+	StackLock lock(_indexMutex);
+
+	if (!arc && !_index.contains(name) && ++_indexMissing > kMaxIndexMissing) {
+		_index.clear();
+		_indexMissing = 1;
+	}
+
+	_index[name] = arc;
+}
 
 SearchSet::ArchiveNodeList::iterator SearchSet::find(const String &name) {
 	ArchiveNodeList::iterator it = _list.begin();
@@ -92,6 +145,7 @@ void SearchSet::insert(const Node &node) {
 			break;
 	}
 	_list.insert(it, node);
+	invalidateIndex();
 }
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
@@ -173,6 +227,7 @@ void SearchSet::remove(const String &name) {
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
+		invalidateIndex();
 	}
 }
 
@@ -187,6 +242,7 @@ void SearchSet::clear() {
 	}
 
 	_list.clear();
+	invalidateIndex();
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -209,13 +265,23 @@ bool SearchSet::hasFile(const String &name) const {
 	if (name.empty())
 		return false;
 
+	// Only the archive that had the member is asked again, so that members
+	// which went away, e.g. files deleted from disk, are noticed
+	Archive *indexed;
+	if (lookupIndex(name, indexed) && (!indexed || indexed->hasFile(name)))
+		return indexed != nullptr;
+
+	Archive *found = nullptr;
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(name))
-			return true;
+		if (it->_arc->hasFile(name)) {
+			found = it->_arc;
+			break;
+		}
 	}
 
-	return false;
+	storeIndex(name, found);
+	return found != nullptr;
 }
 
 int SearchSet::listMatchingMembers(ArchiveMemberList &list, const String &pattern) const {
@@ -239,32 +305,58 @@ int SearchSet::listMembers(ArchiveMemberList &list) const {
 }
 
 const ArchiveMemberPtr SearchSet::getMember(const String &name) const {
-	if (name.empty())
+	if (!hasFile(name))
 		return ArchiveMemberPtr();
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(name))
-			return it->_arc->getMember(name);
-	}
+	// hasFile() just indexed the archive which has the member
+	Archive *indexed;
+	if (!lookupIndex(name, indexed) || !indexed)
+		return ArchiveMemberPtr();
 
-	return ArchiveMemberPtr();
+	return indexed->getMember(name);
 }
 
 SeekableReadStream *SearchSet::createReadStreamForMember(const String &name) const {
+	return openMember(name, false, 0);
+}
+
+SeekableReadStream *SearchSet::createMappedReadStreamForMember(const String &name, uint32 minSize) const {
+	return openMember(name, true, minSize);
+}
+
+static SeekableReadStream *openArchiveMember(const Archive *arc, const String &name, bool mapped, uint32 mapMinSize) {
+	return mapped ? arc->createMappedReadStreamForMember(name, mapMinSize) : arc->createReadStreamForMember(name);
+}
+
+SeekableReadStream *SearchSet::openMember(const String &name, bool mapped, uint32 mapMinSize) const {
 	if (name.empty())
 		return nullptr;
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		SeekableReadStream *stream = it->_arc->createReadStreamForMember(name);
+	Archive *indexed;
+	if (lookupIndex(name, indexed)) {
+		if (!indexed)
+			return nullptr;
+
+		SeekableReadStream *stream = openArchiveMember(indexed, name, mapped, mapMinSize);
 		if (stream)
 			return stream;
+		// The member went away or can't be opened; search all archives again
 	}
 
-	return nullptr;
-}
+	Archive *found = nullptr;
+	SeekableReadStream *stream = nullptr;
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for (; it != _list.end(); ++it) {
+		stream = openArchiveMember(it->_arc, name, mapped, mapMinSize);
+		if (stream) {
+			found = it->_arc;
+			break;
+		}
+	}
 
+	storeIndex(name, found);
+	return stream;
+}
 
 SearchManager::SearchManager() {
 	clear(); // Force a reset
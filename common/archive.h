@@ -24,7 +24,10 @@
 #define COMMON_ARCHIVE_H
 
 #include "common/str.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
 #include "common/list.h"
+#include "common/mutex.h"
 #include "common/ptr.h"
 #include "common/singleton.h"
 
@@ -137,6 +140,19 @@ public:
 	 * @return The newly created input stream.
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const = 0;
+
+	/**
+	 * Create a stream bound to a member with the specified name in the
+	 * archive, like createReadStreamForMember(), but map the member into
+	 * memory if it has at least the given size and the archive supports it.
+	 * See FSNode::createMappedReadStream() for which files this is safe for.
+	 * By default, this is the same as createReadStreamForMember().
+	 *
+	 * @param name    Name of the member.
+	 * @param minSize Minimum size in bytes of the members to map.
+	 * @return The newly created input stream.
+	 */
+	virtual SeekableReadStream *createMappedReadStreamForMember(const String &name, uint32 minSize) const;
 };
 
 
@@ -147,6 +163,17 @@ public:
  * contained Archives, hence the simplistic policy of always looking for the first
  * match. SearchSet does guarantee that searches are performed in DESCENDING
  * priority order. In case of conflicting priorities, insertion order prevails.
+ *
+ * The archive that answers a lookup is remembered in a member index, so that
+ * repeated lookups of the same name only ask that archive again, and lookups
+ * of missing names don't ask any archive, instead of walking over all of
+ * them. Like the archives' own lookups, the index ignores case. It is dropped
+ * whenever archives are added, removed or reordered in any SearchSet, and
+ * when it holds too many missing names. Archives which gain members after
+ * they were added must call invalidateIndex().
+ *
+ * Lookups may be done from several threads at once, as they were before the
+ * index; adding, removing or reordering archives may not.
  */
 class SearchSet : public Archive {
 	struct Node {
@@ -168,8 +195,32 @@ class SearchSet : public Archive {
 
 	bool _ignoreClashes;
 
+	/**
+	 * Archive answering each name looked up so far, or nullptr if no archive
+	 * has the member. Valid as long as _indexGeneration matches the global
+	 * generation, which every change to any SearchSet bumps, since a
+	 * SearchSet can itself be a member of another one. Guarded by
+	 * _indexMutex, as const lookups may come from several threads.
+	 */
+	typedef HashMap<String, Archive *, IgnoreCase_Hash, IgnoreCase_EqualTo> MemberIndex;
+	mutable MemberIndex _index;
+	mutable Mutex _indexMutex;
+	mutable uint32 _indexGeneration;
+	mutable uint32 _indexMissing;
+	mutable uint32 _indexHits;
+	mutable uint32 _indexMisses;
+
+	/** Get the index entry for name, return false if it has not been looked up yet. */
+	bool lookupIndex(const String &name, Archive *&arc) const;
+
+	/** Remember the archive answering name, or nullptr if none has it. */
+	void storeIndex(const String &name, Archive *arc) const;
+
+	/** Open the member, mapped if it has at least mapMinSize bytes unless mapped is false. */
+	SeekableReadStream *openMember(const String &name, bool mapped, uint32 mapMinSize) const;
+
 public:
-	SearchSet() : _ignoreClashes(false) { }
+	SearchSet() : _ignoreClashes(false), _indexGeneration(0), _indexMissing(0), _indexHits(0), _indexMisses(0) { }
 	virtual ~SearchSet() { clear(); }
 
 	/**
@@ -262,12 +313,31 @@ public:
 	 * opening the first file encountered that matches the name.
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
+	virtual SeekableReadStream *createMappedReadStreamForMember(const String &name, uint32 minSize) const;
 
 	/**
 	 * Ignore clashes when adding directories. For more details, see the corresponding parameter
 	 * in @ref FSDirectory documentation.
 	 */
 	void setIgnoreClashes(bool ignoreClashes) { _ignoreClashes = ignoreClashes; }
+
+	/**
+	 * Forget all names remembered in the member index of every SearchSet.
+	 * Only needed when an archive added to a SearchSet gains members.
+	 */
+	static void invalidateIndex();
+
+	/** Number of lookups answered from the member index. */
+	uint32 getIndexHits() const { return _indexHits; }
+
+	/** Number of lookups that had to search the archives. */
+	uint32 getIndexMisses() const { return _indexMisses; }
+
+	/** Reset the member index hit and miss counters. */
+	void resetIndexStats() {
+		StackLock lock(_indexMutex);
+		_indexHits = _indexMisses = 0;
+	}
 };
 
 
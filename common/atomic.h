@@ -0,0 +1,125 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+#if defined(_MSC_VER)
+// Pulls in intrin.h while taking care of the forbidden symbols
+#include "common/math.h"
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_atomic Atomic operations
+ * @ingroup common
+ *
+ * @brief Minimal set of atomic helpers for data shared between threads.
+ *
+ * These are meant for the few places where code running in a backend thread
+ * (audio callback, worker threads) must exchange data with the engine thread
+ * without taking a mutex, e.g. single-producer/single-consumer queues and
+ * statistics counters. Only naturally aligned integers and pointers may be
+ * passed to them.
+ *
+ * On compilers without atomic builtins the helpers degrade to plain volatile
+ * accesses, which is only correct on single-core targets.
+ * @{
+ */
+
+#if defined(__clang__) || GCC_ATLEAST(4, 7)
+
+template<typename T>
+inline T atomicLoadAcquire(const T &var) {
+	return __atomic_load_n(&var, __ATOMIC_ACQUIRE);
+}
+
+template<typename T>
+inline void atomicStoreRelease(T &var, T value) {
+	__atomic_store_n(&var, value, __ATOMIC_RELEASE);
+}
+
+template<typename T>
+inline T atomicFetchAdd(T &var, T delta) {
+	return __atomic_fetch_add(&var, delta, __ATOMIC_SEQ_CST);
+}
+
+#elif defined(_MSC_VER)
+
+#if defined(_M_ARM) || defined(_M_ARM64)
+#define COMMON_ATOMIC_BARRIER() __dmb(_ARM64_BARRIER_ISH)
+#else
+#define COMMON_ATOMIC_BARRIER() _ReadWriteBarrier()
+#endif
+
+template<typename T>
+inline T atomicLoadAcquire(const T &var) {
+	T value = *(const volatile T *)&var;
+	COMMON_ATOMIC_BARRIER();
+	return value;
+}
+
+template<typename T>
+inline void atomicStoreRelease(T &var, T value) {
+	COMMON_ATOMIC_BARRIER();
+	*(volatile T *)&var = value;
+}
+
+template<typename T>
+inline T atomicFetchAdd(T &var, T delta) {
+	STATIC_ASSERT(sizeof(T) == sizeof(long), atomicFetchAdd_requires_32bit_type);
+	return (T)_InterlockedExchangeAdd((volatile long *)&var, (long)delta);
+}
+
+#undef COMMON_ATOMIC_BARRIER
+
+#else
+
+template<typename T>
+inline T atomicLoadAcquire(const T &var) {
+	return *(const volatile T *)&var;
+}
+
+template<typename T>
+inline void atomicStoreRelease(T &var, T value) {
+	*(volatile T *)&var = value;
+}
+
+template<typename T>
+inline T atomicFetchAdd(T &var, T delta) {
+	volatile T *ptr = &var;
+	T old = *ptr;
+	*ptr = old + delta;
+	return old;
+}
+
+#endif
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -42,10 +42,11 @@ void lockMemoryPoolMutex() {
 	// but we may use the String class earlier than that (it is for example
 	// used in the OSystem_POSIX constructor). However in those early stages
 	// we can hope we don't have multiple threads either.
-	if (!g_system || !g_system->backendInitialized())
-		return;
-	if (!g_refCountPoolMutex)
+	if (!g_refCountPoolMutex) {
+		if (!g_system || !g_system->backendInitialized())
+			return;
 		g_refCountPoolMutex = new Mutex();
+	}
 	g_refCountPoolMutex->lock();
 }
 
@@ -54,6 +55,11 @@ void unlockMemoryPoolMutex() {
 		g_refCountPoolMutex->unlock();
 }
 
+TEMPLATE void BASESTRING::createMemoryPoolMutex() {
+	if (!g_refCountPoolMutex)
+		g_refCountPoolMutex = new Mutex();
+}
+
 TEMPLATE void BASESTRING::releaseMemoryPoolMutex() {
 	if (g_refCountPoolMutex){
 		delete g_refCountPoolMutex;
@@ -34,6 +34,13 @@ class BaseString {
 public:
 	static void releaseMemoryPoolMutex();
 
+	/**
+	 * Lock the shared pool of reference counts from now on, even if the
+	 * backend is not initialized yet. Call this before starting threads
+	 * which use strings that early.
+	 */
+	static void createMemoryPoolMutex();
+
 	static const uint32 npos = 0xFFFFFFFF;
 	typedef T          value_type;
 	typedef T *        iterator;
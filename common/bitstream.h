@@ -42,6 +42,160 @@ namespace Common {
  * @{
  */
 
+/**
+ * A cut-down version of MemoryReadStream specifically for use with BitStream.
+ * It removes the virtual call overhead for reading bytes from a memory buffer,
+ * and allows directly inlining this access.
+ *
+ * The code duplication with MemoryReadStream is not ideal.
+ * It might be possible to avoid this by making this a final subclass of
+ * MemoryReadStream, but that is a C++11 feature.
+ */
+class BitStreamMemoryStream {
+private:
+	const byte * const _ptrOrig;
+	const byte *_ptr;
+	const uint32 _size;
+	uint32 _pos;
+	DisposeAfterUse::Flag _disposeMemory;
+	bool _eos;
+/** @overload */
+public:
+	BitStreamMemoryStream(const byte *dataPtr, uint32 dataSize, DisposeAfterUse::Flag disposeMemory = DisposeAfterUse::NO) :
+		_ptrOrig(dataPtr),
+		_ptr(dataPtr),
+		_size(dataSize),
+		_pos(0),
+		_disposeMemory(disposeMemory),
+		_eos(false) {}
+
+	~BitStreamMemoryStream() {
+		if (_disposeMemory)
+			free(const_cast<byte *>(_ptrOrig));
+	}
+
+	bool eos() const {
+		return _eos;
+	}
+
+	bool err() const {
+		return false;
+	}
+
+	int64 pos() const {
+		return _pos;
+	}
+
+	int64 size() const {
+		return _size;
+	}
+
+	bool seek(uint32 offset) {
+		assert(offset <= _size);
+
+		_eos = false;
+		_pos = offset;
+		_ptr = _ptrOrig + _pos;
+		return true;
+	}
+
+	byte readByte() {
+		if (_pos >= _size) {
+			_eos = true;
+			return 0;
+		}
+
+		_pos++;
+		return *_ptr++;
+	}
+
+	uint16 readUint16LE() {
+		if (_pos + 2 > _size) {
+			_eos = true;
+			if (_pos < _size) {
+				_pos++;
+				return *_ptr++;
+			} else {
+				return 0;
+			}
+		}
+
+		uint16 val = READ_LE_UINT16(_ptr);
+
+		_pos += 2;
+		_ptr += 2;
+
+		return val;
+	}
+
+	uint16 readUint16BE() {
+		if (_pos + 2 > _size) {
+			_eos = true;
+			if (_pos < _size) {
+				_pos++;
+				return (*_ptr++) << 8;
+			} else {
+				return 0;
+			}
+		}
+
+		uint16 val = READ_BE_UINT16(_ptr);
+
+		_pos += 2;
+		_ptr += 2;
+
+		return val;
+	}
+
+	/** Return the next @p count bytes for reading them directly, or nullptr if there are fewer left. */
+	const byte *peekBlock(uint32 count) const {
+		return _pos + count <= _size ? _ptr : nullptr;
+	}
+
+	/** Skip @p count bytes, which have been checked with peekBlock(). */
+	void skipBlock(uint32 count) {
+		_pos += count;
+		_ptr += count;
+	}
+
+	uint32 readUint32LE() {
+		if (_pos + 4 > _size) {
+			uint32 val = readByte();
+			val |= (uint32)readByte() << 8;
+			val |= (uint32)readByte() << 16;
+			val |= (uint32)readByte() << 24;
+
+			return val;
+		}
+
+		uint32 val = READ_LE_UINT32(_ptr);
+
+		_pos += 4;
+		_ptr += 4;
+
+		return val;
+	}
+
+	uint32 readUint32BE() {
+		if (_pos + 4 > _size) {
+			uint32 val = (uint32)readByte() << 24;
+			val |= (uint32)readByte() << 16;
+			val |= (uint32)readByte() << 8;
+			val |= (uint32)readByte();
+
+			return val;
+		}
+
+		uint32 val = READ_BE_UINT32(_ptr);
+
+		_pos += 4;
+		_ptr += 4;
+
+		return val;
+	}
+
+};
+
 /**
  * A template implementing a bit stream for different data memory layouts.
  *
@@ -85,8 +239,51 @@ private:
 		return 0;
 	}
 
+	/** Generic streams are read one value at a time. */
+	template<class S>
+	inline void fillBlock(S *stream) {
+	}
+
+	/**
+	 * Fill the container with as many values as fit with a single 64-bit load,
+	 * if there is enough data left. Otherwise, fillContainer() reads the last
+	 * values one at a time, with the usual bounds checks.
+	 */
+	inline void fillBlock(BitStreamMemoryStream *stream) {
+		const byte *data = stream->peekBlock(8);
+		if (!data)
+			return;
+
+		const uint32 bits = ((64 - _bitsLeft) / valueBits) * valueBits;
+
+		// Load the values so that they are in stream order. For values whose byte
+		// order differs from their bit order, swap the bytes within each value.
+		uint64 block = MSB2LSB ? READ_BE_UINT64(data) : READ_LE_UINT64(data);
+		if (valueBits != 8 && isLE == MSB2LSB) {
+			block = ((block & 0x00FF00FF00FF00FFULL) << 8) | ((block >> 8) & 0x00FF00FF00FF00FFULL);
+			if (valueBits == 32)
+				block = ((block & 0x0000FFFF0000FFFFULL) << 16) | ((block >> 16) & 0x0000FFFF0000FFFFULL);
+		}
+
+		if (MSB2LSB) {
+			// The bits start at the MSB of the container
+			_bitContainer |= (block >> (64 - bits) << (64 - bits)) >> _bitsLeft;
+		} else {
+			// The bits start at the LSB of the container
+			if (bits < 64)
+				block &= ((uint64)1 << bits) - 1;
+			_bitContainer |= block << _bitsLeft;
+		}
+
+		stream->skipBlock(bits / 8);
+		_bitsLeft += bits;
+	}
+
 	/** Fill the container with at least @p min bits. */
 	inline void fillContainer(size_t min) {
+		if (_bitsLeft < min)
+			fillBlock(_stream);
+
 		while (_bitsLeft < min) {
 
 			uint64 data;
@@ -285,149 +482,6 @@ public:
 
 
 
-/**
- * A cut-down version of MemoryReadStream specifically for use with BitStream.
- * It removes the virtual call overhead for reading bytes from a memory buffer,
- * and allows directly inlining this access.
- *
- * The code duplication with MemoryReadStream is not ideal.
- * It might be possible to avoid this by making this a final subclass of
- * MemoryReadStream, but that is a C++11 feature.
- */
-class BitStreamMemoryStream {
-private:
-	const byte * const _ptrOrig;
-	const byte *_ptr;
-	const uint32 _size;
-	uint32 _pos;
-	DisposeAfterUse::Flag _disposeMemory;
-	bool _eos;
-/** @overload */
-public:
-	BitStreamMemoryStream(const byte *dataPtr, uint32 dataSize, DisposeAfterUse::Flag disposeMemory = DisposeAfterUse::NO) :
-		_ptrOrig(dataPtr),
-		_ptr(dataPtr),
-		_size(dataSize),
-		_pos(0),
-		_disposeMemory(disposeMemory),
-		_eos(false) {}
-
-	~BitStreamMemoryStream() {
-		if (_disposeMemory)
-			free(const_cast<byte *>(_ptrOrig));
-	}
-
-	bool eos() const {
-		return _eos;
-	}
-
-	bool err() const {
-		return false;
-	}
-
-	int64 pos() const {
-		return _pos;
-	}
-
-	int64 size() const {
-		return _size;
-	}
-
-	bool seek(uint32 offset) {
-		assert(offset <= _size);
-
-		_eos = false;
-		_pos = offset;
-		_ptr = _ptrOrig + _pos;
-		return true;
-	}
-
-	byte readByte() {
-		if (_pos >= _size) {
-			_eos = true;
-			return 0;
-		}
-
-		_pos++;
-		return *_ptr++;
-	}
-
-	uint16 readUint16LE() {
-		if (_pos + 2 > _size) {
-			_eos = true;
-			if (_pos < _size) {
-				_pos++;
-				return *_ptr++;
-			} else {
-				return 0;
-			}
-		}
-
-		uint16 val = READ_LE_UINT16(_ptr);
-
-		_pos += 2;
-		_ptr += 2;
-
-		return val;
-	}
-
-	uint16 readUint16BE() {
-		if (_pos + 2 > _size) {
-			_eos = true;
-			if (_pos < _size) {
-				_pos++;
-				return (*_ptr++) << 8;
-			} else {
-				return 0;
-			}
-		}
-
-		uint16 val = READ_LE_UINT16(_ptr);
-
-		_pos += 2;
-		_ptr += 2;
-
-		return val;
-	}
-
-	uint32 readUint32LE() {
-		if (_pos + 4 > _size) {
-			uint32 val = readByte();
-			val |= (uint32)readByte() << 8;
-			val |= (uint32)readByte() << 16;
-			val |= (uint32)readByte() << 24;
-
-			return val;
-		}
-
-		uint32 val = READ_LE_UINT32(_ptr);
-
-		_pos += 4;
-		_ptr += 4;
-
-		return val;
-	}
-
-	uint32 readUint32BE() {
-		if (_pos + 4 > _size) {
-			uint32 val = (uint32)readByte() << 24;
-			val |= (uint32)readByte() << 16;
-			val |= (uint32)readByte() << 8;
-			val |= (uint32)readByte();
-
-			return val;
-		}
-
-		uint32 val = READ_BE_UINT32(_ptr);
-
-		_pos += 4;
-		_ptr += 4;
-
-		return val;
-	}
-
-};
-
 /**
  * @name Typedefs for various memory layouts
  * @{
@@ -59,6 +59,22 @@ bool File::open(const String &filename, Archive &archive) {
 	return open(stream, filename);
 }
 
+bool File::openMapped(const String &filename, uint32 minSize) {
+	assert(!filename.empty());
+	assert(!_handle);
+
+	SeekableReadStream *stream = nullptr;
+
+	if ((stream = SearchMan.createMappedReadStreamForMember(filename, minSize))) {
+		debug(8, "Opening hashed: %s", filename.c_str());
+	} else if ((stream = SearchMan.createMappedReadStreamForMember(filename + ".", minSize))) {
+		// WORKAROUND: Bug #2548, see open()
+		debug(8, "Opening hashed: %s.", filename.c_str());
+	}
+
+	return open(stream, filename);
+}
+
 bool File::open(const FSNode &node) {
 	assert(!_handle);
 
@@ -143,6 +159,11 @@ uint32 File::read(void *ptr, uint32 len) {
 	return _handle->read(ptr, len);
 }
 
+SeekableReadStream *File::readStream(uint32 dataSize) {
+	assert(_handle);
+	return _handle->readStream(dataSize);
+}
+
 
 DumpFile::DumpFile() : _handle(nullptr) {
 }
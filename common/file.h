@@ -54,6 +54,11 @@ protected:
 	String _name;
 
 public:
+	enum {
+		/** Files smaller than this are read through the regular stream by openMapped() by default */
+		kDefaultMapMinSize = 1024 * 1024
+	};
+
 	File();
 	virtual ~File();
 
@@ -85,6 +90,20 @@ public:
 	 */
 	virtual bool open(const String &filename, Archive &archive);
 
+	/**
+	 * Try to open the file with the given file name, by searching SearchMan,
+	 * and map it into memory if it has at least the given size and the
+	 * backend supports it. Reads from a mapped file don't go through any
+	 * buffers, and readStream() returns substreams sharing the mapping.
+	 * See FSNode::createMappedReadStream() for which files this is safe for.
+	 * @note Must not be called if this file is already open (i.e. if isOpen returns true).
+	 *
+	 * @param	filename	Name of the file to open.
+	 * @param	minSize		Minimum size in bytes of the files to map.
+	 * @return	True if the file was opened successfully, false otherwise.
+	 */
+	bool openMapped(const String &filename, uint32 minSize = kDefaultMapMinSize);
+
 	/**
 	 * Try to open the file corresponding to the given node. Will check whether the
 	 * node actually refers to an existing file (and not a directory), and handle
@@ -134,6 +153,7 @@ public:
 	int64 size() const override; /*!< Implement abstract SeekableReadStream method. */
 	bool seek(int64 offs, int whence = SEEK_SET) override;	/*!< Implement abstract SeekableReadStream method. */
 	uint32 read(void *dataPtr, uint32 dataSize) override;	/*!< Implement abstract SeekableReadStream method. */
+	SeekableReadStream *readStream(uint32 dataSize) override;	/*!< Let the underlying stream avoid the copy, if it can. */
 };
 
 
@@ -125,6 +125,10 @@ bool FSNode::isWritable() const {
 	return _realNode && _realNode->isWritable();
 }
 
+bool FSNode::getFileStats(int64 &size, int64 &modificationTime) const {
+	return _realNode && _realNode->getFileStats(size, modificationTime);
+}
+
 SeekableReadStream *FSNode::createReadStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -140,6 +144,21 @@ SeekableReadStream *FSNode::createReadStream() const {
 	return _realNode->createReadStream();
 }
 
+SeekableReadStream *FSNode::createMappedReadStream() const {
+	if (_realNode == nullptr)
+		return nullptr;
+
+	if (!_realNode->exists()) {
+		warning("FSNode::createMappedReadStream: '%s' does not exist", getName().c_str());
+		return nullptr;
+	} else if (_realNode->isDirectory()) {
+		warning("FSNode::createMappedReadStream: '%s' is a directory", getName().c_str());
+		return nullptr;
+	}
+
+	return _realNode->createMappedReadStream();
+}
+
 WriteStream *FSNode::createWriteStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -259,6 +278,27 @@ SeekableReadStream *FSDirectory::createReadStreamForMember(const String &name) c
 	return stream;
 }
 
+SeekableReadStream *FSDirectory::createMappedReadStreamForMember(const String &name, uint32 minSize) const {
+	if (name.empty() || !_node.isDirectory())
+		return nullptr;
+
+	FSNode *node = lookupCache(_fileCache, name);
+	if (!node)
+		return nullptr;
+
+	// Backends which can't tell the size without opening the file don't
+	// map files either
+	int64 size, modificationTime;
+	if (!node->getFileStats(size, modificationTime) || size < minSize)
+		return createReadStreamForMember(name);
+
+	SeekableReadStream *stream = node->createMappedReadStream();
+	if (!stream)
+		warning("FSDirectory::createMappedReadStreamForMember: Can't create stream for file '%s'", name.c_str());
+
+	return stream;
+}
+
 FSDirectory *FSDirectory::getSubDirectory(const String &name, int depth, bool flat, bool ignoreClashes) {
 	return getSubDirectory(String(), name, depth, flat, ignoreClashes);
 }
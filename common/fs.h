@@ -222,6 +222,16 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Get the size and the last modification time of the file referred by
+	 * this node, without opening it. This is cheap enough to tell whether a
+	 * file changed since it was last seen. The time has no particular unit,
+	 * it is only meaningful when compared with other times of the same node.
+	 *
+	 * @return True if the backend provides them, false otherwise.
+	 */
+	bool getFileStats(int64 &size, int64 &modificationTime) const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -231,6 +241,22 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStream() const;
 
+	/**
+	 * Create a SeekableReadStream instance corresponding to the file
+	 * referred by this node, mapping it into memory where the backend
+	 * supports it. Reads from a mapped file don't go through any buffers,
+	 * and its readStream() returns substreams sharing the mapping, which
+	 * suits large container files. The file must not be modified while
+	 * the stream or any of its substreams exist.
+	 *
+	 * Only use this for files on reliable local storage: an I/O error while
+	 * accessing a mapped file, e.g. because it was truncated or its media
+	 * was removed, crashes instead of failing the read.
+	 *
+	 * @return Pointer to the stream object, 0 in case of a failure.
+	 */
+	SeekableReadStream *createMappedReadStream() const;
+
 	/**
 	 * Create a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -392,6 +418,13 @@ public:
 	 * for success.
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
+
+	/**
+	 * Open the specified file like createReadStreamForMember(), and map it
+	 * into memory if it has at least minSize bytes and the backend supports
+	 * it.
+	 */
+	virtual SeekableReadStream *createMappedReadStreamForMember(const String &name, uint32 minSize) const;
 };
 
 /** @} */
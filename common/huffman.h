@@ -25,8 +25,8 @@
 #ifndef COMMON_HUFFMAN_H
 #define COMMON_HUFFMAN_H
 
+#include "common/algorithm.h"
 #include "common/array.h"
-#include "common/list.h"
 #include "common/types.h"
 
 namespace Common {
@@ -55,6 +55,11 @@ inline uint32 REVERSEBITS(uint32 x) {
 /**
  * Huffman bit stream decoding.
  *
+ * Codes are resolved with a multi-level lookup table: the first bits of the
+ * stream index the root table, whose entries either hold a symbol or point
+ * to a sub table indexed by the following bits, and so on. Every level has
+ * at most kMaxTableBits index bits, so a code of up to 2 * kMaxTableBits bits
+ * takes two table reads.
  */
 template<class BITSTREAM>
 class Huffman {
@@ -73,29 +78,54 @@ public:
 	uint32 getSymbol(BITSTREAM &bits) const;
 
 private:
-	struct Symbol {
-		uint32 code;
+	static const uint8 kMaxTableBits = 9;
+
+	/** A code, with its bits left aligned in the order they are read. */
+	struct Code {
+		uint32 bits;
+		uint8  length;
 		uint32 symbol;
 
-		Symbol(uint32 c, uint32 s) : code(c), symbol(s) {}
+		Code(uint32 b, uint8 l, uint32 s) : bits(b), length(l), symbol(s) {}
+
+		bool operator<(const Code &other) const { return bits < other.bits; }
 	};
 
-	typedef List<Symbol> CodeList;
-	typedef Array<CodeList> CodeLists;
+	typedef Array<Code> CodeList;
 
-	/** Lists of codes and their symbols, sorted by code length. */
-	CodeLists _codes;
+	enum {
+		kSubTable = 0x80,
+		kUnknownCode = 0xFF
+	};
 
-	/** Prefix lookup table used to speed up the decoding of short codes. */
-	struct PrefixEntry {
-		uint32 symbol;
-		uint8  length;
+	/**
+	 * A lookup table entry. Entries of codes longer than the table's bits
+	 * point to a sub table at offset @p value, indexed by the next bits of
+	 * the stream. Its length is kSubTable ORed with the number of bits.
+	 */
+	struct TableEntry {
+		uint32 value;  ///< The symbol, or the sub table offset.
+		uint8  length; ///< The code length, a sub table or kUnknownCode.
 
-		PrefixEntry() : length(0xFF) {}
+		TableEntry() : value(0), length(kUnknownCode) {}
+		TableEntry(uint32 v, uint8 l) : value(v), length(l) {}
 	};
 
-	static const uint8 _prefixTableBits = 8;
-	PrefixEntry _prefixTable[1 << _prefixTableBits];
+	/** All the tables, starting with the root table of kMaxTableBits bits. */
+	Array<TableEntry> _table;
+
+	/** Resolve a code which doesn't fit in the root table. */
+	uint32 getLongSymbol(BITSTREAM &bits, const TableEntry *entry) const;
+
+	/** Fill the table at @p offset with the codes in [begin, end), which all start with @p consumed known bits. */
+	void buildTable(uint32 offset, uint8 tableBits, uint8 consumed, const CodeList &codes, uint begin, uint end);
+
+	/** Return the position of the entry for the bits @p index, as peeked from the stream. */
+	static uint32 tableIndex(uint32 index, uint8 tableBits) {
+		if (BITSTREAM::isMSB2LSB())
+			return index;
+		return REVERSEBITS(index) >> (32 - tableBits);
+	}
 };
 
 template <class BITSTREAM>
@@ -111,8 +141,8 @@ Huffman<BITSTREAM>::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *cod
 
 	assert(maxLength <= 32);
 
-	// Codes that do not fit in the prefix table are stored in the _codes array.
-	_codes.resize(MAX(maxLength - _prefixTableBits, 0));
+	CodeList sortedCodes;
+	sortedCodes.reserve(codeCount);
 
 	for (uint i = 0; i < codeCount; i++) {
 		uint8 length = lengths[i];
@@ -120,53 +150,86 @@ Huffman<BITSTREAM>::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *cod
 		// The symbol. If none was specified, assume it is identical to the code index.
 		uint32 symbol = symbols ? symbols[i] : i;
 
-		if (length <= _prefixTableBits) {
-			// Short codes go in the prefix lookup table. Set all the entries in the table
-			// with an index starting with the code to the symbol value.
-			uint32 startIndex;
-			if (BITSTREAM::isMSB2LSB()) {
-				startIndex = codes[i] << (_prefixTableBits - length);
-			} else {
-				startIndex = REVERSEBITS(codes[i]) >> (32 - _prefixTableBits);
-			}
-
-			uint32 endIndex = startIndex | ((1 << (_prefixTableBits - length)) - 1);
-
-			for (uint32 j = startIndex; j <= endIndex; j++) {
-				uint32 index = BITSTREAM::isMSB2LSB() ? j : REVERSEBITS(j) >> (32 - _prefixTableBits);
-				_prefixTable[index].symbol = symbol;
-				_prefixTable[index].length = length;
-			}
+		// LSB2MSB streams read the lowest bit of a code first
+		uint32 bits;
+		if (BITSTREAM::isMSB2LSB()) {
+			bits = length ? codes[i] << (32 - length) : 0;
 		} else {
-			// Put the code and symbol into the correct list for the length.
-			_codes[lengths[i] - 1 - _prefixTableBits].push_back(Symbol(codes[i], symbol));
+			bits = REVERSEBITS(codes[i]);
 		}
+
+		sortedCodes.push_back(Code(bits, length, symbol));
+	}
+
+	// Codes sharing a prefix are next to each other once sorted
+	Common::sort(sortedCodes.begin(), sortedCodes.end());
+
+	_table.resize(1 << kMaxTableBits);
+	buildTable(0, kMaxTableBits, 0, sortedCodes, 0, sortedCodes.size());
+}
+
+template <class BITSTREAM>
+void Huffman<BITSTREAM>::buildTable(uint32 offset, uint8 tableBits, uint8 consumed, const CodeList &codes, uint begin, uint end) {
+	uint i = begin;
+	while (i < end) {
+		const uint32 index = (codes[i].bits << consumed) >> (32 - tableBits);
+		const uint8 length = codes[i].length - consumed;
+
+		if (length <= tableBits) {
+			// Set all the entries with an index starting with the code to the symbol value.
+			const uint32 endIndex = index | ((1 << (tableBits - length)) - 1);
+			for (uint32 j = index; j <= endIndex; j++)
+				_table[offset + tableIndex(j, tableBits)] = TableEntry(codes[i].symbol, length);
+			i++;
+			continue;
+		}
+
+		// Longer codes go into a sub table, sized for the longest one sharing this prefix
+		uint8 maxLength = 0;
+		uint prefixEnd = i;
+		while (prefixEnd < end && ((codes[prefixEnd].bits << consumed) >> (32 - tableBits)) == index) {
+			maxLength = MAX(maxLength, codes[prefixEnd].length);
+			prefixEnd++;
+		}
+
+		const uint8 subTableBits = MIN<uint8>(maxLength - consumed - tableBits, kMaxTableBits);
+		const uint32 subTableOffset = _table.size();
+		_table.resize(subTableOffset + (1 << subTableBits));
+		_table[offset + tableIndex(index, tableBits)] = TableEntry(subTableOffset, kSubTable | subTableBits);
+
+		buildTable(subTableOffset, subTableBits, consumed + tableBits, codes, i, prefixEnd);
+		i = prefixEnd;
 	}
 }
 
 template <class BITSTREAM>
 uint32 Huffman<BITSTREAM>::getSymbol(BITSTREAM &bits) const {
-	uint32 code = bits.peekBits(_prefixTableBits);
+	// The indices can't be out of bounds, skip the checks of Array
+	const TableEntry *entry = &_table.data()[bits.peekBits(kMaxTableBits)];
+
+	if (entry->length & kSubTable)
+		return getLongSymbol(bits, entry);
 
-	uint8 length = _prefixTable[code].length;
+	bits.skip(entry->length);
+	return entry->value;
+}
 
-	if (length != 0xFF) {
-		bits.skip(length);
-		return _prefixTable[code].symbol;
-	} else {
-		bits.skip(_prefixTableBits);
+template <class BITSTREAM>
+uint32 Huffman<BITSTREAM>::getLongSymbol(BITSTREAM &bits, const TableEntry *entry) const {
+	const TableEntry *table = _table.data();
+	uint8 tableBits = kMaxTableBits;
 
-		for (uint32 i = 0; i < _codes.size(); i++) {
-			bits.addBit(code, i + _prefixTableBits);
+	while (entry->length & kSubTable) {
+		if (entry->length == kUnknownCode)
+			error("Unknown Huffman code");
 
-			for (typename CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-				if (code == cCode->code)
-					return cCode->symbol;
-		}
+		bits.skip(tableBits);
+		tableBits = entry->length & ~kSubTable;
+		entry = &table[entry->value + bits.peekBits(tableBits)];
 	}
 
-	error("Unknown Huffman code");
-	return 0;
+	bits.skip(entry->length);
+	return entry->value;
 }
 
 /** @} */
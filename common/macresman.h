@@ -208,6 +208,12 @@ public:
 	 */
 	static bool isMacBinary(SeekableReadStream &stream);
 
+	/**
+	 * Get the name of the AppleDouble file holding the resource fork of a file.
+	 * @param name The name of the file, possibly with a path
+	 */
+	static String constructAppleDoubleName(String name);
+
 	struct MacVers {
 		byte majorVer;
 		byte minorVer;
@@ -229,7 +235,6 @@ private:
 	bool loadFromRawFork(SeekableReadStream &stream);
 	bool loadFromAppleDouble(SeekableReadStream &stream);
 
-	static String constructAppleDoubleName(String name);
 	static String disassembleAppleDoubleName(String name, bool *isAppleDouble);
 
 	/**
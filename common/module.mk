@@ -51,6 +51,7 @@ MODULE_OBJS := \
 	winexe.o \
 	winexe_ne.o \
 	winexe_pe.o \
+	worker-pool.o \
 	xmlparser.o \
 	zlib.o
 
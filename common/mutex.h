@@ -25,6 +25,7 @@
 
 #include "common/scummsys.h"
 #include "common/system.h"
+#include "common/noncopyable.h"
 
 namespace Common {
 
@@ -70,6 +71,25 @@ public:
 	void unlock();
 };
 
+/**
+ * Wrapper class around the OSystem semaphore functions.
+ *
+ * Semaphores are only available on backends supporting threads, use
+ * isValid() to check.
+ */
+class Semaphore : NonCopyable {
+	OSystem::SemaphoreRef _semaphore;
+
+public:
+	explicit Semaphore(uint initialCount = 0);
+	~Semaphore();
+
+	bool isValid() const { return _semaphore != 0; }
+
+	void wait();
+	void signal();
+};
+
 /** @} */
 
 } // End of namespace Common
@@ -0,0 +1,138 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef COMMON_SPSC_QUEUE_H
+#define COMMON_SPSC_QUEUE_H
+
+#include "common/scummsys.h"
+#include "common/atomic.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_spsc_queue Single-producer/single-consumer queue
+ * @ingroup common
+ *
+ * @brief Fixed-size, lock-free queue for passing data between two threads.
+ *
+ * @{
+ */
+
+/**
+ * Bounded, wait-free ring buffer for exactly one producer thread and exactly
+ * one consumer thread. Neither side ever blocks: push() fails when the queue
+ * is full and pop() fails when it is empty.
+ *
+ * If several threads need to push (or pop), the caller has to serialize them,
+ * e.g. by only calling push() while holding a mutex.
+ *
+ * SIZE must be a power of two; the queue holds at most SIZE - 1 elements.
+ */
+template<class T, uint SIZE = 256>
+class SPSCQueue {
+public:
+	typedef uint size_type;
+
+	SPSCQueue() : _head(0), _tail(0) {
+		STATIC_ASSERT((SIZE & (SIZE - 1)) == 0 && SIZE >= 2, SPSCQueue_SIZE_must_be_a_power_of_two);
+	}
+
+	/**
+	 * Append an element. Must only be called by the producer.
+	 *
+	 * @return false if the queue is full.
+	 */
+	bool push(const T &x) {
+		const size_type tail = _tail;
+		const size_type next = (tail + 1) & (SIZE - 1);
+		if (next == atomicLoadAcquire(_head))
+			return false;
+
+		_storage[tail] = x;
+		atomicStoreRelease(_tail, next);
+		return true;
+	}
+
+	/**
+	 * Look at the oldest element without removing it. Must only be called by
+	 * the consumer.
+	 *
+	 * @return false if the queue is empty.
+	 */
+	bool peek(T &x) const {
+		const size_type head = _head;
+		if (head == atomicLoadAcquire(_tail))
+			return false;
+
+		x = _storage[head];
+		return true;
+	}
+
+	/**
+	 * Remove the oldest element. Must only be called by the consumer.
+	 *
+	 * @return false if the queue is empty.
+	 */
+	bool pop(T &x) {
+		if (!peek(x))
+			return false;
+
+		atomicStoreRelease(_head, (_head + 1) & (SIZE - 1));
+		return true;
+	}
+
+	/** Whether the queue is empty. Exact only when called by the consumer. */
+	bool empty() const {
+		return atomicLoadAcquire(_head) == atomicLoadAcquire(_tail);
+	}
+
+	/** Whether the queue is full. Exact only when called by the producer. */
+	bool full() const {
+		return ((_tail + 1) & (SIZE - 1)) == atomicLoadAcquire(_head);
+	}
+
+	/** Number of queued elements. Only an estimate while the other side is active. */
+	size_type size() const {
+		return (atomicLoadAcquire(_tail) - atomicLoadAcquire(_head)) & (SIZE - 1);
+	}
+
+	/** Maximum number of elements the queue can hold. */
+	size_type capacity() const {
+		return SIZE - 1;
+	}
+
+private:
+	// Disallow copying, a copy would not be thread safe anyway.
+	SPSCQueue(const SPSCQueue &);
+	SPSCQueue &operator=(const SPSCQueue &);
+
+	T _storage[SIZE];
+	size_type _head; ///< Next element to pop, written by the consumer only.
+	size_type _tail; ///< Next free slot, written by the producer only.
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -182,6 +182,10 @@ bool OSystem::setStretchMode(const char *name) {
 	return false;
 }
 
+uint64 OSystem::getMicros() {
+	return (uint64)getMillis(true) * 1000;
+}
+
 void OSystem::fatalError() {
 	quit();
 	exit(1);
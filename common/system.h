@@ -1357,6 +1357,15 @@ public:
 	 */
 	virtual uint32 getMillis(bool skipRecord = false) = 0;
 
+	/**
+	 * Get a number of microseconds, for measuring short durations such as
+	 * the time spent in a function. The starting point is unspecified, and
+	 * the value is not recorded by the event recorder.
+	 *
+	 * The default implementation only has the resolution of getMillis().
+	 */
+	virtual uint64 getMicros();
+
 	/** Delay/sleep for the specified amount of milliseconds. */
 	virtual void delayMillis(uint msecs) = 0;
 
@@ -1476,6 +1485,78 @@ public:
 
 	/** @} */
 
+	/**
+	 * @defgroup common_system_threads Worker threads
+	 * @ingroup common_system
+	 * @{
+	 *
+	 * Optional support for running work in parallel to the engine, see
+	 * Common::WorkerPool. Engines must not rely on it: backends which don't
+	 * provide threads keep the default implementations, and code using these
+	 * methods has to fall back to doing the work in the calling thread.
+	 */
+
+	typedef struct OpaqueThread *ThreadRef;
+	typedef struct OpaqueSemaphore *SemaphoreRef;
+	typedef void (*ThreadProc)(void *param);
+
+	/**
+	 * Start a new thread running the given function.
+	 *
+	 * @param proc  The function to run.
+	 * @param param Parameter passed to the function.
+	 *
+	 * @return The new thread, or 0 if threads are not supported or an
+	 *         error occurred.
+	 */
+	virtual ThreadRef createThread(ThreadProc proc, void *param) { return 0; }
+
+	/**
+	 * Wait for the given thread to finish and release it.
+	 *
+	 * @param thread The thread to wait for.
+	 */
+	virtual void joinThread(ThreadRef thread) {}
+
+	/**
+	 * Create a new counting semaphore.
+	 *
+	 * @param initialCount Initial value of the semaphore.
+	 *
+	 * @return The newly created semaphore, or 0 if threads are not supported
+	 *         or an error occurred.
+	 */
+	virtual SemaphoreRef createSemaphore(uint initialCount) { return 0; }
+
+	/**
+	 * Decrement the semaphore, waiting for it to become positive first.
+	 *
+	 * @param semaphore The semaphore to wait on.
+	 */
+	virtual void waitSemaphore(SemaphoreRef semaphore) {}
+
+	/**
+	 * Increment the semaphore, waking up one waiting thread.
+	 *
+	 * @param semaphore The semaphore to signal.
+	 */
+	virtual void signalSemaphore(SemaphoreRef semaphore) {}
+
+	/**
+	 * Delete the given semaphore. No thread may be waiting on it.
+	 *
+	 * @param semaphore The semaphore to delete.
+	 */
+	virtual void deleteSemaphore(SemaphoreRef semaphore) {}
+
+	/**
+	 * Return the number of CPU cores available to ScummVM, as a hint for how
+	 * many worker threads are worth starting.
+	 */
+	virtual uint getCPUCount() { return 1; }
+
+	/** @} */
+
 
 
 	/** @defgroup common_system_sound Sound
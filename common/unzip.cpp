@@ -109,6 +109,8 @@ typedef struct {
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
 
 #if defined(STRICTUNZIP) || defined(STRICTZIPUNZIP)
 /* like the STRICT of WIN32, we define a pointer that cannot be converted
@@ -382,6 +384,8 @@ typedef Common::HashMap<Common::String, cached_file_in_zip, Common::IgnoreCase_H
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _streamRef;	/* shared with streamed members */
+	Common::SharedPtr<Common::Mutex> _streamMutex;	/* held around each seek and read of the shared stream */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -600,6 +604,8 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		return nullptr;
 	}
 
+	us->_streamRef = Common::SharedPtr<Common::SeekableReadStream>(stream);
+	us->_streamMutex = Common::SharedPtr<Common::Mutex>(new Common::Mutex());
 	us->byte_before_the_zipfile = central_pos -
 		                    (us->offset_central_dir+us->size_central_dir);
 	us->central_pos = central_pos;
@@ -644,7 +650,7 @@ int unzClose(unzFile file) {
 	if (s->pfile_in_zip_read != nullptr)
 		unzCloseCurrentFile(file);
 
-	delete s->_stream;
+	// The stream itself is freed once no member stream uses it anymore
 	delete s;
 	return UNZ_OK;
 }
@@ -1125,6 +1131,28 @@ int unzOpenCurrentFile (unzFile file) {
 }
 
 
+/*
+  Get the position of the data of the current file within the zipfile stream,
+  without opening it for reading.
+*/
+static int unzlocal_GetCurrentFileDataPos(unz_s* s, uLong *pos) {
+	uInt iSizeVar;
+	uLong offset_local_extrafield;
+	uInt  size_local_extrafield;
+
+	if (!s->current_file_ok)
+		return UNZ_PARAMERROR;
+
+	if (unzlocal_CheckCurrentFileCoherencyHeader(s,&iSizeVar,
+				&offset_local_extrafield,&size_local_extrafield)!=UNZ_OK)
+		return UNZ_BADZIPFILE;
+
+	*pos = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar +
+		s->byte_before_the_zipfile;
+	return UNZ_OK;
+}
+
+
 /*
   Read bytes from the current file.
   buf contain buffer where data must be copied
@@ -1420,7 +1448,342 @@ int unzGetGlobalComment(unzFile file, char *szComment, uLong uSizeBuf) {
 namespace Common {
 
 
+/**
+ * A stored (uncompressed) ZIP member, read directly from the archive stream.
+ */
+class ZipStoredReadStream : public SeekableReadStream {
+	SharedPtr<SeekableReadStream> _zipStream;
+	SharedPtr<Mutex> _zipMutex;
+	uint32 _begin;
+	uint32 _size;
+	uint32 _pos;
+	bool _eos;
+	bool _err;
+
+public:
+	ZipStoredReadStream(const SharedPtr<SeekableReadStream> &zipStream, const SharedPtr<Mutex> &zipMutex, uint32 begin, uint32 size)
+		: _zipStream(zipStream), _zipMutex(zipMutex), _begin(begin), _size(size), _pos(0), _eos(false), _err(false) {
+	}
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize);
+
+	virtual bool eos() const { return _eos; }
+	virtual bool err() const { return _err; }
+	virtual void clearErr() { _eos = _err = false; }
+
+	virtual int64 pos() const { return _pos; }
+	virtual int64 size() const { return _size; }
+	virtual bool seek(int64 offset, int whence = SEEK_SET);
+};
+
+uint32 ZipStoredReadStream::read(void *dataPtr, uint32 dataSize) {
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+	if (dataSize == 0)
+		return 0;
+
+	// Other members, possibly on other threads, move the archive stream too
+	uint32 bytesRead;
+	{
+		StackLock lock(*_zipMutex);
+		if (!_zipStream->seek(_begin + _pos, SEEK_SET)) {
+			_err = true;
+			return 0;
+		}
+
+		bytesRead = _zipStream->read(dataPtr, dataSize);
+	}
+
+	if (bytesRead != dataSize)
+		_err = true;
+
+	_pos += bytesRead;
+	return bytesRead;
+}
+
+bool ZipStoredReadStream::seek(int64 offset, int whence) {
+	switch (whence) {
+	case SEEK_END:
+		offset = _size + offset;
+		break;
+	case SEEK_CUR:
+		offset = _pos + offset;
+		break;
+	case SEEK_SET:
+	default:
+		break;
+	}
+
+	if (offset < 0 || offset > _size)
+		return false;
+
+	_pos = offset;
+	_eos = false;
+	return true;
+}
+
+
+#ifdef USE_ZLIB
+
+/**
+ * A deflated ZIP member, decompressed on demand.
+ *
+ * Small reads are served from a window of decompressed data, large ones are
+ * decompressed straight into the caller's buffer. Every now and then a copy
+ * of the inflate state is kept as a checkpoint, so that seeking backwards
+ * only has to decompress from the nearest checkpoint instead of from the
+ * start of the member.
+ */
+class ZipInflateReadStream : public SeekableReadStream {
+	enum {
+		kInputSize = UNZ_BUFSIZE,
+		kWindowSize = 4096,
+		kCheckpointInterval = 256 * 1024,
+		kMaxCheckpoints = 16
+	};
+
+	struct Checkpoint {
+		uint32 outPos;
+		uint32 inPos;
+		uLong crc;
+		z_stream state;
+	};
+
+	SharedPtr<SeekableReadStream> _zipStream;
+	SharedPtr<Mutex> _zipMutex;
+	uint32 _begin;
+	uint32 _compressedSize;
+	uint32 _size;
+	uLong _expectedCrc;
+
+	z_stream _stream;
+	bool _initialized;
+	byte _input[kInputSize];
+	uint32 _inPos;     ///< Compressed bytes read into _input so far
+	uint32 _outPos;    ///< Bytes decompressed so far
+	uLong _crc;        ///< CRC of the first _outPos bytes
+
+	byte _window[kWindowSize];
+	uint32 _windowStart;
+	uint32 _windowFill;
+
+	Checkpoint _checkpoints[kMaxCheckpoints];
+	uint _numCheckpoints;
+	uint32 _checkpointInterval;
+
+	uint32 _pos;
+	bool _eos;
+	bool _err;
+
+	bool inflateNext(byte *dst, uint32 len);
+	bool restart(uint32 target);
+
+public:
+	ZipInflateReadStream(const SharedPtr<SeekableReadStream> &zipStream, const SharedPtr<Mutex> &zipMutex, uint32 begin, uint32 compressedSize, uint32 size, uLong crc);
+	~ZipInflateReadStream();
+
+	bool isValid() const { return _initialized; }
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize);
+
+	virtual bool eos() const { return _eos; }
+	virtual bool err() const { return _err; }
+	virtual void clearErr() { _eos = false; } // Decompression errors are not recoverable
+
+	virtual int64 pos() const { return _pos; }
+	virtual int64 size() const { return _size; }
+	virtual bool seek(int64 offset, int whence = SEEK_SET);
+};
+
+ZipInflateReadStream::ZipInflateReadStream(const SharedPtr<SeekableReadStream> &zipStream, const SharedPtr<Mutex> &zipMutex, uint32 begin, uint32 compressedSize, uint32 size, uLong crc)
+	: _zipStream(zipStream), _zipMutex(zipMutex), _begin(begin), _compressedSize(compressedSize), _size(size), _expectedCrc(crc),
+	  _stream(), _initialized(false), _inPos(0), _outPos(0), _crc(0), _windowStart(0), _windowFill(0),
+	  _numCheckpoints(0), _pos(0), _eos(false), _err(false) {
+
+	// Spread the checkpoints over large members
+	_checkpointInterval = MAX<uint32>(kCheckpointInterval, size / kMaxCheckpoints + 1);
+
+	// Raw deflate data, see unzOpenCurrentFile()
+	_initialized = (inflateInit2(&_stream, -MAX_WBITS) == Z_OK);
+	_crc = crc32(0, nullptr, 0);
+}
+
+ZipInflateReadStream::~ZipInflateReadStream() {
+	for (uint i = 0; i < _numCheckpoints; ++i)
+		inflateEnd(&_checkpoints[i].state);
+	if (_initialized)
+		inflateEnd(&_stream);
+}
+
+bool ZipInflateReadStream::inflateNext(byte *dst, uint32 len) {
+	_stream.next_out = dst;
+	_stream.avail_out = len;
+
+	while (_stream.avail_out > 0) {
+		if (_stream.avail_in == 0) {
+			uint32 inputSize = MIN<uint32>(kInputSize, _compressedSize - _inPos);
+			if (inputSize == 0)
+				return false;
+
+			{
+				StackLock lock(*_zipMutex);
+				if (!_zipStream->seek(_begin + _inPos, SEEK_SET) ||
+				    _zipStream->read(_input, inputSize) != inputSize)
+					return false;
+			}
+
+			_inPos += inputSize;
+			_stream.next_in = _input;
+			_stream.avail_in = inputSize;
+		}
+
+		int zlibErr = inflate(&_stream, Z_SYNC_FLUSH);
+		if (zlibErr == Z_STREAM_END)
+			break;
+		if (zlibErr != Z_OK)
+			return false;
+	}
+
+	if (_stream.avail_out > 0)
+		return false;
+
+	_crc = crc32(_crc, dst, len);
+	_outPos += len;
+
+	if (_outPos == _size && _crc != _expectedCrc) {
+		warning("ZipInflateReadStream: CRC mismatch");
+		return false;
+	}
+
+	const uint32 nextCheckpoint = (_numCheckpoints + 1) * _checkpointInterval;
+	if (_numCheckpoints < kMaxCheckpoints && _outPos >= nextCheckpoint && _outPos < _size) {
+		Checkpoint &checkpoint = _checkpoints[_numCheckpoints];
+		if (inflateCopy(&checkpoint.state, &_stream) == Z_OK) {
+			checkpoint.outPos = _outPos;
+			checkpoint.inPos = _inPos - _stream.avail_in;
+			checkpoint.crc = _crc;
+			++_numCheckpoints;
+		}
+	}
+
+	return true;
+}
+
+bool ZipInflateReadStream::restart(uint32 target) {
+	int checkpoint = -1;
+	for (uint i = 0; i < _numCheckpoints && _checkpoints[i].outPos <= target; ++i)
+		checkpoint = i;
+
+	// Carry on from the current position if no checkpoint is closer
+	const uint32 checkpointPos = (checkpoint < 0) ? 0 : _checkpoints[checkpoint].outPos;
+	if (checkpointPos <= _outPos && _outPos <= target)
+		return true;
+
+	if (checkpoint < 0) {
+		if (inflateReset(&_stream) != Z_OK)
+			return false;
+		_inPos = 0;
+		_outPos = 0;
+		_crc = crc32(0, nullptr, 0);
+	} else {
+		const Checkpoint &cp = _checkpoints[checkpoint];
+		inflateEnd(&_stream);
+		if (inflateCopy(&_stream, const_cast<z_stream *>(&cp.state)) != Z_OK) {
+			_initialized = false;
+			return false;
+		}
+		_inPos = cp.inPos;
+		_outPos = cp.outPos;
+		_crc = cp.crc;
+	}
+
+	// The copied state may still point into the input buffer, but its
+	// contents are gone
+	_stream.next_in = _input;
+	_stream.avail_in = 0;
+	return true;
+}
+
+uint32 ZipInflateReadStream::read(void *dataPtr, uint32 dataSize) {
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	byte *dst = (byte *)dataPtr;
+	uint32 bytesRead = 0;
+
+	while (bytesRead < dataSize && !_err) {
+		const uint32 remaining = dataSize - bytesRead;
+
+		if (_pos >= _windowStart && _pos < _windowStart + _windowFill) {
+			const uint32 count = MIN(remaining, _windowStart + _windowFill - _pos);
+			memcpy(dst + bytesRead, _window + (_pos - _windowStart), count);
+			bytesRead += count;
+			_pos += count;
+			continue;
+		}
+
+		// Move to the nearest checkpoint when seeking backwards or far ahead
+		if ((_pos < _outPos || _pos - _outPos >= _checkpointInterval) && !restart(_pos)) {
+			_err = true;
+			break;
+		}
+
+		if (_pos == _outPos && remaining >= kWindowSize) {
+			if (!inflateNext(dst + bytesRead, remaining)) {
+				_err = true;
+				break;
+			}
+			bytesRead += remaining;
+			_pos += remaining;
+		} else {
+			_windowStart = _outPos;
+			_windowFill = 0;
+			const uint32 count = MIN<uint32>(kWindowSize, _size - _outPos);
+			if (!inflateNext(_window, count)) {
+				_err = true;
+				break;
+			}
+			_windowFill = count;
+		}
+	}
+
+	return bytesRead;
+}
+
+bool ZipInflateReadStream::seek(int64 offset, int whence) {
+	switch (whence) {
+	case SEEK_END:
+		offset = _size + offset;
+		break;
+	case SEEK_CUR:
+		offset = _pos + offset;
+		break;
+	case SEEK_SET:
+	default:
+		break;
+	}
+
+	if (offset < 0 || offset > _size)
+		return false;
+
+	// Decompression is deferred until the next read
+	_pos = offset;
+	_eos = false;
+	return true;
+}
+
+#endif // USE_ZLIB
+
+
 class ZipArchive : public Archive {
+	enum {
+		kZipStreamingThreshold = 64 * 1024 ///< Deflated members up to this size are decompressed at once
+	};
+
 	unzFile _zipFile;
 
 public:
@@ -1458,10 +1821,14 @@ ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile) {
 }
 
 ZipArchive::~ZipArchive() {
+	// Member streams may still be reading from the archive stream
+	Common::SharedPtr<Mutex> mutex = ((unz_s *)_zipFile)->_streamMutex;
+	StackLock lock(*mutex);
 	unzClose(_zipFile);
 }
 
 bool ZipArchive::hasFile(const String &name) const {
+	StackLock lock(*((const unz_s *)_zipFile)->_streamMutex);
 	return (unzLocateFile(_zipFile, name.c_str(), 2) == UNZ_OK);
 }
 
@@ -1486,14 +1853,39 @@ const ArchiveMemberPtr ZipArchive::getMember(const String &name) const {
 }
 
 SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) const {
+	// Member streams, possibly on other threads, share the archive stream
+	StackLock lock(*((const unz_s *)_zipFile)->_streamMutex);
+
 	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
 		return nullptr;
 
-	unz_file_info fileInfo;
-	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
+	unz_s *archive = (unz_s *)_zipFile;
+	const unz_file_info &fileInfo = archive->cur_file_info;
+
+	uLong dataPos;
+	if (unzlocal_GetCurrentFileDataPos(archive, &dataPos) != UNZ_OK)
 		return nullptr;
 
-	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
+	// Members share the archive stream, which stays alive for as long as
+	// any of them does. Stored members are read from it directly.
+	if (fileInfo.compression_method == 0)
+		return new ZipStoredReadStream(archive->_streamRef, archive->_streamMutex, dataPos, fileInfo.uncompressed_size);
+
+#ifdef USE_ZLIB
+	// For small members, the inflate state would take more memory than
+	// decompressing them at once
+	if (fileInfo.uncompressed_size > kZipStreamingThreshold) {
+		ZipInflateReadStream *stream = new ZipInflateReadStream(archive->_streamRef, archive->_streamMutex, dataPos,
+			fileInfo.compressed_size, fileInfo.uncompressed_size, fileInfo.crc);
+		if (stream->isValid())
+			return stream;
+
+		delete stream;
+		return nullptr;
+	}
+#endif
+
+	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
 		return nullptr;
 
 	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
@@ -1510,11 +1902,6 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 	}
 
 	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
-
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
 }
 
 Archive *makeZipArchive(const String &name) {
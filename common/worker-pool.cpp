@@ -0,0 +1,139 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "common/worker-pool.h"
+#include "common/str.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Common {
+
+WorkerPool::WorkerPool(uint numThreads) : _unfinishedJobs(0), _waiting(0), _quit(false) {
+	if (!_jobAvailable.isValid() || !_allFinished.isValid())
+		return;
+
+	// Pools may be started before the backend is initialized, for instance
+	// when detecting games from the command line
+	if (numThreads > 0)
+		String::createMemoryPoolMutex();
+
+	for (uint i = 0; i < numThreads; ++i) {
+		OSystem::ThreadRef thread = g_system->createThread(threadProc, this);
+		if (!thread) {
+			warning("WorkerPool: Could only start %d of %d threads", i, numThreads);
+			break;
+		}
+		_threads.push_back(thread);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	wait();
+
+	_mutex.lock();
+	_quit = true;
+	_mutex.unlock();
+
+	for (uint i = 0; i < _threads.size(); ++i)
+		_jobAvailable.signal();
+	for (uint i = 0; i < _threads.size(); ++i)
+		g_system->joinThread(_threads[i]);
+}
+
+uint WorkerPool::getDefaultThreadCount(uint max) {
+	const uint cpus = g_system->getCPUCount();
+	return MIN<uint>(cpus > 1 ? cpus - 1 : 0, max);
+}
+
+void WorkerPool::addJob(WorkerJob *job) {
+	if (_threads.empty()) {
+		job->run();
+		return;
+	}
+
+	_mutex.lock();
+	_jobs.push(job);
+	++_unfinishedJobs;
+	_mutex.unlock();
+
+	_jobAvailable.signal();
+}
+
+void WorkerPool::wait() {
+	if (_threads.empty())
+		return;
+
+	// Rather than sleeping, lend a hand with the jobs nobody picked up yet
+	while (WorkerJob *job = takeJob()) {
+		job->run();
+		finishJob();
+	}
+
+	_mutex.lock();
+	if (_unfinishedJobs == 0) {
+		_mutex.unlock();
+		return;
+	}
+	++_waiting;
+	_mutex.unlock();
+
+	_allFinished.wait();
+}
+
+void WorkerPool::threadProc(void *param) {
+	WorkerPool *pool = (WorkerPool *)param;
+
+	while (true) {
+		pool->_jobAvailable.wait();
+
+		WorkerJob *job = pool->takeJob();
+		if (job) {
+			job->run();
+			pool->finishJob();
+			continue;
+		}
+
+		// Either another thread took the job, or the pool is shutting down
+		StackLock lock(pool->_mutex);
+		if (pool->_quit)
+			return;
+	}
+}
+
+WorkerJob *WorkerPool::takeJob() {
+	StackLock lock(_mutex);
+	if (_jobs.empty())
+		return nullptr;
+	return _jobs.pop();
+}
+
+void WorkerPool::finishJob() {
+	StackLock lock(_mutex);
+	assert(_unfinishedJobs > 0);
+	if (--_unfinishedJobs == 0) {
+		for (; _waiting > 0; --_waiting)
+			_allFinished.signal();
+	}
+}
+
+} // End of namespace Common
@@ -0,0 +1,118 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef COMMON_WORKER_POOL_H
+#define COMMON_WORKER_POOL_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/noncopyable.h"
+#include "common/queue.h"
+#include "common/system.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_worker_pool Worker pool
+ * @ingroup common
+ *
+ * @brief Run jobs on a set of worker threads.
+ * @{
+ */
+
+/**
+ * A unit of work which can be queued on a WorkerPool.
+ *
+ * The pool does not take ownership of jobs, the caller has to keep a job
+ * alive until it has finished running.
+ */
+class WorkerJob {
+public:
+	virtual ~WorkerJob() {}
+
+	/** Do the work. Called on a worker thread or in the thread adding the job. */
+	virtual void run() = 0;
+};
+
+/**
+ * A fixed set of worker threads processing queued jobs in FIFO order.
+ *
+ * Threads are optional: if the backend cannot create any, or the pool was
+ * created with zero threads, addJob() runs each job right away in the
+ * calling thread. Code using a pool therefore behaves the same on every
+ * backend, it only gets faster where threads are available.
+ */
+class WorkerPool : NonCopyable {
+public:
+	/**
+	 * Start a pool with the given number of threads.
+	 *
+	 * @see getDefaultThreadCount()
+	 */
+	explicit WorkerPool(uint numThreads);
+
+	/** Finish all queued jobs and stop the worker threads. */
+	~WorkerPool();
+
+	/**
+	 * Return a sensible thread count for a pool whose jobs keep the calling
+	 * thread waiting: one thread per additional CPU core, capped to @p max.
+	 */
+	static uint getDefaultThreadCount(uint max);
+
+	/** Return the number of worker threads which could be started. */
+	uint getThreadCount() const { return _threads.size(); }
+
+	/** Queue a job, or run it immediately if the pool has no threads. */
+	void addJob(WorkerJob *job);
+
+	/**
+	 * Wait until all jobs added so far have finished. The calling thread
+	 * helps processing the queue while waiting.
+	 */
+	void wait();
+
+private:
+	static void threadProc(void *param);
+
+	WorkerJob *takeJob();
+	void finishJob();
+
+	Array<OSystem::ThreadRef> _threads;
+
+	Mutex _mutex;
+	Queue<WorkerJob *> _jobs;
+	uint _unfinishedJobs;
+	uint _waiting;
+	bool _quit;
+
+	Semaphore _jobAvailable;
+	Semaphore _allFinished;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
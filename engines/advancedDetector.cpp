@@ -20,6 +20,8 @@
  *
  */
 
+#include "common/algorithm.h"
+#include "common/atomic.h"
 #include "common/debug.h"
 #include "common/util.h"
 #include "common/file.h"
@@ -223,7 +225,7 @@ bool AdvancedMetaEngineDetection::cleanupPirated(ADDetectedGames &matched) const
 		// We ruled out all variants and now have nothing
 		if (matched.empty()) {
 			warning("Illegitimate game copy detected. We provide no support in such cases");
-			if (GUI::GuiManager::hasInstance()) {
+			if (GUI::GuiManager::hasInstance() && !EngineMan.isDetectingInParallel()) {
 				GUI::MessageDialog dialog(_("Illegitimate game copy detected. We provide no support in such cases"));
 				dialog.runModal();
 			};
@@ -266,6 +268,9 @@ DetectedGames AdvancedMetaEngineDetection::detectGames(const Common::FSList &fsl
 	}
 
 	if (!foundKnownGames) {
+		// Fallback detectors are free to use global state
+		DetectionLock lock;
+
 		// Use fallback detector if there were no matches by other means
 		ADDetectedGameExtraInfo *extraInfo = nullptr;
 		ADDetectedGame fallbackDetectionResult = fallbackDetect(allFiles, fslist, &extraInfo);
@@ -360,6 +365,7 @@ Common::Error AdvancedMetaEngineDetection::createInstance(OSystem *syst, Engine
 
 	// Run the detector on this
 	ADDetectedGames matches = detectGame(files.begin()->getParent(), allFiles, language, platform, extra);
+	MD5Man.savePersistent(false);
 
 	if (cleanupPirated(matches))
 		return Common::kNoGameDataFoundError;
@@ -479,18 +485,222 @@ namespace Common {
 	DECLARE_SINGLETON(MD5CacheManager);
 }
 
+/** File in the config directory holding the persistent MD5 cache */
+static const char *const kMD5CacheFileName = "scummvm-md5cache.dat";
+/** First line of the persistent MD5 cache, to be changed along with its format */
+static const char *const kMD5CacheHeader = "ScummVM MD5 cache 2";
+/** Minimum time between writes of the persistent MD5 cache, in ms */
+static const uint32 kMD5CacheSaveInterval = 5000;
+/** Maximum number of entries in the persistent MD5 cache, about 1.5 MB */
+static const uint kMD5CacheMaxEntries = 10000;
+
+static Common::FSNode getMD5CacheFile() {
+	Common::String configFile = ConfMan.getCustomConfigFileName();
+	if (configFile.empty())
+		configFile = g_system->getDefaultConfigFileName();
+
+	return Common::FSNode(configFile).getParent().getChild(kMD5CacheFileName);
+}
+
+bool MD5CacheManager::getPersistent(const Common::String &key, const Common::String &stamp, Common::String &md5, int64 &size) {
+	DetectionLock lock(mutex);
+	loadPersistent();
+
+	PersistentHashMap::iterator i = persistentHashMap.find(key);
+	if (i == persistentHashMap.end() || i->_value.stamp != stamp)
+		return false;
+
+	// Using an entry alone doesn't make the cache worth writing again. It
+	// is remembered for when new entries are written.
+	i->_value.lastRun = persistentRun;
+
+	md5 = Common::String(i->_value.md5.c_str());
+	size = i->_value.size;
+	return true;
+}
+
+void MD5CacheManager::setPersistent(const Common::String &key, const Common::String &stamp, const Common::String &md5, int64 size) {
+	DetectionLock lock(mutex);
+	loadPersistent();
+
+	PersistentEntry &entry = persistentHashMap[Common::String(key.c_str())];
+	entry.stamp = Common::String(stamp.c_str());
+	entry.md5 = Common::String(md5.c_str());
+	entry.size = size;
+	entry.lastRun = persistentRun;
+	persistentDirty = true;
+}
+
+void MD5CacheManager::loadPersistent() {
+	if (persistentLoaded)
+		return;
+	persistentLoaded = true;
+
+	Common::FSNode file = getMD5CacheFile();
+	if (!file.exists())
+		return;
+
+	Common::SeekableReadStream *stream = file.createReadStream();
+	if (!stream)
+		return;
+
+	// The header is followed by the number of the last run which wrote the
+	// file. Each line after it has the MD5, size, last run, stamp and key of
+	// a file, separated by tabs. Keys come last as they are paths, which
+	// may contain anything.
+	if (stream->readLine() == kMD5CacheHeader) {
+		persistentRun = stream->readLine().asUint64() + 1;
+
+		while (!stream->eos() && !stream->err()) {
+			Common::String line = stream->readLine();
+			size_t sizeStart = line.findFirstOf('\t');
+			size_t runStart = line.findFirstOf('\t', sizeStart + 1);
+			size_t stampStart = line.findFirstOf('\t', runStart + 1);
+			size_t keyStart = line.findFirstOf('\t', stampStart + 1);
+			if (sizeStart == Common::String::npos || runStart == Common::String::npos ||
+				stampStart == Common::String::npos || keyStart == Common::String::npos)
+				continue;
+
+			PersistentEntry &entry = persistentHashMap[line.substr(keyStart + 1)];
+			entry.md5 = line.substr(0, sizeStart);
+			entry.size = line.substr(sizeStart + 1, runStart - sizeStart - 1).asUint64();
+			entry.lastRun = line.substr(runStart + 1, stampStart - runStart - 1).asUint64();
+			entry.stamp = line.substr(stampStart + 1, keyStart - stampStart - 1);
+		}
+	} else {
+		warning("MD5CacheManager: Ignoring '%s' with an unknown format", file.getPath().c_str());
+	}
+
+	delete stream;
+}
+
+void MD5CacheManager::savePersistent(bool force) {
+	DetectionLock lock(mutex);
+	if (!persistentDirty)
+		return;
+
+	const uint32 time = g_system->getMillis();
+	if (!force && time - lastPersistentSave < kMD5CacheSaveInterval)
+		return;
+
+	prunePersistent();
+
+	Common::FSNode file = getMD5CacheFile();
+	Common::WriteStream *stream = file.createWriteStream();
+	if (!stream) {
+		warning("MD5CacheManager: Unable to write '%s'", file.getPath().c_str());
+		persistentDirty = false;
+		return;
+	}
+
+	stream->writeString(kMD5CacheHeader);
+	stream->writeString(Common::String::format("\n%u\n", persistentRun));
+	for (PersistentHashMap::const_iterator i = persistentHashMap.begin(); i != persistentHashMap.end(); ++i) {
+		stream->writeString(Common::String::format("%s\t%lld\t%u\t%s\t%s\n", i->_value.md5.c_str(), (long long)i->_value.size,
+			i->_value.lastRun, i->_value.stamp.c_str(), i->_key.c_str()));
+	}
+	stream->finalize();
+	delete stream;
+
+	persistentDirty = false;
+	lastPersistentSave = time;
+}
+
+void MD5CacheManager::prunePersistent() {
+	if (persistentHashMap.size() <= kMD5CacheMaxEntries)
+		return;
+
+	// Keep the entries used in the most recent runs. The oldest run kept
+	// may lose some of its entries.
+	Common::Array<uint32> runs;
+	runs.reserve(persistentHashMap.size());
+	for (PersistentHashMap::const_iterator i = persistentHashMap.begin(); i != persistentHashMap.end(); ++i)
+		runs.push_back(i->_value.lastRun);
+	Common::sort(runs.begin(), runs.end());
+	const uint32 oldestRun = runs[runs.size() - kMD5CacheMaxEntries];
+
+	uint excess = persistentHashMap.size() - kMD5CacheMaxEntries;
+	for (PersistentHashMap::iterator i = persistentHashMap.begin(); i != persistentHashMap.end(); ++i) {
+		if (i->_value.lastRun < oldestRun || (i->_value.lastRun == oldestRun && excess)) {
+			persistentHashMap.erase(i);
+			--excess;
+		}
+	}
+}
+
+/** The files MacResManager::open() looks at for a file with a resource fork */
+static uint getResForkNames(const Common::String &fname, bool resFork, Common::String (&names)[4]) {
+	uint count = 0;
+	names[count++] = fname;
+	if (resFork) {
+		names[count++] = fname + ".rsrc";
+		names[count++] = Common::MacResManager::constructAppleDoubleName(fname);
+		names[count++] = fname + ".bin";
+	}
+	return count;
+}
+
+bool AdvancedMetaEngineDetection::getFileKey(const FileMap &allFiles, const Common::String &fname, bool resFork, uint md5Bytes, Common::String &key) {
+	Common::String names[4];
+	const uint count = getResForkNames(fname, resFork, names);
+
+	for (uint i = 0; i < count; i++) {
+		if (allFiles.contains(names[i])) {
+			key = Common::String::format("%s:%d%s", allFiles[names[i]].getPath().c_str(), md5Bytes, resFork ? ":rsrc" : "");
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool AdvancedMetaEngineDetection::getFileStamp(const FileMap &allFiles, const Common::String &fname, bool resFork, Common::String &stamp) {
+	Common::String names[4];
+	const uint count = getResForkNames(fname, resFork, names);
+
+	stamp.clear();
+	for (uint i = 0; i < count; i++) {
+		if (!allFiles.contains(names[i]))
+			continue;
+
+		int64 size, modificationTime;
+		if (!allFiles[names[i]].getFileStats(size, modificationTime))
+			return false;
+
+		stamp += Common::String::format("%s%d:%lld:%lld", stamp.empty() ? "" : ",", i, (long long)size, (long long)modificationTime);
+	}
+
+	return !stamp.empty();
+}
+
 bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, FileProperties &fileProps) const {
 	// FIXME/TODO: We don't handle the case that a file is listed as a regular
 	// file and as one with resource fork.
-	Common::String hashname = Common::String::format("%s:%d", fname.c_str(), _md5Bytes);
+	const bool resFork = game.flags & ADGF_MACRESFORK;
+	if (!resFork && !allFiles.contains(fname))
+		return false;
 
-	if (MD5Man.contains(hashname)) {
-		fileProps.md5 = MD5Man.getMD5(hashname);
-		fileProps.size = MD5Man.getSize(hashname);
+	Common::String key;
+	if (!getFileKey(allFiles, fname, resFork, _md5Bytes, key))
+		return false;
+
+	if (MD5Man.contains(key)) {
+		fileProps.md5 = MD5Man.getMD5(key);
+		fileProps.size = MD5Man.getSize(key);
 		return true;
 	}
 
-	if (game.flags & ADGF_MACRESFORK) {
+	// Files which didn't change since a previous run don't need to be read again
+	Common::String stamp;
+	const bool persistent = getFileStamp(allFiles, fname, resFork, stamp);
+
+	if (persistent && MD5Man.getPersistent(key, stamp, fileProps.md5, fileProps.size)) {
+		MD5Man.setMD5(key, fileProps.md5);
+		MD5Man.setSize(key, fileProps.size);
+		return true;
+	}
+
+	if (resFork) {
 		FileMapArchive fileMapArchive(allFiles);
 
 		Common::MacResManager macResMan;
@@ -502,8 +712,10 @@ bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, con
 		fileProps.size = macResMan.getResForkDataSize();
 
 		if (fileProps.size != 0) {
-			MD5Man.setMD5(hashname, fileProps.md5);
-			MD5Man.setSize(hashname, fileProps.size);
+			MD5Man.setMD5(key, fileProps.md5);
+			MD5Man.setSize(key, fileProps.size);
+			if (persistent)
+				MD5Man.setPersistent(key, stamp, fileProps.md5, fileProps.size);
 			return true;
 		}
 	}
@@ -518,8 +730,10 @@ bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, con
 
 	fileProps.md5 = Common::computeStreamMD5AsString(testFile, _md5Bytes);
 	fileProps.size = testFile.size();
-	MD5Man.setMD5(hashname, fileProps.md5);
-	MD5Man.setSize(hashname, fileProps.size);
+	MD5Man.setMD5(key, fileProps.md5);
+	MD5Man.setSize(key, fileProps.size);
+	if (persistent)
+		MD5Man.setPersistent(key, stamp, fileProps.md5, fileProps.size);
 
 	return true;
 }
@@ -568,24 +782,18 @@ ADDetectedGames AdvancedMetaEngineDetection::detectGame(const Common::FSNode &pa
 
 	// Check which files are included in some ADGameDescription *and* whether
 	// they are present. Compute MD5s and file sizes for the available files.
-	for (descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
-		g = (const ADGameDescription *)descPtr;
+	const Common::Array<DetectionFile> &detectionFiles = getDetectionFiles();
+	for (uint f = 0; f < detectionFiles.size(); f++) {
+		Common::String fname = detectionFiles[f].fileName;
 
-		for (fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
-			Common::String fname = fileDesc->fileName;
-
-			if (filesProps.contains(fname))
-				continue;
-
-			FileProperties tmp;
-			if (getFileProperties(allFiles, *g, fname, tmp)) {
-				debugC(3, kDebugGlobalDetection, "> '%s': '%s'", fname.c_str(), tmp.md5.c_str());
-			}
-
-			// Both positive and negative results are cached to avoid
-			// repeatedly checking for files.
-			filesProps[fname] = tmp;
+		FileProperties tmp;
+		if (getFileProperties(allFiles, *detectionFiles[f].game, fname, tmp)) {
+			debugC(3, kDebugGlobalDetection, "> '%s': '%s'", fname.c_str(), tmp.md5.c_str());
 		}
+
+		// Both positive and negative results are cached to avoid
+		// repeatedly checking for files.
+		filesProps[fname] = tmp;
 	}
 
 	int maxFilesMatched = 0;
@@ -607,6 +815,19 @@ ADDetectedGames AdvancedMetaEngineDetection::detectGame(const Common::FSNode &pa
 		if ((_flags & kADFlagUseExtraAsHint) && !extra.empty() && g->extra != extra)
 			continue;
 
+		// Most games lack some of their files in any given directory, so
+		// check for them before setting up a match
+		for (fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
+			FilePropertiesMap::const_iterator props = filesProps.find(fileDesc->fileName);
+			if (props == filesProps.end() || props->_value.size == -1)
+				break;
+		}
+		if (fileDesc->fileName) {
+			debugC(5, kDebugGlobalDetection, "Skipping game: %s (%s %s/%s) (%d)", g->gameId, g->extra,
+			 getPlatformDescription(g->platform), getLanguageDescription(g->language), i);
+			continue;
+		}
+
 		ADDetectedGame game(g);
 		bool allFilesPresent = true;
 		int curFilesMatched = 0;
@@ -681,6 +902,34 @@ ADDetectedGames AdvancedMetaEngineDetection::detectGame(const Common::FSNode &pa
 	return matched;
 }
 
+const Common::Array<AdvancedMetaEngineDetection::DetectionFile> &AdvancedMetaEngineDetection::getDetectionFiles() const {
+	if (Common::atomicLoadAcquire(_detectionFilesReady))
+		return _detectionFiles;
+
+	// Several directories may be detected at once
+	DetectionLock lock;
+	if (_detectionFilesReady)
+		return _detectionFiles;
+
+	Common::HashMap<Common::String, bool, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> seen;
+	for (const byte *descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
+		const ADGameDescription *g = (const ADGameDescription *)descPtr;
+
+		for (const ADGameFileDescription *fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
+			bool &known = seen[fileDesc->fileName];
+			if (known)
+				continue;
+
+			known = true;
+			DetectionFile file = { fileDesc->fileName, g };
+			_detectionFiles.push_back(file);
+		}
+	}
+
+	Common::atomicStoreRelease(_detectionFilesReady, true);
+	return _detectionFiles;
+}
+
 ADDetectedGame AdvancedMetaEngineDetection::detectGameFilebased(const FileMap &allFiles, const ADFileBasedFallback *fileBasedFallback) const {
 	const ADFileBasedFallback *ptr;
 	const char* const* filenames;
@@ -745,7 +994,7 @@ PlainGameDescriptor AdvancedMetaEngineDetection::findGame(const char *gameId) co
 
 AdvancedMetaEngineDetection::AdvancedMetaEngineDetection(const void *descs, uint descItemSize, const PlainGameDescriptor *gameIds, const ADExtraGuiOptionsMap *extraGuiOptions)
 	: _gameDescriptors((const byte *)descs), _descItemSize(descItemSize), _gameIds(gameIds),
-	  _extraGuiOptions(extraGuiOptions) {
+	  _extraGuiOptions(extraGuiOptions), _detectionFilesReady(false) {
 
 	_md5Bytes = 5000;
 	_flags = 0;
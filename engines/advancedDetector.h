@@ -27,6 +27,7 @@
 #include "engines/engine.h"
 
 #include "common/hash-str.h"
+#include "common/mutex.h"
 
 #include "common/gui_options.h" // FIXME: Temporary hack?
 
@@ -352,6 +353,15 @@ public:
 	 */
 	DetectedGames detectGames(const Common::FSList &fslist) const override;
 
+	/**
+	 * The tables are only read during detection, and fallbackDetect() is
+	 * called holding a DetectionLock. Subclasses which
+	 * override detectGames() need to check whether this still holds.
+	 */
+	bool isDetectionThreadSafe() const override {
+		return true;
+	}
+
 	/**
 	 * A generic createInstance.
 	 *
@@ -393,6 +403,21 @@ protected:
 private:
 	void initSubSystems(const ADGameDescription *gameDesc) const;
 
+	/** A file name used by the game descriptions, with the first game which lists it. */
+	struct DetectionFile {
+		const char *fileName;
+		const ADGameDescription *game;
+	};
+
+	/**
+	 * The distinct file names used by the game descriptions. They are the
+	 * same for every directory, so they are only collected once.
+	 */
+	const Common::Array<DetectionFile> &getDetectionFiles() const;
+
+	mutable Common::Array<DetectionFile> _detectionFiles;
+	mutable bool _detectionFilesReady;
+
 protected:
 	/**
 	 * Detect games in the specified directory.
@@ -439,6 +464,23 @@ protected:
 	/** Get the properties (size and MD5) of this file. */
 	bool getFileProperties(const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, FileProperties &fileProps) const;
 
+	/**
+	 * Identify the data this file is detected from, for the MD5 cache. The
+	 * key contains the full path of the file, so that directories detected
+	 * at the same time don't mix up their files.
+	 *
+	 * @return False if neither the file nor its resource fork exist.
+	 */
+	static bool getFileKey(const FileMap &allFiles, const Common::String &fname, bool resFork, uint md5Bytes, Common::String &key);
+
+	/**
+	 * Get the sizes and modification times of this file and of its resource
+	 * fork, if any, for the persistent MD5 cache.
+	 *
+	 * @return False if the file system cannot provide them.
+	 */
+	static bool getFileStamp(const FileMap &allFiles, const Common::String &fname, bool resFork, Common::String &stamp);
+
 	/** Convert an AD game description into the shared game description format. */
 	virtual DetectedGame toDetectedGame(const ADDetectedGame &adGame, ADDetectedGameExtraInfo *extraInfo = nullptr) const;
 
@@ -511,34 +553,78 @@ public:
 
 /**
  * Singleton Cache Storage for Computed MD5s
+ *
+ * Several directories may be detected at the same time, in different
+ * threads, so accesses are locked once enableLocking() was called, and
+ * strings are copied in full rather than shared between threads.
  */
 class MD5CacheManager : public Common::Singleton<MD5CacheManager> {
 public:
 	void setMD5(Common::String fname, Common::String md5) {
-		md5HashMap.setVal(fname, md5);
+		DetectionLock lock(mutex);
+		md5HashMap.setVal(Common::String(fname.c_str()), Common::String(md5.c_str()));
 	}
 
 	Common::String getMD5(Common::String fname) {
-		return md5HashMap.getVal(fname);
+		DetectionLock lock(mutex);
+		return Common::String(md5HashMap.getVal(fname).c_str());
 	}
 
 	void setSize(Common::String fname, int64 size) {
-		sizeHashMap.setVal(fname, size);
+		DetectionLock lock(mutex);
+		sizeHashMap.setVal(Common::String(fname.c_str()), size);
 	}
 
 	int64 getSize(Common::String fname) {
+		DetectionLock lock(mutex);
 		return sizeHashMap.getVal(fname);
 	}
 
 	bool contains(Common::String fname) {
+		DetectionLock lock(mutex);
 		return (md5HashMap.contains(fname) && sizeHashMap.contains(fname));
 	}
 
-	MD5CacheManager() {
+	/**
+	 * Look up a file in the persistent cache, which survives clear() and is
+	 * kept in the config directory between runs.
+	 *
+	 * @param key    Identifies the file, typically its path.
+	 * @param stamp  The sizes and modification times of the file. The entry
+	 *               is only used if they didn't change since it was stored.
+	 */
+	bool getPersistent(const Common::String &key, const Common::String &stamp, Common::String &md5, int64 &size);
+
+	/** Store a file in the persistent cache, see getPersistent(). */
+	void setPersistent(const Common::String &key, const Common::String &stamp, const Common::String &md5, int64 size);
+
+	/**
+	 * Write the persistent cache to the config directory if it gained or
+	 * changed entries. To keep scanning large collections fast, it is
+	 * written at most every few seconds, unless @p force is set. Only the
+	 * most recently used entries are kept, up to a fixed number.
+	 */
+	void savePersistent(bool force);
+
+	MD5CacheManager() : mutex(nullptr), persistentLoaded(false), persistentDirty(false), lastPersistentSave(0), persistentRun(0) {
 		clear();
 	}
 
+	~MD5CacheManager() {
+		delete mutex;
+	}
+
+	/**
+	 * Make the cache safe to use from several threads. Called before games
+	 * are detected in parallel, see DetectionLock.
+	 */
+	void enableLocking() {
+		if (!mutex)
+			mutex = new Common::Mutex();
+	}
+
 	void clear() {
+		DetectionLock lock(mutex);
 		md5HashMap.clear(true);
 		sizeHashMap.clear(true);
 	}
@@ -546,10 +632,29 @@ public:
 private:
 	friend class Common::Singleton<MD5CacheManager>;
 
+	struct PersistentEntry {
+		Common::String stamp;
+		Common::String md5;
+		int64 size;
+		uint32 lastRun; ///< Value of persistentRun when the entry was last used
+	};
+
+	void loadPersistent();
+	void prunePersistent();
+
 	typedef Common::HashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FileHashMap;
 	typedef Common::HashMap<Common::String, int64, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SizeHashMap;
+	typedef Common::HashMap<Common::String, PersistentEntry> PersistentHashMap;
 	FileHashMap md5HashMap;
 	SizeHashMap sizeHashMap;
+
+	Common::Mutex *mutex;
+
+	PersistentHashMap persistentHashMap;
+	bool persistentLoaded;
+	bool persistentDirty;
+	uint32 lastPersistentSave;
+	uint32 persistentRun; ///< Counts the runs of ScummVM which used the cache
 };
 
 /** Convenience shortcut for accessing the MD5CacheManager. */
@@ -85,6 +85,12 @@ public:
 
 	DetectedGames detectGames(const Common::FSList &fslist) const override;
 
+	// detectGames() calls the fallback detector, which uses a global
+	// game description, itself
+	bool isDetectionThreadSafe() const override {
+		return false;
+	}
+
 	ADDetectedGame fallbackDetect(const FileMap &allFiles, const Common::FSList &fslist, ADDetectedGameExtraInfo **extra = nullptr) const override;
 
 	bool canPlayUnknownVariants() const override {
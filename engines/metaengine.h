@@ -27,6 +27,9 @@
 #include "common/scummsys.h"
 #include "common/error.h"
 #include "common/array.h"
+#include "common/fs.h"
+#include "common/mutex.h"
+#include "common/noncopyable.h"
 
 #include "engines/game.h"
 #include "engines/savestate.h"
@@ -38,8 +41,8 @@ class OSystem;
 
 namespace Common {
 class Keymap;
-class FSList;
 class OutSaveFile;
+class WorkerPool;
 class String;
 
 typedef SeekableReadStream InSaveFile;
@@ -158,6 +161,16 @@ public:
 	 */
 	virtual DetectedGames detectGames(const Common::FSList &fslist) const = 0;
 
+	/**
+	 * Whether detectGames() can run in several threads at once, on different
+	 * directories. Detectors which use global state, such as SearchMan or
+	 * static game descriptions, must not claim this. They are run one
+	 * directory at a time, see DetectionLock.
+	 */
+	virtual bool isDetectionThreadSafe() const {
+		return false;
+	}
+
 	/**
 	 * Return a list of extra GUI options for the specified target.
 	 *
@@ -552,6 +565,22 @@ public:
 	 */
 	DetectionResults detectGames(const Common::FSList &fslist) const;
 
+	/**
+	 * Run the detectors of the given plugins on the files of one directory.
+	 *
+	 * Unlike detectGames(const Common::FSList &), this neither registers the
+	 * engines' debug channels nor clears the MD5 cache, so that it can be
+	 * called from several threads at once. See DetectionScan.
+	 */
+	DetectedGames detectGames(const PluginList &plugins, const Common::FSList &fslist) const;
+
+	/**
+	 * Return whether games are being detected on worker threads. Detectors
+	 * must not open dialogs then, as the GUI can only be used from the main
+	 * thread.
+	 */
+	bool isDetectingInParallel() const { return _parallelScans > 0; }
+
 	/** Find a plugin by its engine ID. */
 	const Plugin *findPlugin(const Common::String &engineId) const;
 
@@ -595,6 +624,111 @@ private:
 
 	/** Use heuristics to complete a target lacking an engine ID. */
 	void upgradeTargetForEngineId(const Common::String &target) const;
+
+	friend class Common::Singleton<EngineManager>;
+	friend class DetectionLock;
+	friend class DetectionScan;
+	EngineManager() : _detectionMutex(nullptr), _parallelScans(0) {}
+	~EngineManager();
+
+	/** Created by the first scan with worker threads, see DetectionLock */
+	Common::Mutex *_detectionMutex;
+	uint _parallelScans;
+};
+
+/**
+ * Lock a mutex which only exists once games are detected in parallel. Not
+ * all backends can create mutexes before they are initialized, and the
+ * command line detects games before that.
+ */
+class DetectionLock : Common::NonCopyable {
+public:
+	/**
+	 * Lock the mutex of the detectors which are not thread-safe, see
+	 * MetaEngineDetection::isDetectionThreadSafe().
+	 */
+	DetectionLock();
+	explicit DetectionLock(Common::Mutex *mutex);
+	~DetectionLock();
+
+private:
+	Common::Mutex *_mutex;
+};
+
+/**
+ * Detection of the games in a directory, and optionally in all of its
+ * subdirectories, as done when adding games in bulk.
+ *
+ * The directories are listed and the detectors run on a worker pool, where
+ * the backend supports threads. Otherwise, the directories are scanned in
+ * slices from update(). Either way, the results are handed out in the same
+ * order: depth first, with the subdirectories in the order they are listed.
+ *
+ * The number of worker threads is set by the "detection_threads" key.
+ */
+class DetectionScan : Common::NonCopyable {
+public:
+	/** The games found in one directory. */
+	struct Result {
+		Common::FSNode directory;
+		DetectedGames games;
+	};
+
+	/**
+	 * Start scanning @p startDir.
+	 *
+	 * @param threads  The number of worker threads, or -1 to use the
+	 *                 configured number.
+	 */
+	DetectionScan(const Common::FSNode &startDir, bool recursive, int threads = -1);
+
+	/** Cancel the scan and wait for the worker threads to stop. */
+	~DetectionScan();
+
+	/**
+	 * Append the results of the directories scanned since the last call, in
+	 * order. Spends up to @p maxTime ms scanning, or waiting for the worker
+	 * threads to scan, the next directory to hand out.
+	 *
+	 * @return True once all the results have been handed out.
+	 */
+	bool update(Common::Array<Result> &results, uint32 maxTime);
+
+	/** Stop scanning. No more results are handed out. */
+	void cancel();
+
+	/** Return the number of directories scanned so far. */
+	uint getScannedCount() const;
+
+	/** Return the number of directories found so far, scanned or not. */
+	uint getDirectoryCount() const;
+
+	/** Return the number of worker threads, zero if scanning from update(). */
+	uint getThreadCount() const;
+
+private:
+	struct Directory;
+	struct Job;
+
+	/** Scan the next queued directory, return false if there is none. */
+	bool scanNext();
+	static void deleteDirectory(Directory *dir);
+
+	const bool _recursive;
+	PluginList _plugins;
+	Common::WorkerPool *_workerPool;
+	Job *_job;
+
+	/** Only created along with the worker threads, see DetectionLock */
+	Common::Mutex *_mutex;
+	/** The directories still to be handed out, the next one on top */
+	Common::Array<Directory *> _pending;
+	/** The directories still to be scanned, the next one on top */
+	Common::Array<Directory *> _queue;
+	uint _scannedCount;
+	uint _directoryCount;
+	bool _cancelled;
+	bool _finished;
 };
 
 /** Convenience shortcut for accessing the engine manager. */
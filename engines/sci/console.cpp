@@ -54,6 +54,7 @@
 #include "sci/video/seq_decoder.h"
 #ifdef ENABLE_SCI32
 #include "common/memstream.h"
+#include "sci/graphics/celobj32.h"
 #include "sci/graphics/frameout.h"
 #include "sci/graphics/paint32.h"
 #include "sci/graphics/palette32.h"
@@ -100,6 +101,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("selectors",			WRAP_METHOD(Console, cmdSelectors));
 	registerCmd("functions",			WRAP_METHOD(Console, cmdKernelFunctions));
 	registerCmd("class_table",		WRAP_METHOD(Console, cmdClassTable));
+	registerCmd("selector_cache",		WRAP_METHOD(Console, cmdSelectorCache));
 	// Parser
 	registerCmd("suffixes",			WRAP_METHOD(Console, cmdSuffixes));
 	registerCmd("parse_grammar",		WRAP_METHOD(Console, cmdParseGrammar));
@@ -117,6 +119,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
+	registerCmd("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	registerCmd("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
 	registerCmd("integrity_dump",	WRAP_METHOD(Console, cmdResourceIntegrityDump));
@@ -150,6 +153,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("vpi",                WRAP_METHOD(Console, cmdVisiblePlaneItemList));	// alias
 	registerCmd("saved_bits",         WRAP_METHOD(Console, cmdSavedBits));
 	registerCmd("show_saved_bits",    WRAP_METHOD(Console, cmdShowSavedBits));
+	registerCmd("cel_cache",          WRAP_METHOD(Console, cmdCelCache));
 	// Segments
 	registerCmd("segment_table",		WRAP_METHOD(Console, cmdPrintSegmentTable));
 	registerCmd("segtable",			WRAP_METHOD(Console, cmdPrintSegmentTable));	// alias
@@ -163,6 +167,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -328,6 +333,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" selector - Attempts to find the requested selector by name\n");
 	debugPrintf(" functions - Lists the kernel functions\n");
 	debugPrintf(" class_table - Shows the available classes\n");
+	debugPrintf(" selector_cache - Shows the hit rate of the selector lookup cache\n");
 	debugPrintf("\n");
 	debugPrintf("Parser:\n");
 	debugPrintf(" suffixes - Lists the vocabulary suffixes\n");
@@ -347,6 +353,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_types - Shows the valid resource types\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
+	debugPrintf(" resource_cache - Shows the hits, misses and load times of the resource cache\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	debugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
 	debugPrintf(" integrity_dump - Dumps integrity data about resources in the current game to disk\n");
@@ -376,6 +383,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" visible_plane_items / vpi - Shows a list of all items for a plane in the visible draw list (SCI2+)\n");
 	debugPrintf(" saved_bits - List saved bits on the hunk\n");
 	debugPrintf(" show_saved_bits - Display saved bits\n");
+	debugPrintf(" cel_cache - Shows the hits and misses of the cel cache (SCI2+)\n");
 	debugPrintf("\n");
 	debugPrintf("Segments:\n");
 	debugPrintf(" segment_table / segtable - Lists all segments\n");
@@ -388,6 +396,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_stats - Shows pause times and reclaimed memory of the garbage collector\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -558,6 +567,33 @@ bool Console::cmdSelector(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSelectorCache(int argc, const char **argv) {
+	SelectorLookupCache &cache = _engine->_gamestate->_segMan->getSelectorLookupCache();
+
+	if (argc > 1) {
+		if (!scumm_stricmp(argv[1], "reset")) {
+			cache.resetStats();
+		} else if (!scumm_stricmp(argv[1], "on")) {
+			cache.setEnabled(true);
+		} else if (!scumm_stricmp(argv[1], "off")) {
+			cache.setEnabled(false);
+		} else {
+			debugPrintf("Shows the hit rate of the selector lookup cache.\n");
+			debugPrintf("Usage: %s [reset | on | off]\n", argv[0]);
+			debugPrintf("reset clears the statistics, on and off enable or disable the cache\n");
+			return true;
+		}
+	}
+
+	const uint32 lookups = cache.getHits() + cache.getMisses();
+	debugPrintf("Selector lookup cache is %s\n", cache.isEnabled() ? "enabled" : "disabled");
+	debugPrintf("Lookups: %u, hits: %u (%u%%), misses: %u, invalidations: %u\n",
+		lookups, cache.getHits(), lookups ? (uint)((uint64)cache.getHits() * 100 / lookups) : 0,
+		cache.getMisses(), cache.getInvalidations());
+
+	return true;
+}
+
 bool Console::cmdSelectors(int argc, const char **argv) {
 	debugPrintf("Selector names in numeric order:\n");
 	Common::String selectorName;
@@ -1040,6 +1076,36 @@ bool Console::cmdAllocList(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	ResourceManager *resMan = _engine->getResMan();
+
+	if (argc > 1) {
+		if (!scumm_stricmp(argv[1], "reset")) {
+			resMan->resetCacheStats();
+		} else {
+			debugPrintf("Shows the hits, misses and load times of the resource cache.\n");
+			debugPrintf("Usage: %s [reset]\n", argv[0]);
+			debugPrintf("The cache size can be set in KiB with the resource_cache_size option\n");
+			return true;
+		}
+	}
+
+	debugPrintf("Cache: %d of %d KiB used, %d KiB locked\n",
+		resMan->getCacheMemory() / 1024, resMan->getCacheSize() / 1024, resMan->getLockedMemory() / 1024);
+	debugPrintf("%-12s %8s %8s %10s %10s\n", "Type", "Hits", "Misses", "Load (ms)", "Evictions");
+
+	for (int i = 0; i < kResourceTypeInvalid; ++i) {
+		const ResourceCacheStats &stats = resMan->getCacheStats((ResourceType)i);
+		if (!stats.hits && !stats.misses)
+			continue;
+
+		debugPrintf("%-12s %8u %8u %10.1f %10u\n", getResourceTypeName((ResourceType)i),
+			stats.hits, stats.misses, stats.loadTime / 1000.0, stats.evictions);
+	}
+
+	return true;
+}
+
 bool Console::cmdDissectScript(int argc, const char **argv) {
 	if (argc != 2) {
 		debugPrintf("Examines a script\n");
@@ -2313,6 +2379,39 @@ bool Console::cmdShowSavedBits(int argc, const char **argv) {
 }
 
 
+bool Console::cmdCelCache(int argc, const char **argv) {
+#ifdef ENABLE_SCI32
+	CelCache *cache = CelObj::getCache();
+	if (!_engine->_gfxFrameout || !cache) {
+		debugPrintf("This SCI version does not have a cel cache\n");
+		return true;
+	}
+
+	if (argc > 1) {
+		if (!scumm_stricmp(argv[1], "reset")) {
+			cache->resetStats();
+		} else {
+			debugPrintf("Shows the hits and misses of the cel cache, for the last frame and in total.\n");
+			debugPrintf("Usage: %s [reset]\n", argv[0]);
+			debugPrintf("The memory for decompressed pixels can be set in KiB with the cel_cache_size option\n");
+			return true;
+		}
+	}
+
+	debugPrintf("Cache: %u of %u cels, %u of %u KiB of pixels\n",
+		cache->getCelCount(), cache->getMaxCels(), cache->getPixelMemory() / 1024, cache->getMaxPixelMemory() / 1024);
+	debugPrintf("%-10s %8s %8s %12s %12s\n", "", "Hits", "Misses", "Pixel hits", "Pixel misses");
+
+	const CelCacheStats &frame = cache->getFrameStats();
+	debugPrintf("%-10s %8u %8u %12u %12u\n", "Last frame", frame.hits, frame.misses, frame.pixelHits, frame.pixelMisses);
+	const CelCacheStats &total = cache->getTotalStats();
+	debugPrintf("%-10s %8u %8u %12u %12u\n", "Total", total.hits, total.misses, total.pixelHits, total.pixelMisses);
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
 bool Console::cmdParseGrammar(int argc, const char **argv) {
 	debugPrintf("Parse grammar, in strict GNF:\n");
 
@@ -2733,6 +2832,30 @@ bool Console::cmdGCInvoke(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	EngineState *s = _engine->_gamestate;
+	GCStatistics &stats = s->gcStats;
+
+	if (argc > 1) {
+		if (!scumm_stricmp(argv[1], "reset")) {
+			stats.reset();
+		} else {
+			debugPrintf("Shows pause times and reclaimed memory of the garbage collector.\n");
+			debugPrintf("Usage: %s [reset]\n", argv[0]);
+			return true;
+		}
+	}
+
+	debugPrintf("Collections: %u\n", stats.collections);
+	debugPrintf("Pause: last %u ms, longest %u ms, total %u ms\n", stats.lastPause, stats.maxPause, stats.totalPause);
+	debugPrintf("Last collection freed %u objects (%u bytes)\n", stats.lastReclaimed, stats.lastReclaimedBytes);
+	debugPrintf("All collections freed %u objects (%u bytes)\n", stats.totalReclaimed, stats.totalReclaimedBytes);
+	debugPrintf("Collectable objects: %u, %u after the last collection\n", s->_segMan->getCollectableCount(), s->gcLiveObjects);
+	debugPrintf("Collectable memory: %u bytes, %u after the last collection\n", s->_segMan->getCollectableMemory(), s->gcLiveMemory);
+
+	return true;
+}
+
 bool Console::cmdGCObjects(int argc, const char **argv) {
 	AddrSet *use_map = findAllActiveReferences(_engine->_gamestate);
 
@@ -56,10 +56,11 @@ void WorklistManager::push(reg_t reg) {
 
 	debugC(kDebugLevelGC, "[GC] Adding %04x:%04x", PRINT_REG(reg));
 
-	if (_map.contains(reg))
+	bool &known = _map[reg];
+	if (known)
 		return; // already dealt with it
 
-	_map.setVal(reg, true);
+	known = true;
 	_worklist.push_back(reg);
 }
 
@@ -181,6 +182,10 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 
 void run_gc(EngineState *s) {
 	SegManager *segMan = s->_segMan;
+	GCStatistics &stats = s->gcStats;
+	const uint32 startTime = g_system->getMillis();
+	uint32 reclaimed = 0;
+	uint32 reclaimedBytes = 0;
 
 	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
@@ -213,6 +218,11 @@ void run_gc(EngineState *s) {
 				const reg_t addr = *it;
 				if (!activeRefs->contains(addr)) {
 					// Not found -> we can free it
+					const uint32 size = mobj->getDeallocatableSize(addr);
+					if (size) {
+						reclaimed++;
+						reclaimedBytes += size;
+					}
 					mobj->freeAtAddress(segMan, addr);
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
 #ifdef GC_DEBUG_CODE
@@ -226,6 +236,20 @@ void run_gc(EngineState *s) {
 
 	delete activeRefs;
 
+	s->gcLiveObjects = segMan->getCollectableCount();
+	s->gcLiveMemory = segMan->getCollectableMemory();
+
+	const uint32 pause = g_system->getMillis() - startTime;
+	stats.collections++;
+	stats.lastPause = pause;
+	stats.maxPause = MAX(stats.maxPause, pause);
+	stats.totalPause += pause;
+	stats.lastReclaimed = reclaimed;
+	stats.lastReclaimedBytes = reclaimedBytes;
+	stats.totalReclaimed += reclaimed;
+	stats.totalReclaimedBytes += reclaimedBytes;
+	debugC(kDebugLevelGC, "[GC] Freed %u objects (%u bytes) in %u ms", reclaimed, reclaimedBytes, pause);
+
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
 	debugC(kDebugLevelGC, "[GC] Summary:");
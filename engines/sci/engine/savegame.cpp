@@ -1481,6 +1481,8 @@ void gamestate_restore(EngineState *s, Common::SeekableReadStream *fh) {
 	s->_segMan->reconstructClones();
 	s->initGlobals();
 	s->gcCountDown = GC_INTERVAL - 1;
+	s->gcLiveObjects = 0;
+	s->gcLiveMemory = 0;
 
 	// Time state:
 	s->lastWaitTime = g_system->getMillis();
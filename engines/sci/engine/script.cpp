@@ -73,6 +73,9 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	_instructionIndex.clear();
+	_instructions.clear();
 }
 
 enum {
@@ -857,6 +860,47 @@ void Script::setLockers(int lockers) {
 	_lockers = lockers;
 }
 
+const PMachineInstruction &Script::getInstruction(uint32 offset) {
+	if (_instructionIndex.empty())
+		_instructionIndex.resize(_buf->size());
+
+	uint16 &index = _instructionIndex[offset];
+	if (index)
+		return _instructions[index - 1];
+
+	PMachineInstruction *instruction;
+	if (_instructions.size() < 0xFFFF) {
+		_instructions.push_back(PMachineInstruction());
+		instruction = &_instructions.back();
+		index = _instructions.size();
+	} else {
+		instruction = &_uncachedInstruction;
+	}
+
+	instruction->size = readPMachineInstruction(getBuf(offset), instruction->extOpcode, instruction->opparams);
+	instruction->fusedBranch = 0;
+	instruction->branchSize = 0;
+	instruction->branchOffset = 0;
+
+	// Comparisons are almost always followed by a conditional branch. Only
+	// look at the opcode first, as the comparison may also be the last
+	// instruction before data.
+	const byte opcode = instruction->extOpcode >> 1;
+	const uint32 nextOffset = offset + instruction->size;
+	if (opcode >= op_eq_ && opcode <= op_ule_ && nextOffset + 3 <= _buf->size()) {
+		const byte nextOpcode = *getBuf(nextOffset) >> 1;
+		if (nextOpcode == op_bt || nextOpcode == op_bnt) {
+			byte extOpcode;
+			int16 opparams[4];
+			instruction->fusedBranch = nextOpcode;
+			instruction->branchSize = readPMachineInstruction(getBuf(nextOffset), extOpcode, opparams);
+			instruction->branchOffset = opparams[0];
+		}
+	}
+
+	return *instruction;
+}
+
 uint32 Script::validateExportFunc(int pubfunct, bool relocSci3) {
 	bool exportsAreWide = (g_sci->_features->detectLofsType() == SCI_VERSION_1_MIDDLE);
 
@@ -102,6 +102,15 @@ private:
 	uint16 _offsetLookupStringCount;
 	uint16 _offsetLookupSaidCount;
 
+	/**
+	 * Index + 1 into _instructions of the instruction at each offset of the
+	 * buffer, or 0 if it has not been parsed yet.
+	 */
+	Common::Array<uint16> _instructionIndex;
+	Common::Array<PMachineInstruction> _instructions;
+	/** Used once _instructions can not be indexed anymore. */
+	PMachineInstruction _uncachedInstruction;
+
 public:
 	int getLocalsOffset() const { return _localsOffset; }
 	uint16 getLocalsCount() const { return _localsCount; }
@@ -139,6 +148,9 @@ public:
 	SegmentRef dereference(reg_t pointer) override;
 	reg_t findCanonicAddress(SegManager *segMan, reg_t sub_addr) const override;
 	void freeAtAddress(SegManager *segMan, reg_t sub_addr) override;
+	uint32 getDeallocatableSize(reg_t sub_addr) const override {
+		return _markedAsDeleted ? getBufSize() : 0;
+	}
 	Common::Array<reg_t> listAllDeallocatable(SegmentId segId) const override;
 	Common::Array<reg_t> listAllOutgoingReferences(reg_t object) const override;
 
@@ -237,6 +249,15 @@ public:
 	 */
 	uint32 validateExportFunc(int pubfunct, bool relocSci3);
 
+	/**
+	 * Returns the parsed instruction at the given offset, parsing it on first
+	 * use. The buffer itself is not changed, so script patches, the debugger
+	 * and the disassembler all keep working on the original bytecode.
+	 *
+	 * The reference stays valid until the next call.
+	 */
+	const PMachineInstruction &getInstruction(uint32 offset);
+
 	/**
 	 * Marks the script as deleted.
 	 * This will not actually delete the script.  If references remain present on the
@@ -180,10 +180,68 @@ void SegManager::deallocate(SegmentId seg) {
 		}
 	}
 
+	if (mobj->getType() == SEG_TYPE_SCRIPT || mobj->getType() == SEG_TYPE_CLONES)
+		invalidateSelectorLookupCache();
+
 	delete mobj;
 	_heap[actualSegment] = NULL;
 }
 
+uint SegManager::getCollectableCount() const {
+	uint count = 0;
+
+	for (uint i = 1; i < _heap.size(); i++) {
+		const SegmentObj *mobj = _heap[i];
+		if (!mobj)
+			continue;
+
+		switch (mobj->getType()) {
+		case SEG_TYPE_SCRIPT:
+			count++;
+			break;
+		case SEG_TYPE_CLONES:
+			count += static_cast<const CloneTable *>(mobj)->entries_used;
+			break;
+		case SEG_TYPE_LISTS:
+			count += static_cast<const ListTable *>(mobj)->entries_used;
+			break;
+		case SEG_TYPE_NODES:
+			count += static_cast<const NodeTable *>(mobj)->entries_used;
+			break;
+		case SEG_TYPE_HUNK:
+			count += static_cast<const HunkTable *>(mobj)->entries_used;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return count;
+}
+
+uint32 SegManager::getCollectableMemory() const {
+	uint32 memory = 0;
+
+	for (uint i = 1; i < _heap.size(); i++) {
+		const SegmentObj *mobj = _heap[i];
+		if (!mobj)
+			continue;
+
+		switch (mobj->getType()) {
+		case SEG_TYPE_SCRIPT:
+			memory += mobj->getDeallocatableSize(make_reg(i, 0));
+			break;
+		case SEG_TYPE_HUNK:
+			memory += static_cast<const HunkTable *>(mobj)->_allocatedBytes;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return memory;
+}
+
 bool SegManager::isHeapObject(reg_t pos) const {
 	const Object *obj = getObject(pos);
 	if (obj == NULL || (obj && obj->isFreed()))
@@ -464,6 +522,8 @@ reg_t SegManager::allocateHunkEntry(const char *hunk_type, int size) {
 	h->mem = malloc(size);
 	h->size = size;
 	h->type = hunk_type;
+	if (h->mem)
+		table->_allocatedBytes += size;
 
 	return addr;
 }
@@ -1100,6 +1160,7 @@ int SegManager::instantiateScript(int scriptNum, bool applyScriptPatches) {
 #ifdef ENABLE_SCI32
 	g_sci->_guestAdditions->instantiateScriptHook(*scr);
 #endif
+	invalidateSelectorLookupCache();
 
 	return segmentId;
 }
@@ -26,6 +26,7 @@
 #include "common/scummsys.h"
 #include "common/serializer.h"
 #include "sci/engine/script.h"
+#include "sci/engine/selector.h"
 #include "sci/engine/vm.h"
 #include "sci/engine/vm_types.h"
 #include "sci/engine/segment.h"
@@ -463,6 +464,27 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/**
+	 * Returns the number of allocated objects the garbage collector may free:
+	 * scripts, clones, lists, nodes and hunks.
+	 */
+	uint getCollectableCount() const;
+
+	/**
+	 * Returns the size of the large allocations the garbage collector may
+	 * free: the memory of hunks, and of scripts marked as deleted.
+	 */
+	uint32 getCollectableMemory() const;
+
+	/**
+	 * Returns the cache used by lookupSelector(). It is invalidated
+	 * whenever a script is loaded, or a segment or clone is freed.
+	 */
+	SelectorLookupCache &getSelectorLookupCache() { return _selectorLookupCache; }
+
+	/** Forgets all cached selector lookups, after objects were changed. */
+	void invalidateSelectorLookupCache() { _selectorLookupCache.invalidate(); }
+
 private:
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
@@ -472,6 +494,8 @@ private:
 	ResourceManager *_resMan;
 	ScriptPatcher *_scriptPatcher;
 
+	SelectorLookupCache _selectorLookupCache;
+
 	SegmentId _clonesSegId; ///< ID of the (a) clones segment
 	SegmentId _listsSegId; ///< ID of the (a) list segment
 	SegmentId _nodesSegId; ///< ID of the (a) node segment
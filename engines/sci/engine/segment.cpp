@@ -125,6 +125,9 @@ void CloneTable::freeAtAddress(SegManager *segMan, reg_t addr) {
 #endif
 
 	freeEntry(addr.getOffset());
+
+	// A new clone may be allocated at the same address
+	segMan->invalidateSelectorLookupCache();
 }
 
 
@@ -123,6 +123,13 @@ public:
 	 */
 	virtual void freeAtAddress(SegManager *segMan, reg_t sub_addr) {}
 
+	/**
+	 * Returns the number of bytes freeAtAddress() releases for the specified
+	 * address, or 0 if it does not release anything.
+	 * Used for the statistics of the garbage collector.
+	 */
+	virtual uint32 getDeallocatableSize(reg_t sub_addr) const { return 0; }
+
 	/**
 	 * Iterates over and reports all addresses within the segment.
 	 * Used by the garbage collector.
@@ -321,6 +328,9 @@ struct CloneTable : public SegmentObjTable<Clone> {
 	CloneTable() : SegmentObjTable<Clone>(SEG_TYPE_CLONES) {}
 
 	void freeAtAddress(SegManager *segMan, reg_t sub_addr) override;
+	uint32 getDeallocatableSize(reg_t sub_addr) const override {
+		return sizeof(Clone) + at(sub_addr.getOffset()).getVarCount() * sizeof(reg_t);
+	}
 	Common::Array<reg_t> listAllOutgoingReferences(reg_t object) const override;
 
 	void saveLoadWithSerializer(Common::Serializer &ser) override;
@@ -334,6 +344,9 @@ struct NodeTable : public SegmentObjTable<Node> {
 	void freeAtAddress(SegManager *segMan, reg_t sub_addr) override {
 		freeEntry(sub_addr.getOffset());
 	}
+	uint32 getDeallocatableSize(reg_t sub_addr) const override {
+		return sizeof(Node);
+	}
 	Common::Array<reg_t> listAllOutgoingReferences(reg_t object) const override;
 
 	void saveLoadWithSerializer(Common::Serializer &ser) override;
@@ -347,6 +360,9 @@ struct ListTable : public SegmentObjTable<List> {
 	void freeAtAddress(SegManager *segMan, reg_t sub_addr) override {
 		freeEntry(sub_addr.getOffset());
 	}
+	uint32 getDeallocatableSize(reg_t sub_addr) const override {
+		return sizeof(List);
+	}
 	Common::Array<reg_t> listAllOutgoingReferences(reg_t object) const override;
 
 	void saveLoadWithSerializer(Common::Serializer &ser) override;
@@ -355,7 +371,10 @@ struct ListTable : public SegmentObjTable<List> {
 
 /* HunkTable */
 struct HunkTable : public SegmentObjTable<Hunk> {
-	HunkTable() : SegmentObjTable<Hunk>(SEG_TYPE_HUNK) {}
+	/** Total size of the memory allocated for the hunks in the table */
+	uint32 _allocatedBytes;
+
+	HunkTable() : SegmentObjTable<Hunk>(SEG_TYPE_HUNK), _allocatedBytes(0) {}
 	~HunkTable() override {
 		for (uint i = 0; i < _table.size(); i++) {
 			if (isValidEntry(i))
@@ -364,6 +383,8 @@ struct HunkTable : public SegmentObjTable<Hunk> {
 	}
 
 	void freeEntryContents(int idx) {
+		if (at(idx).mem)
+			_allocatedBytes -= at(idx).size;
 		free(at(idx).mem);
 		at(idx).mem = 0;
 	}
@@ -376,6 +397,9 @@ struct HunkTable : public SegmentObjTable<Hunk> {
 	void freeAtAddress(SegManager *segMan, reg_t sub_addr) override {
 		freeEntry(sub_addr.getOffset());
 	}
+	uint32 getDeallocatableSize(reg_t sub_addr) const override {
+		return sizeof(Hunk) + at(sub_addr.getOffset()).size;
+	}
 
 	void saveLoadWithSerializer(Common::Serializer &ser) override;
 };
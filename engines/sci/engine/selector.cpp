@@ -326,8 +326,36 @@ void invokeSelector(EngineState *s, reg_t object, int selectorId,
 	run_vm(s); // Start a new vm
 }
 
+SelectorLookupCache::SelectorLookupCache() : _generation(1), _enabled(true), _hits(0), _misses(0), _invalidations(0) {
+	memset(_entries, 0, sizeof(_entries));
+}
+
+void SelectorLookupCache::store(reg_t obj, Selector selectorId, SelectorType type, int varIndex, reg_t funcp) {
+	Entry &entry = _entries[getIndex(obj, selectorId)];
+	entry.obj = obj;
+	entry.funcp = funcp;
+	entry.generation = _generation;
+	entry.selectorId = selectorId;
+	entry.varIndex = varIndex;
+	entry.type = type;
+}
+
+void SelectorLookupCache::invalidate() {
+	++_invalidations;
+
+	if (++_generation == 0) {
+		// The counter wrapped around, so old entries could look current again
+		memset(_entries, 0, sizeof(_entries));
+		_generation = 1;
+	}
+}
+
+void SelectorLookupCache::setEnabled(bool enabled) {
+	_enabled = enabled;
+	invalidate();
+}
+
 SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
-	const Object *obj = segMan->getObject(obj_location);
 	int index;
 	bool oldScriptHeader = (getSciVersion() == SCI_VERSION_0_EARLY);
 
@@ -336,6 +364,22 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 	if (oldScriptHeader)
 		selectorId &= ~1;
 
+	SelectorLookupCache &cache = segMan->getSelectorLookupCache();
+	if (cache.isEnabled()) {
+		const SelectorLookupCache::Entry *entry = cache.lookup(obj_location, selectorId);
+		if (entry) {
+			if (entry->type == kSelectorVariable && varp) {
+				varp->obj = obj_location;
+				varp->varindex = entry->varIndex;
+			} else if (entry->type == kSelectorMethod && fptr) {
+				*fptr = entry->funcp;
+			}
+			return entry->type;
+		}
+	}
+
+	const Object *obj = segMan->getObject(obj_location);
+
 	if (!obj) {
 		const SciCallOrigin origin = g_sci->getEngineState()->getCurrentCallOrigin();
 		error("lookupSelector: Attempt to send to non-object or invalid script. Address %04x:%04x, %s", PRINT_REG(obj_location), origin.toString().c_str());
@@ -349,21 +393,28 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 			varp->obj = obj_location;
 			varp->varindex = index;
 		}
+		if (cache.isEnabled())
+			cache.store(obj_location, selectorId, kSelectorVariable, index, NULL_REG);
 		return kSelectorVariable;
 	} else {
 		// Check if it's a method, with recursive lookup in superclasses
 		while (obj) {
 			index = obj->funcSelectorPosition(selectorId);
 			if (index >= 0) {
+				const reg_t funcp = obj->getFunction(index);
 				if (fptr)
-					*fptr = obj->getFunction(index);
+					*fptr = funcp;
 
+				if (cache.isEnabled())
+					cache.store(obj_location, selectorId, kSelectorMethod, -1, funcp);
 				return kSelectorMethod;
 			} else {
 				obj = segMan->getObject(obj->getSuperClassSelector());
 			}
 		}
 
+		if (cache.isEnabled())
+			cache.store(obj_location, selectorId, kSelectorNone, -1, NULL_REG);
 		return kSelectorNone;
 	}
 
@@ -206,6 +206,78 @@ struct SelectorCache {
  */
 #define SELECTOR(_slc_)		(g_sci->getKernel()->_selectorCache._slc_)
 
+/**
+ * Direct-mapped cache of the results of lookupSelector(), keyed by object
+ * address and selector, which saves walking the class chain of the object on
+ * every send and property access.
+ *
+ * The results stay valid as long as no object is freed and no script is
+ * (re)loaded, so the segment manager invalidates the whole cache when this
+ * happens. Invalidation only bumps a generation counter, so it is cheap.
+ */
+class SelectorLookupCache {
+public:
+	struct Entry {
+		reg_t obj;
+		reg_t funcp;
+		uint32 generation;
+		Selector selectorId;
+		int varIndex;
+		SelectorType type;
+	};
+
+	SelectorLookupCache();
+
+	/**
+	 * Returns the cached lookup of the given selector, or NULL if it is not
+	 * cached.
+	 */
+	const Entry *lookup(reg_t obj, Selector selectorId) {
+		const Entry &entry = _entries[getIndex(obj, selectorId)];
+		if (entry.generation == _generation && entry.obj == obj && entry.selectorId == selectorId) {
+			++_hits;
+			return &entry;
+		}
+
+		++_misses;
+		return nullptr;
+	}
+
+	void store(reg_t obj, Selector selectorId, SelectorType type, int varIndex, reg_t funcp);
+
+	/** Forgets all cached lookups. */
+	void invalidate();
+
+	/** Enables or disables the cache, for debugging. */
+	void setEnabled(bool enabled);
+	bool isEnabled() const { return _enabled; }
+
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+	uint32 getInvalidations() const { return _invalidations; }
+	void resetStats() { _hits = _misses = _invalidations = 0; }
+
+private:
+	enum {
+		kCacheBits = 11,
+		kCacheSize = 1 << kCacheBits
+	};
+
+	static uint getIndex(reg_t obj, Selector selectorId) {
+		const uint32 key = (obj.getOffset() ^ (obj.getSegment() << 16)) * 0x9E3779B1 + selectorId * 0x85EBCA6B;
+		return key >> (32 - kCacheBits);
+	}
+
+	Entry _entries[kCacheSize];
+	/** Entries of other generations are stale. 0 is never used, see invalidate(). */
+	uint32 _generation;
+	bool _enabled;
+
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _invalidations;
+};
+
 /**
  * Retrieves a selector from an object.
  * @param segMan	the segment mananger
@@ -104,6 +104,9 @@ void EngineState::reset(bool isRestoring) {
 	lastWaitTime = 0;
 
 	gcCountDown = 0;
+	gcLiveObjects = 0;
+	gcLiveMemory = 0;
+	gcStats.reset();
 
 #ifdef ENABLE_SCI32
 	_eventCounter = 0;
@@ -98,6 +98,29 @@ struct SciCallOrigin {
 	}
 };
 
+/**
+ * Statistics of the garbage collector, shown by the gc_stats console command.
+ */
+struct GCStatistics {
+	uint32 collections; //< Number of collections
+	uint32 lastPause; //< Duration of the last collection, in milliseconds
+	uint32 maxPause; //< Duration of the longest collection, in milliseconds
+	uint32 totalPause; //< Time spent collecting, in milliseconds
+	uint32 lastReclaimed; //< Number of objects freed by the last collection
+	uint32 lastReclaimedBytes; //< Memory released by the last collection
+	uint32 totalReclaimed; //< Number of objects freed by all collections
+	uint32 totalReclaimedBytes; //< Memory released by all collections
+
+	GCStatistics() { reset(); }
+
+	void reset() {
+		collections = 0;
+		lastPause = maxPause = totalPause = 0;
+		lastReclaimed = lastReclaimedBytes = 0;
+		totalReclaimed = totalReclaimedBytes = 0;
+	}
+};
+
 struct EngineState : public Common::Serializable {
 public:
 	EngineState(SegManager *segMan);
@@ -195,6 +218,9 @@ public:
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	uint gcLiveObjects; /**< Number of collectable objects left by the last gc */
+	uint32 gcLiveMemory; /**< Collectable memory left by the last gc, see SegManager::getCollectableMemory() */
+	GCStatistics gcStats;
 
 	MessageState *_msgState;
 
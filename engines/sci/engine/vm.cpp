@@ -579,6 +579,7 @@ void run_vm(EngineState *s) {
 	int16 opparams[4]; // opcode parameters
 
 	VmHooks vmHooks;
+	const bool hasVmHooks = vmHooks.hasHooks();
 
 	s->r_rest = 0;	// &rest adjusts the parameter count by this value
 	// Current execution data:
@@ -664,9 +665,26 @@ void run_vm(EngineState *s) {
 
 		// Get opcode
 		byte extOpcode;
-		if (!vmHooks.isActive(s))
-			s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
-		else {
+		byte fusedBranch = 0;
+		byte branchSize = 0;
+		int16 branchOffset = 0;
+		if (!vmHooks.isActive(s)) {
+			// Copy the parsed instruction, as kernel calls may parse further
+			// instructions of the same script
+			const PMachineInstruction &instruction = scr->getInstruction(s->xs->addr.pc.getOffset());
+			extOpcode = instruction.extOpcode;
+			memcpy(opparams, instruction.opparams, sizeof(opparams));
+			s->xs->addr.pc.incOffset(instruction.size);
+
+			// Executing the branch of a comparison right away skips the
+			// checks above for it, so don't when they could apply to it
+			if (instruction.fusedBranch && !hasVmHooks && !g_sci->_debugState.debugging &&
+			    !(g_sci->_debugState._activeBreakpointTypes & BREAK_ADDRESS)) {
+				fusedBranch = instruction.fusedBranch;
+				branchSize = instruction.branchSize;
+				branchOffset = instruction.branchOffset;
+			}
+		} else {
 			int offset = readPMachineInstruction(vmHooks.data(), extOpcode, opparams);
 			vmHooks.advance(offset);
 		}
@@ -1443,6 +1461,23 @@ void run_vm(EngineState *s) {
 
 		} // switch (opcode)
 
+		if (fusedBranch) {
+			// Conditional branch following a comparison
+			++s->scriptStepCounter;
+			s->xs->addr.pc.incOffset(branchSize);
+			if ((s->r_acc.getOffset() || s->r_acc.getSegment()) == (fusedBranch == op_bt))
+				s->xs->addr.pc.incOffset(branchOffset);
+
+			if (s->xs->addr.pc.getOffset() >= local_script->getScriptSize())
+				error("[VM] %s: request to jump past the end of script %d (offset %d, script is %d bytes)",
+					fusedBranch == op_bt ? "op_bt" : "op_bnt",
+					local_script->getScriptNumber(), s->xs->addr.pc.getOffset(), local_script->getScriptSize());
+
+#ifdef ABORT_ON_INFINITE_LOOP
+			prevOpcode = fusedBranch;
+#endif
+		}
+
 		if (s->_executionStackPosChanged) // Force initialization
 			s->xs = xs_new;
 
@@ -418,6 +418,26 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
  */
 int readPMachineInstruction(const byte *src, byte &extOpcode, int16 opparams[4]);
 
+/**
+ * An instruction as parsed by readPMachineInstruction(), kept by the script
+ * it belongs to so that run_vm() does not need to parse it again each time it
+ * is executed.
+ */
+struct PMachineInstruction {
+	int16 opparams[4];
+	uint16 size;     ///< The length of the instruction in bytes
+	byte extOpcode;
+
+	/**
+	 * op_bt or op_bnt if this is a comparison directly followed by a
+	 * conditional branch, which run_vm() then executes together with the
+	 * comparison. 0 otherwise.
+	 */
+	byte fusedBranch;
+	byte branchSize;     ///< The length of the branch instruction in bytes
+	int16 branchOffset;  ///< The relative offset of the branch
+};
+
 /**
  * Finds the script-absolute offset of a relative object offset.
  *
@@ -85,6 +85,9 @@ public:
 
 	void advance(int offset);
 
+	/** Returns whether the game has any hooks */
+	bool hasHooks() const { return !_hooksMap.empty(); }
+
 private:
 	/** Hash map of all game's hooks */
 	Common::HashMap<HookHashKey, HookEntry, HookHash> _hooksMap;
@@ -89,9 +89,19 @@ bool CelObj::_drawBlackLines = false;
 void CelObj::init() {
 	CelObj::deinit();
 	_drawBlackLines = false;
-	_nextCacheId = 1;
 	_scaler.reset(new CelScaler());
-	_cache.reset(new CelCache(100));
+
+	// SSCI cached only 100 cels, and none of their pixels, which is not
+	// enough for the high-resolution games
+#ifdef REDUCE_MEMORY_USAGE
+	uint32 maxPixelMemory = 2 * 1024 * 1024;
+#else
+	uint32 maxPixelMemory = 8 * 1024 * 1024;
+#endif
+	if (ConfMan.hasKey("cel_cache_size")) {
+		maxPixelMemory = CLIP(ConfMan.getInt("cel_cache_size"), 0, 0x7FFFFFFF / 1024) * 1024;
+	}
+	_cache.reset(new CelCache(1000, maxPixelMemory));
 }
 
 void CelObj::deinit() {
@@ -356,76 +366,108 @@ private:
 	uint32 _uncompressedDataOffset;
 	int16 _y;
 	const int16 _sourceHeight;
+	const int16 _sourceWidth;
 	const uint8 _skipColor;
 	const int16 _maxWidth;
 
+	/**
+	 * The decompressed pixels of the whole cel from the cel cache, or null if
+	 * rows are decompressed into `_buffer` as they are read.
+	 */
+	const byte *_pixels;
+
+	void decompressRow(const int16 y, const int16 width) {
+		// compressed data segment for row
+		const uint32 rowOffset = _resource.getUint32SEAt(_controlOffset + y * sizeof(uint32));
+
+		uint32 rowCompressedSize;
+		if (y + 1 < _sourceHeight) {
+			rowCompressedSize = _resource.getUint32SEAt(_controlOffset + (y + 1) * sizeof(uint32)) - rowOffset;
+		} else {
+			rowCompressedSize = _resource.size() - rowOffset - _dataOffset;
+		}
+
+		const byte *row = _resource.getUnsafeDataAt(_dataOffset + rowOffset, rowCompressedSize);
+
+		// uncompressed data segment for row
+		const uint32 literalOffset = _resource.getUint32SEAt(_controlOffset + _sourceHeight * sizeof(uint32) + y * sizeof(uint32));
+
+		uint32 literalRowSize;
+		if (y + 1 < _sourceHeight) {
+			literalRowSize = _resource.getUint32SEAt(_controlOffset + _sourceHeight * sizeof(uint32) + (y + 1) * sizeof(uint32)) - literalOffset;
+		} else {
+			literalRowSize = _resource.size() - literalOffset - _uncompressedDataOffset;
+		}
+
+		const byte *literal = _resource.getUnsafeDataAt(_uncompressedDataOffset + literalOffset, literalRowSize);
+
+		uint8 length;
+		for (int16 i = 0; i < width; i += length) {
+			const byte controlByte = *row++;
+			length = controlByte;
+
+			// Run-length encoded
+			if (controlByte & 0x80) {
+				length &= 0x3F;
+				assert(i + length < (int)sizeof(_buffer));
+
+				// Fill with skip color
+				if (controlByte & 0x40) {
+					memset(_buffer + i, _skipColor, length);
+				// Next value is fill color
+				} else {
+					memset(_buffer + i, *literal, length);
+					++literal;
+				}
+			// Uncompressed
+			} else {
+				assert(i + length < (int)sizeof(_buffer));
+				memcpy(_buffer + i, literal, length);
+				literal += length;
+			}
+		}
+	}
+
 public:
 	READER_Compressed(const CelObj &celObj, const int16 maxWidth) :
 	_resource(celObj.getResPointer()),
 	_y(-1),
 	_sourceHeight(celObj._height),
+	_sourceWidth(celObj._width),
 	_skipColor(celObj._skipColor),
-	_maxWidth(maxWidth) {
+	_maxWidth(maxWidth),
+	_pixels(nullptr) {
 		assert(maxWidth <= celObj._width);
 
 		const SciSpan<const byte> celHeader = _resource.subspan(celObj._celHeaderOffset);
 		_dataOffset = celHeader.getUint32SEAt(24);
 		_uncompressedDataOffset = celHeader.getUint32SEAt(28);
 		_controlOffset = celHeader.getUint32SEAt(32);
+
+		CelCache *const cache = CelObj::getCache();
+		if (cache) {
+			_pixels = cache->findPixels(celObj._info);
+			if (!_pixels) {
+				byte *const pixels = cache->allocatePixels(celObj._info, _sourceWidth * _sourceHeight);
+				if (pixels) {
+					for (int16 y = 0; y < _sourceHeight; ++y) {
+						decompressRow(y, _sourceWidth);
+						memcpy(pixels + y * _sourceWidth, _buffer, _sourceWidth);
+					}
+					_pixels = pixels;
+				}
+			}
+		}
 	}
 
 	inline const byte *getRow(const int16 y) {
 		assert(y >= 0 && y < _sourceHeight);
-		if (y != _y) {
-			// compressed data segment for row
-			const uint32 rowOffset = _resource.getUint32SEAt(_controlOffset + y * sizeof(uint32));
-
-			uint32 rowCompressedSize;
-			if (y + 1 < _sourceHeight) {
-				rowCompressedSize = _resource.getUint32SEAt(_controlOffset + (y + 1) * sizeof(uint32)) - rowOffset;
-			} else {
-				rowCompressedSize = _resource.size() - rowOffset - _dataOffset;
-			}
-
-			const byte *row = _resource.getUnsafeDataAt(_dataOffset + rowOffset, rowCompressedSize);
-
-			// uncompressed data segment for row
-			const uint32 literalOffset = _resource.getUint32SEAt(_controlOffset + _sourceHeight * sizeof(uint32) + y * sizeof(uint32));
-
-			uint32 literalRowSize;
-			if (y + 1 < _sourceHeight) {
-				literalRowSize = _resource.getUint32SEAt(_controlOffset + _sourceHeight * sizeof(uint32) + (y + 1) * sizeof(uint32)) - literalOffset;
-			} else {
-				literalRowSize = _resource.size() - literalOffset - _uncompressedDataOffset;
-			}
-
-			const byte *literal = _resource.getUnsafeDataAt(_uncompressedDataOffset + literalOffset, literalRowSize);
-
-			uint8 length;
-			for (int16 i = 0; i < _maxWidth; i += length) {
-				const byte controlByte = *row++;
-				length = controlByte;
-
-				// Run-length encoded
-				if (controlByte & 0x80) {
-					length &= 0x3F;
-					assert(i + length < (int)sizeof(_buffer));
+		if (_pixels) {
+			return _pixels + y * _sourceWidth;
+		}
 
-					// Fill with skip color
-					if (controlByte & 0x40) {
-						memset(_buffer + i, _skipColor, length);
-					// Next value is fill color
-					} else {
-						memset(_buffer + i, *literal, length);
-						++literal;
-					}
-				// Uncompressed
-				} else {
-					assert(i + length < (int)sizeof(_buffer));
-					memcpy(_buffer + i, literal, length);
-					literal += length;
-				}
-			}
+		if (y != _y) {
+			decompressRow(y, _maxWidth);
 			_y = y;
 		}
 
@@ -685,45 +727,129 @@ void CelObj::submitPalette() const {
 #pragma mark -
 #pragma mark CelObj - Caching
 
-int CelObj::_nextCacheId = 1;
 Common::ScopedPtr<CelCache> CelObj::_cache;
 
-int CelObj::searchCache(const CelInfo32 &celInfo, int *const nextInsertIndex) const {
-	*nextInsertIndex = -1;
-	int oldestId = _nextCacheId + 1;
-	int oldestIndex = 0;
+const CelObj *CelObj::searchCache(const CelInfo32 &celInfo) const {
+	return _cache->findCel(celInfo);
+}
+
+void CelObj::putCopyInCache() const {
+	_cache->putCel(*this);
+}
 
-	for (int i = 0, len = _cache->size(); i < len; ++i) {
-		CelCacheEntry &entry = (*_cache)[i];
+CelCache::CelCache(const uint maxCels, const uint32 maxPixelMemory) :
+	_maxCels(MAX<uint>(maxCels, 1)),
+	_maxPixelMemory(maxPixelMemory),
+	_pixelMemory(0) {}
 
-		if (entry.celObj == nullptr) {
-			if (*nextInsertIndex == -1) {
-				*nextInsertIndex = i;
-			}
-		} else if (entry.celObj->_info == celInfo) {
-			entry.id = ++_nextCacheId;
-			return i;
-		} else if (oldestId > entry.id) {
-			oldestId = entry.id;
-			oldestIndex = i;
-		}
+CelCache::~CelCache() {
+	for (EntryMap::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		delete it->_value;
+	}
+}
+
+CelCache::Entry *CelCache::touch(const CelInfo32 &info) {
+	EntryMap::iterator it = _entries.find(info);
+	if (it == _entries.end()) {
+		return nullptr;
+	}
+
+	Entry *const entry = it->_value;
+	if (entry->lruPosition != _lru.begin()) {
+		_lru.erase(entry->lruPosition);
+		_lru.push_front(info);
+		entry->lruPosition = _lru.begin();
+	}
+	return entry;
+}
+
+CelCache::Entry *CelCache::touchOrCreate(const CelInfo32 &info) {
+	Entry *entry = touch(info);
+	if (!entry) {
+		entry = new Entry();
+		_lru.push_front(info);
+		entry->lruPosition = _lru.begin();
+		_entries[info] = entry;
+	}
+	return entry;
+}
+
+void CelCache::evict() {
+	while ((_entries.size() > _maxCels || _pixelMemory > _maxPixelMemory) && _entries.size() > 1) {
+		const CelInfo32 info = _lru.back();
+		_lru.pop_back();
+
+		EntryMap::iterator it = _entries.find(info);
+		assert(it != _entries.end());
+		_pixelMemory -= it->_value->pixels.size();
+		delete it->_value;
+		_entries.erase(it);
+	}
+}
+
+const CelObj *CelCache::findCel(const CelInfo32 &info) {
+	Entry *const entry = touch(info);
+	if (entry && entry->celObj) {
+		++_frameStats.hits;
+		return entry->celObj.get();
+	}
+
+	++_frameStats.misses;
+	return nullptr;
+}
+
+void CelCache::putCel(const CelObj &celObj) {
+	Entry *const entry = touchOrCreate(celObj._info);
+	entry->celObj.reset(celObj.duplicate());
+	evict();
+}
+
+const byte *CelCache::findPixels(const CelInfo32 &info) {
+	Entry *const entry = touch(info);
+	if (entry && !entry->pixels.empty()) {
+		++_frameStats.pixelHits;
+		return entry->pixels.begin();
 	}
 
-	if (*nextInsertIndex == -1) {
-		*nextInsertIndex = oldestIndex;
+	++_frameStats.pixelMisses;
+	return nullptr;
+}
+
+byte *CelCache::allocatePixels(const CelInfo32 &info, const uint32 size) {
+	if (size == 0 || size > _maxPixelMemory) {
+		return nullptr;
 	}
 
-	return -1;
+	Entry *const entry = touchOrCreate(info);
+	_pixelMemory -= entry->pixels.size();
+	entry->pixels.resize(size);
+	_pixelMemory += size;
+	evict();
+	return entry->pixels.begin();
 }
 
-void CelObj::putCopyInCache(const int cacheIndex) const {
-	if (cacheIndex == -1) {
-		error("Invalid cache index");
+void CelCache::endFrame() {
+	if (!_frameStats.hits && !_frameStats.misses && !_frameStats.pixelHits && !_frameStats.pixelMisses) {
+		return;
 	}
 
-	CelCacheEntry &entry = (*_cache)[cacheIndex];
-	entry.celObj.reset(duplicate());
-	entry.id = ++_nextCacheId;
+	debugC(kDebugLevelGraphics, "Cel cache: %u/%u cels found, %u/%u pixels found, %u cels, %u KiB of pixels",
+		_frameStats.hits, _frameStats.hits + _frameStats.misses,
+		_frameStats.pixelHits, _frameStats.pixelHits + _frameStats.pixelMisses,
+		_entries.size(), _pixelMemory / 1024);
+
+	_totalStats.hits += _frameStats.hits;
+	_totalStats.misses += _frameStats.misses;
+	_totalStats.pixelHits += _frameStats.pixelHits;
+	_totalStats.pixelMisses += _frameStats.pixelMisses;
+	_lastFrameStats = _frameStats;
+	_frameStats = CelCacheStats();
+}
+
+void CelCache::resetStats() {
+	_frameStats = CelCacheStats();
+	_lastFrameStats = CelCacheStats();
+	_totalStats = CelCacheStats();
 }
 
 #pragma mark -
@@ -970,16 +1096,13 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 	_compressionType = kCelCompressionInvalid;
 	_transparent = true;
 
-	int cacheInsertIndex;
-	const int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjView *const cachedCelObj = dynamic_cast<CelObjView *>(entry.celObj.get());
-		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjView in cache slot %d", cacheIndex);
+	const CelObj *const cachedCelObj = searchCache(_info);
+	if (cachedCelObj != nullptr) {
+		const CelObjView *const cachedCelView = dynamic_cast<const CelObjView *>(cachedCelObj);
+		if (cachedCelView == nullptr) {
+			error("Expected a CelObjView in the cache for %s", _info.toString().c_str());
 		}
-		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
+		*this = *cachedCelView;
 		return;
 	}
 
@@ -1077,7 +1200,7 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 		_remap = analyzeForRemap();
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	putCopyInCache();
 }
 
 bool CelObjView::analyzeUncompressedForRemap() const {
@@ -1178,16 +1301,13 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 	_transparent = true;
 	_remap = false;
 
-	int cacheInsertIndex;
-	const int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjPic *const cachedCelObj = dynamic_cast<CelObjPic *>(entry.celObj.get());
-		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjPic in cache slot %d", cacheIndex);
+	const CelObj *const cachedCelObj = searchCache(_info);
+	if (cachedCelObj != nullptr) {
+		const CelObjPic *const cachedCelPic = dynamic_cast<const CelObjPic *>(cachedCelObj);
+		if (cachedCelPic == nullptr) {
+			error("Expected a CelObjPic in the cache for %s", _info.toString().c_str());
 		}
-		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
+		*this = *cachedCelPic;
 		return;
 	}
 
@@ -1251,7 +1371,7 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 		}
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	putCopyInCache();
 }
 
 bool CelObjPic::analyzeUncompressedForSkip() const {
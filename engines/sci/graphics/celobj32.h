@@ -23,6 +23,9 @@
 #ifndef SCI_GRAPHICS_CELOBJ32_H
 #define SCI_GRAPHICS_CELOBJ32_H
 
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/ptr.h"
 #include "common/rational.h"
 #include "common/rect.h"
 #include "sci/resource/resource.h"
@@ -106,7 +109,7 @@ struct CelInfo32 {
 
 	// This is the equivalence criteria used by CelObj::searchCache in at least
 	// SSCI SQ6. Notably, it does not check the color field.
-	inline bool operator==(const CelInfo32 &other) {
+	inline bool operator==(const CelInfo32 &other) const {
 		return (
 			type == other.type &&
 			resourceId == other.resourceId &&
@@ -116,7 +119,7 @@ struct CelInfo32 {
 		);
 	}
 
-	inline bool operator!=(const CelInfo32 &other) {
+	inline bool operator!=(const CelInfo32 &other) const {
 		return !(*this == other);
 	}
 
@@ -139,18 +142,144 @@ struct CelInfo32 {
 	}
 };
 
+struct CelInfo32_Hash {
+	uint operator()(const CelInfo32 &info) const {
+		// Like operator==, this ignores the color field
+		return (info.type << 28) ^ (info.resourceId << 12) ^ (info.loopNo << 8) ^ info.celNo ^
+			(info.bitmap.getSegment() << 16) ^ info.bitmap.getOffset();
+	}
+};
+
+struct CelCacheStats {
+	/** Lookups of cel objects which were found in the cache. */
+	uint32 hits;
+	/** Lookups of cel objects which had to be read from their resource. */
+	uint32 misses;
+	/** Draws of RLE cels which used the decompressed pixels in the cache. */
+	uint32 pixelHits;
+	/** Draws of RLE cels which had to decompress them. */
+	uint32 pixelMisses;
+
+	CelCacheStats() : hits(0), misses(0), pixelHits(0), pixelMisses(0) {}
+};
+
 class CelObj;
-struct CelCacheEntry {
+
+/**
+ * A cache of recently used cel objects, to avoid reading their headers again,
+ * and of the decompressed pixels of RLE cels, to avoid decompressing them
+ * again every time they are drawn.
+ *
+ * SSCI used a small array of cels which was searched linearly. This cache is
+ * indexed by CelInfo32 and drops the least recently used cels once there are
+ * too many of them, or once their pixels use more memory than allowed.
+ */
+class CelCache {
+public:
+	CelCache(uint maxCels, uint32 maxPixelMemory);
+	~CelCache();
+
 	/**
-	 * A monotonically increasing cache ID used to identify the least recently
-	 * used item in the cache for replacement.
+	 * Returns the cached copy of the cel matching the given CelInfo32, or
+	 * null.
 	 */
-	int id;
-	Common::ScopedPtr<CelObj> celObj;
-	CelCacheEntry() : id(0) {}
-};
+	const CelObj *findCel(const CelInfo32 &info);
+
+	/**
+	 * Puts a copy of the given cel into the cache.
+	 */
+	void putCel(const CelObj &celObj);
+
+	/**
+	 * Returns the cached decompressed pixels of the cel matching the given
+	 * CelInfo32, or null.
+	 */
+	const byte *findPixels(const CelInfo32 &info);
+
+	/**
+	 * Allocates a buffer in the cache for the given number of decompressed
+	 * pixels of a cel, to be filled by the caller. Returns null if the pixels
+	 * would not fit into the cache at all.
+	 */
+	byte *allocatePixels(const CelInfo32 &info, uint32 size);
+
+	/**
+	 * Finishes the statistics of the current frame.
+	 */
+	void endFrame();
+
+	/**
+	 * Returns the statistics of the last frame which used the cache.
+	 */
+	const CelCacheStats &getFrameStats() const { return _lastFrameStats; }
+
+	/**
+	 * Returns the statistics since the cache was created or last reset.
+	 */
+	const CelCacheStats &getTotalStats() const { return _totalStats; }
 
-typedef Common::Array<CelCacheEntry> CelCache;
+	void resetStats();
+
+	uint getCelCount() const { return _entries.size(); }
+	uint getMaxCels() const { return _maxCels; }
+	uint32 getPixelMemory() const { return _pixelMemory; }
+	uint32 getMaxPixelMemory() const { return _maxPixelMemory; }
+
+private:
+	typedef Common::List<CelInfo32> LRUList;
+
+	struct Entry {
+		/**
+		 * A copy of the cel, or null if only its pixels are cached.
+		 */
+		Common::ScopedPtr<CelObj> celObj;
+
+		/**
+		 * The decompressed pixels of the cel, or empty if they are not cached.
+		 */
+		Common::Array<byte> pixels;
+
+		/**
+		 * The position of the entry in the LRU list.
+		 */
+		LRUList::iterator lruPosition;
+	};
+
+	typedef Common::HashMap<CelInfo32, Entry *, CelInfo32_Hash> EntryMap;
+
+	EntryMap _entries;
+
+	/**
+	 * The keys of all entries, most recently used first.
+	 */
+	LRUList _lru;
+
+	uint _maxCels;
+	uint32 _maxPixelMemory;
+	uint32 _pixelMemory;
+
+	CelCacheStats _frameStats;
+	CelCacheStats _lastFrameStats;
+	CelCacheStats _totalStats;
+
+	/**
+	 * Returns the entry for the given CelInfo32 and marks it as the most
+	 * recently used one, or returns null.
+	 */
+	Entry *touch(const CelInfo32 &info);
+
+	/**
+	 * Returns the entry for the given CelInfo32, creating it if necessary, and
+	 * marks it as the most recently used one.
+	 */
+	Entry *touchOrCreate(const CelInfo32 &info);
+
+	/**
+	 * Drops the least recently used entries until the cache is within its
+	 * limits. The most recently used entry is always kept.
+	 */
+	void evict();
+};
 
 #pragma mark -
 #pragma mark CelScaler
@@ -454,12 +583,6 @@ private:
 #pragma mark -
 #pragma mark CelObj - Caching
 protected:
-	/**
-	 * A monotonically increasing cache ID used to identify the least recently
-	 * used item in the cache for replacement.
-	 */
-	static int _nextCacheId;
-
 	/**
 	 * A cache of cel objects used to avoid reinitialisation overhead for cels
 	 * with the same CelInfo32.
@@ -467,17 +590,21 @@ protected:
 	static Common::ScopedPtr<CelCache> _cache;
 
 	/**
-	 * Searches the cel cache for a CelObj matching the provided CelInfo32. If
-	 * not found, -1 is returned. `nextInsertIndex` will receive the index of
-	 * the oldest item in the cache, which can be used to replace the oldest
-	 * item with a newer item.
+	 * Searches the cel cache for a CelObj matching the provided CelInfo32.
+	 * If not found, null is returned.
 	 */
-	int searchCache(const CelInfo32 &celInfo, int *nextInsertIndex) const;
+	const CelObj *searchCache(const CelInfo32 &celInfo) const;
 
 	/**
-	 * Puts a copy of this CelObj into the cache at the given cache index.
+	 * Puts a copy of this CelObj into the cache.
+	 */
+	void putCopyInCache() const;
+
+public:
+	/**
+	 * Returns the cel cache, or null if it has not been initialised.
 	 */
-	void putCopyInCache(int index) const;
+	static CelCache *getCache() { return _cache.get(); }
 };
 
 #pragma mark -
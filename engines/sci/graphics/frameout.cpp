@@ -524,6 +524,8 @@ void GfxFrameout::frameOut(const bool shouldShowBits, const Common::Rect &eraseR
 	if (robotIsActive) {
 		robotPlayer.frameNowVisible();
 	}
+
+	CelObj::getCache()->endFrame();
 }
 
 void GfxFrameout::palMorphFrameOut(const int8 *styleRanges, PlaneShowStyle *showStyle) {
@@ -22,6 +22,7 @@
 
 // Resource library
 
+#include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
@@ -388,9 +389,10 @@ Common::SeekableReadStream *ResourceManager::getVolumeFile(ResourceSource *sourc
 		}
 		++it;
 	}
-	// adding a new file
+	// adding a new file. Volumes are read from all over and kept open, so
+	// large ones are mapped rather than read through a buffer.
 	file = new Common::File;
-	if (file->open(filename)) {
+	if (file->openMapped(filename)) {
 		if (_volumeFiles.size() == MAX_OPENED_VOLUMES) {
 			it = --_volumeFiles.end();
 			delete *it;
@@ -1081,7 +1083,20 @@ void ResourceManager::init() {
 	// cache, leading to constant decompression of picture resources
 	// and making the renderer very slow.
 	if (getSciVersion() >= SCI_VERSION_2) {
+#ifdef REDUCE_MEMORY_USAGE
 		_maxMemoryLRU = 4096 * 1024; // 4MiB
+#else
+		// The high resolution pics and views of many SCI32 games need more
+		// than 4MiB to keep the resources of a single room loaded
+		_maxMemoryLRU = 16384 * 1024; // 16MiB
+#endif
+	}
+
+	// Allow overriding the cache size, in KiB
+	if (!_detectionMode && ConfMan.hasKey("resource_cache_size")) {
+		const int cacheSize = ConfMan.getInt("resource_cache_size");
+		if (cacheSize > 0)
+			_maxMemoryLRU = MIN(cacheSize, 0x7FFFFFFF / 1024) * 1024;
 	}
 
 	switch (_viewType) {
@@ -1130,7 +1145,7 @@ void ResourceManager::removeFromLRU(Resource *res) {
 		warning("resMan: trying to remove resource that isn't enqueued");
 		return;
 	}
-	_LRU.remove(res);
+	_LRU.erase(res->_lruPosition);
 	_memoryLRU -= res->size();
 	res->_status = kResStatusAllocated;
 }
@@ -1141,6 +1156,7 @@ void ResourceManager::addToLRU(Resource *res) {
 		return;
 	}
 	_LRU.push_front(res);
+	res->_lruPosition = _LRU.begin();
 	_memoryLRU += res->size();
 #if SCI_VERBOSE_RESMAN
 	debug("Adding %s (%d bytes) to lru control: %d bytes total",
@@ -1150,6 +1166,11 @@ void ResourceManager::addToLRU(Resource *res) {
 	res->_status = kResStatusEnqueued;
 }
 
+void ResourceManager::resetCacheStats() {
+	for (int i = 0; i <= kResourceTypeInvalid; i++)
+		_cacheStats[i] = ResourceCacheStats();
+}
+
 void ResourceManager::printLRU() {
 	int mem = 0;
 	int entries = 0;
@@ -1173,6 +1194,7 @@ void ResourceManager::freeOldResources() {
 		Resource *goner = _LRU.back();
 		removeFromLRU(goner);
 		goner->unalloc();
+		_cacheStats[goner->getType()].evictions++;
 #ifdef SCI_VERBOSE_RESMAN
 		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
 #endif
@@ -1215,9 +1237,18 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return NULL;
 
-	if (retval->_status == kResStatusNoMalloc)
+	ResourceCacheStats &stats = _cacheStats[retval->getType()];
+	if (retval->_status == kResStatusNoMalloc) {
+		// Most loads take well below a millisecond
+		const uint64 startTime = g_system->getMicros();
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
+		stats.loadTime += g_system->getMicros() - startTime;
+		stats.misses++;
+	} else {
+		stats.hits++;
+	}
+
+	if (retval->_status == kResStatusEnqueued)
 		// The resource is removed from its current position
 		// in the LRU list because it has been requested
 		// again. Below, it will either be locked, or it
@@ -2245,6 +2276,11 @@ Resource *ResourceManager::updateResource(ResourceId resId, ResourceSource *src,
 		if (res == nullptr) {
 			res = new Resource(this, resId);
 			_resMap.setVal(resId, res);
+		} else if (res->_status == kResStatusEnqueued) {
+			// Its position in the LRU list would become stale, and its data
+			// would leak when it is loaded again from the new source
+			removeFromLRU(res);
+			res->unalloc();
 		}
 
 		res->_status = kResStatusNoMalloc;
@@ -298,6 +298,7 @@ protected:
 	int32 _fileOffset; /**< Offset in file */
 	ResourceStatus _status;
 	uint16 _lockers; /**< Number of places where this resource was locked */
+	Common::List<Resource *>::iterator _lruPosition; /**< Position in the LRU list while enqueued */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
 
@@ -312,6 +313,19 @@ protected:
 
 typedef Common::HashMap<ResourceId, Resource *, ResourceIdHash> ResourceMap;
 
+/**
+ * Statistics of the resource cache for one resource type, shown by the
+ * resource_cache console command.
+ */
+struct ResourceCacheStats {
+	uint32 hits; ///< Requests for resources which were still loaded
+	uint32 misses; ///< Requests which needed the resource to be loaded
+	uint64 loadTime; ///< Time spent reading and decompressing, in microseconds
+	uint32 evictions; ///< Resources freed to stay within the cache size
+
+	ResourceCacheStats() : hits(0), misses(0), loadTime(0), evictions(0) {}
+};
+
 class IntMapResourceSource;
 class ResourceManager {
 	// FIXME: These 'friend' declarations are meant to be a temporary hack to
@@ -369,6 +383,16 @@ public:
 	 */
 	void unlockResource(Resource *res);
 
+	/** Returns the number of bytes unlocked resources may keep allocated. */
+	int getCacheSize() const { return _maxMemoryLRU; }
+	/** Returns the number of bytes held by unlocked resources. */
+	int getCacheMemory() const { return _memoryLRU; }
+	/** Returns the number of bytes held by locked resources. */
+	int getLockedMemory() const { return _memoryLocked; }
+
+	const ResourceCacheStats &getCacheStats(ResourceType type) const { return _cacheStats[type]; }
+	void resetCacheStats();
+
 	/**
 	 * Tests whether a resource exists.
 	 *
@@ -490,6 +514,7 @@ protected:
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
 	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	ResourceCacheStats _cacheStats[kResourceTypeInvalid + 1];
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
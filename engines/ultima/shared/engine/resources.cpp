@@ -53,6 +53,9 @@ void Resources::addResource(const Common::String &name, const byte *data, size_t
 	lr._name = name;
 	lr._data.resize(size);
 	Common::copy(data, data + size, &lr._data[0]);
+
+	// SearchMan may remember that the resource was missing
+	Common::SearchSet::invalidateIndex();
 }
 
 bool Resources::hasFile(const Common::String &name) const {
@@ -0,0 +1,222 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/dirty_region.h"
+#include "graphics/surface.h"
+
+#include "common/endian.h"
+
+namespace Graphics {
+
+static inline uint32 rectArea(const Common::Rect &r) {
+	return (uint32)r.width() * r.height();
+}
+
+DirtyRegion::DirtyRegion(uint maxRects) : _maxRects(MAX<uint>(maxRects, 1)), _full(false) {
+}
+
+void DirtyRegion::setBounds(const Common::Rect &bounds) {
+	_bounds = bounds;
+	clear();
+}
+
+void DirtyRegion::clear() {
+	_rects.clear();
+	_full = false;
+}
+
+void DirtyRegion::addAll() {
+	_rects.clear();
+	_full = true;
+}
+
+uint32 DirtyRegion::mergeWaste(const Common::Rect &a, const Common::Rect &b) {
+	Common::Rect merged = a;
+	merged.extend(b);
+
+	const uint32 covered = rectArea(a) + rectArea(b) - rectArea(a.findIntersectingRect(b));
+	return rectArea(merged) - covered;
+}
+
+void DirtyRegion::add(const Common::Rect &rect) {
+	if (_full || rect.isEmpty())
+		return;
+
+	Common::Rect r = rect;
+	r.clip(_bounds);
+	if (r.isEmpty())
+		return;
+
+	// Merge with the rectangles whose union wastes at most a quarter of the
+	// pixels they cover. A merged rectangle may reach others, so start over
+	// after each merge.
+	bool merged;
+	do {
+		merged = false;
+		for (uint i = 0; i < _rects.size(); ++i) {
+			if (_rects[i].contains(r))
+				return;
+
+			const uint32 covered = rectArea(r) + rectArea(_rects[i]);
+			if (mergeWaste(r, _rects[i]) <= covered / 4) {
+				r.extend(_rects[i]);
+				_rects.remove_at(i);
+				merged = true;
+				break;
+			}
+		}
+	} while (merged);
+
+	if (_rects.size() >= _maxRects) {
+		// Out of rectangles, merge with the one wasting the fewest pixels
+		uint best = 0;
+		uint32 bestWaste = mergeWaste(r, _rects[0]);
+		for (uint i = 1; i < _rects.size(); ++i) {
+			const uint32 waste = mergeWaste(r, _rects[i]);
+			if (waste < bestWaste) {
+				best = i;
+				bestWaste = waste;
+			}
+		}
+
+		r.extend(_rects[best]);
+		_rects.remove_at(best);
+	}
+
+	_rects.push_back(r);
+	checkCoverage();
+}
+
+void DirtyRegion::checkCoverage() {
+	// Redrawing everything costs little more than redrawing three quarters
+	// of it, and saves handling each rectangle on its own
+	const uint32 total = rectArea(_bounds);
+	if (getArea() >= total - total / 4)
+		addAll();
+}
+
+const Common::Array<Common::Rect> &DirtyRegion::getRects() const {
+	if (!_full)
+		return _rects;
+
+	_fullRects.resize(1);
+	_fullRects[0] = _bounds;
+	return _fullRects;
+}
+
+uint32 DirtyRegion::getArea() const {
+	if (_full)
+		return rectArea(_bounds);
+
+	uint32 area = 0;
+	for (uint i = 0; i < _rects.size(); ++i)
+		area += rectArea(_rects[i]);
+	return area;
+}
+
+TileChecksums::TileChecksums() : _width(0), _height(0), _tilesPerRow(0) {
+}
+
+void TileChecksums::reset(int16 width, int16 height) {
+	_width = width;
+	_height = height;
+	_tilesPerRow = (width + kTileSize - 1) / kTileSize;
+
+	const uint tiles = _tilesPerRow * ((height + kTileSize - 1) / kTileSize);
+	_checksums.resize(tiles);
+	_valid.resize(tiles);
+	invalidateAll();
+}
+
+void TileChecksums::invalidateAll() {
+	for (uint i = 0; i < _valid.size(); ++i)
+		_valid[i] = false;
+}
+
+void TileChecksums::invalidate(const Common::Rect &rect) {
+	Common::Rect r = rect;
+	r.clip(_width, _height);
+	if (r.isEmpty())
+		return;
+
+	for (int ty = r.top / kTileSize; ty <= (r.bottom - 1) / kTileSize; ++ty) {
+		for (int tx = r.left / kTileSize; tx <= (r.right - 1) / kTileSize; ++tx)
+			_valid[ty * _tilesPerRow + tx] = false;
+	}
+}
+
+uint32 TileChecksums::computeChecksum(const Surface &screen, const Common::Rect &tile) const {
+	const uint bytes = tile.width() * screen.format.bytesPerPixel;
+
+	uint32 hash = 0x811C9DC5;
+	for (int y = tile.top; y < tile.bottom; ++y) {
+		const byte *src = (const byte *)screen.getBasePtr(tile.left, y);
+
+		uint i = 0;
+		for (; i + 4 <= bytes; i += 4)
+			hash = (((hash << 5) | (hash >> 27)) ^ READ_UINT32(src + i)) * 0x9E3779B1;
+		for (; i < bytes; ++i)
+			hash = (((hash << 5) | (hash >> 27)) ^ src[i]) * 0x9E3779B1;
+	}
+
+	return hash;
+}
+
+void TileChecksums::findChanged(const Surface &screen, const Common::Rect &rect, Common::Array<Common::Rect> &changed) {
+	assert(screen.w == _width && screen.h == _height);
+
+	Common::Rect r = rect;
+	r.clip(_width, _height);
+	if (r.isEmpty())
+		return;
+
+	for (int ty = r.top / kTileSize; ty <= (r.bottom - 1) / kTileSize; ++ty) {
+		const int16 top = MAX<int16>(ty * kTileSize, r.top);
+		const int16 bottom = MIN<int16>((ty + 1) * kTileSize, r.bottom);
+
+		// Start of the current run of changed tiles, or -1
+		int16 runLeft = -1;
+
+		for (int tx = r.left / kTileSize; tx <= (r.right - 1) / kTileSize; ++tx) {
+			const Common::Rect tile(tx * kTileSize, ty * kTileSize, MIN<int16>((tx + 1) * kTileSize, _width), MIN<int16>((ty + 1) * kTileSize, _height));
+			const uint index = ty * _tilesPerRow + tx;
+			const uint32 checksum = computeChecksum(screen, tile);
+
+			const bool tileChanged = !_valid[index] || _checksums[index] != checksum;
+			_checksums[index] = checksum;
+			_valid[index] = true;
+
+			if (tileChanged) {
+				if (runLeft < 0)
+					runLeft = MAX<int16>(tile.left, r.left);
+			} else if (runLeft >= 0) {
+				changed.push_back(Common::Rect(runLeft, top, tile.left, bottom));
+				runLeft = -1;
+			}
+		}
+
+		if (runLeft >= 0)
+			changed.push_back(Common::Rect(runLeft, top, r.right, bottom));
+	}
+}
+
+} // End of namespace Graphics
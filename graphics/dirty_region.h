@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_DIRTY_REGION_H
+#define GRAPHICS_DIRTY_REGION_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_dirty_region Dirty regions
+ * @ingroup graphics
+ *
+ * @brief Tracking of the parts of a screen which need to be redrawn.
+ * @{
+ */
+
+struct Surface;
+
+/**
+ * A set of rectangles which need to be redrawn.
+ *
+ * Rectangles which overlap or touch are merged as long as their union does
+ * not cover many pixels which were not dirty. Once the rectangles cover most
+ * of the bounds, or there would be too many of them, the whole area is
+ * considered dirty, since redrawing it in one go is cheaper.
+ */
+class DirtyRegion {
+public:
+	/**
+	 * @param maxRects The number of rectangles after which rectangles are
+	 *                 merged regardless of the pixels it wastes.
+	 */
+	explicit DirtyRegion(uint maxRects = 100);
+
+	/** Set the area the rectangles are clipped to, and clear the region. */
+	void setBounds(const Common::Rect &bounds);
+	const Common::Rect &getBounds() const { return _bounds; }
+
+	/** Add a rectangle to the region. */
+	void add(const Common::Rect &r);
+	/** Mark the whole area as dirty. */
+	void addAll();
+	/** Forget all the dirty rectangles. */
+	void clear();
+
+	bool isEmpty() const { return !_full && _rects.empty(); }
+	/** Return whether the whole area has to be redrawn. */
+	bool isFull() const { return _full; }
+
+	/**
+	 * Return the rectangles to redraw. They may overlap when merging them
+	 * would have wasted too many pixels.
+	 */
+	const Common::Array<Common::Rect> &getRects() const;
+
+	/** Return the number of pixels covered by the rectangles. */
+	uint32 getArea() const;
+
+private:
+	Common::Rect _bounds;
+	Common::Array<Common::Rect> _rects;
+	uint _maxRects;
+	bool _full;
+
+	/** The area of the bounds as a single rectangle, returned when full. */
+	mutable Common::Array<Common::Rect> _fullRects;
+
+	/** Return how many pixels the union of @p a and @p b covers that neither of them does. */
+	static uint32 mergeWaste(const Common::Rect &a, const Common::Rect &b);
+	/** Mark the region full if the rectangles cover most of the bounds. */
+	void checkCoverage();
+};
+
+/**
+ * Checksums of the tiles of a screen, to find out which parts of a surface
+ * really changed when it is rewritten.
+ *
+ * This helps with engines which copy the whole screen every frame, even
+ * when most of it stays the same.
+ */
+class TileChecksums {
+public:
+	enum {
+		kTileSize = 16
+	};
+
+	TileChecksums();
+
+	/** Track a screen of the given size. All tiles count as changed at first. */
+	void reset(int16 width, int16 height);
+
+	/** Forget the checksums of the tiles overlapping @p r, e.g. after drawing to it directly. */
+	void invalidate(const Common::Rect &r);
+	/** Forget all checksums. */
+	void invalidateAll();
+
+	/**
+	 * Compare the tiles overlapping @p r with their last checksums, and
+	 * remember the new ones.
+	 *
+	 * @param screen  the surface, of the size given to reset()
+	 * @param r       the area which was rewritten
+	 * @param changed receives the parts of @p r that changed, as one
+	 *                rectangle per run of changed tiles in a row of tiles
+	 */
+	void findChanged(const Surface &screen, const Common::Rect &r, Common::Array<Common::Rect> &changed);
+
+private:
+	int16 _width, _height;
+	int _tilesPerRow;
+	Common::Array<uint32> _checksums;
+	Common::Array<bool> _valid;
+
+	uint32 computeChecksum(const Surface &screen, const Common::Rect &tile) const;
+};
+
+/** @} */
+
+} // End of namespace Graphics
+
+#endif
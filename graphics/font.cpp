@@ -460,6 +460,9 @@ void Font::drawString(Surface *dst, const Common::String &str, int x, int y, int
 }
 
 void Font::drawString(Surface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const {
+	if (drawStringCached(dst, nullptr, str, x, y, w, color, align, deltax, useEllipsis))
+		return;
+
 	Common::U32String renderStr = useEllipsis ? handleEllipsis(*this, str, w) : str;
 	drawStringImpl(*this, dst, renderStr, x, y, w, color, align, deltax);
 }
@@ -474,6 +477,9 @@ void Font::drawString(ManagedSurface *dst, const Common::String &str, int x, int
 }
 
 void Font::drawString(ManagedSurface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const {
+	if (drawStringCached(dst->surfacePtr(), dst, str, x, y, w, color, align, deltax, useEllipsis))
+		return;
+
 	Common::U32String renderStr = useEllipsis ? handleEllipsis(*this, str, w) : str;
 	drawStringImpl(*this, dst, renderStr, x, y, w, color, align, deltax);
 
@@ -482,6 +488,10 @@ void Font::drawString(ManagedSurface *dst, const Common::U32String &str, int x,
 	}
 }
 
+Common::U32String Font::getEllipsizedString(const Common::U32String &str, int w) const {
+	return handleEllipsis(*this, str, w);
+}
+
 int Font::wordWrapText(const Common::String &str, int maxWidth, Common::Array<Common::String> &lines, int initWidth, uint32 mode) const {
 	return wordWrapTextImpl(*this, str, maxWidth, lines, initWidth, mode);
 }
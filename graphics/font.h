@@ -247,6 +247,27 @@ public:
 	int wordWrapText(const Common::String &str, int maxWidth, Common::Array<Common::String> &lines, int initWidth = 0, uint32 mode = kWordWrapOnExplicitNewLines) const;
 	/** @overload */
 	int wordWrapText(const Common::U32String &str, int maxWidth, Common::Array<Common::U32String> &lines, int initWidth = 0, uint32 mode = kWordWrapOnExplicitNewLines) const;
+
+protected:
+	/**
+	 * Draw a string on behalf of drawString, before the ellipsis is applied.
+	 *
+	 * Fonts which cache laid out strings can override this. The result
+	 * has to be the same as drawing the string character by character.
+	 *
+	 * @param managedDst  The managed surface drawn on, if any. Its
+	 *                    transparent color has to be honored and the drawn
+	 *                    area has to be marked as dirty.
+	 *
+	 * @return False to let drawString draw the string itself.
+	 */
+	virtual bool drawStringCached(Surface *dst, ManagedSurface *managedDst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const { return false; }
+
+	/**
+	 * Shorten @p str with an ellipsis in the middle so that it fits in
+	 * @p w pixels, like drawString does.
+	 */
+	Common::U32String getEllipsizedString(const Common::U32String &str, int w) const;
 };
 /** @} */
 } // End of namespace Graphics
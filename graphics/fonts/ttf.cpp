@@ -88,6 +88,10 @@ inline int divRoundToNearest(int dividend, int divisor) {
 	return (dividend + (divisor / 2)) / divisor;
 }
 
+uint g_textRunCacheSize = 256;
+uint32 g_textRunCacheHits = 0;
+uint32 g_textRunCacheMisses = 0;
+
 } // End of anonymous namespace
 
 class TTFLibrary : public Common::Singleton<TTFLibrary> {
@@ -111,6 +115,20 @@ void shutdownTTF() {
 	TTFLibrary::destroy();
 }
 
+void setTTFTextRunCacheSize(uint size) {
+	g_textRunCacheSize = size;
+}
+
+void getTTFTextRunCacheStats(uint32 &hits, uint32 &misses) {
+	hits = g_textRunCacheHits;
+	misses = g_textRunCacheMisses;
+}
+
+void resetTTFTextRunCacheStats() {
+	g_textRunCacheHits = 0;
+	g_textRunCacheMisses = 0;
+}
+
 #define g_ttf ::Graphics::TTFLibrary::instance()
 
 TTFLibrary::TTFLibrary() : _library(), _initialized(false) {
@@ -162,6 +180,9 @@ public:
 	virtual void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const;
 	virtual void drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const;
 
+protected:
+	virtual bool drawStringCached(Surface *dst, ManagedSurface *managedDst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const;
+
 private:
 	bool _initialized;
 	FT_Face _face;
@@ -173,7 +194,8 @@ private:
 	int _ascent, _descent;
 
 	struct Glyph {
-		Surface image;
+		uint page;
+		Common::Rect rect; ///< Area of the glyph image in its atlas page
 		int xOffset, yOffset;
 		int advance;
 		FT_UInt slot;
@@ -185,6 +207,64 @@ private:
 	bool _allowLateCaching;
 	void assureCached(uint32 chr) const;
 
+	enum {
+		kAtlasPageSize = 256
+	};
+
+	/**
+	 * The glyph images, packed in rows (shelves) into 8bpp pages. Pages are
+	 * only added, so glyphs and text runs can keep referring to them.
+	 */
+	mutable Common::Array<Surface *> _atlas;
+	mutable int _shelfX, _shelfY, _shelfHeight;
+	void allocateGlyph(int w, int h, uint &page, Common::Rect &rect) const;
+
+	struct TextRunKey {
+		Common::U32String str;
+		int w;
+		int deltax;
+		TextAlign align;
+		bool useEllipsis;
+	};
+
+	struct TextRunKey_Hash {
+		uint operator()(const TextRunKey &key) const {
+			return Common::Hash<Common::U32String>()(key.str) ^ ((uint)key.w << 8) ^ ((uint)key.deltax << 20) ^ ((uint)key.align << 2) ^ (uint)key.useEllipsis;
+		}
+	};
+
+	struct TextRunKey_EqualTo {
+		bool operator()(const TextRunKey &a, const TextRunKey &b) const {
+			return a.w == b.w && a.deltax == b.deltax && a.align == b.align && a.useEllipsis == b.useEllipsis && a.str == b.str;
+		}
+	};
+
+	struct RunGlyph {
+		uint page;
+		Common::Rect rect;
+		int x, y; ///< Position of the glyph image relative to the string
+	};
+
+	/**
+	 * A string laid out the way drawString would draw it, with the kerning,
+	 * alignment, ellipsis and clipping to the text area applied.
+	 */
+	struct TextRun {
+		TextRunKey key;
+		Common::Array<RunGlyph> glyphs;
+		Common::Rect bbox;
+		TextRun *prev, *next;
+	};
+
+	typedef Common::HashMap<TextRunKey, TextRun *, TextRunKey_Hash, TextRunKey_EqualTo> TextRunCache;
+	mutable TextRunCache _textRuns;
+	/** Most and least recently drawn text runs, the ends of the LRU list */
+	mutable TextRun *_firstRun, *_lastRun;
+
+	void layoutTextRun(TextRun &run) const;
+	void unlinkTextRun(TextRun *run) const;
+	void clearTextRuns() const;
+
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
 	int computePointSize(int size, TTFSizeMode sizeMode) const;
@@ -192,6 +272,8 @@ private:
 	int computePointSizeFromHeaders(int height) const;
 	void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color,
 		const uint32 *transparentColor) const;
+	void drawGlyph(Surface *dst, uint page, const Common::Rect &rect, int x, int y, uint32 color,
+		const uint32 *transparentColor) const;
 
 	FT_Int32 _loadFlags;
 	FT_Render_Mode _renderMode;
@@ -204,7 +286,8 @@ private:
 TTFFont::TTFFont()
 	: _initialized(false), _face(), _ttfFile(0), _size(0), _width(0), _height(0), _ascent(0),
 	  _descent(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
-	  _hasKerning(false), _allowLateCaching(false), _fakeBold(false), _fakeItalic(false) {
+	  _hasKerning(false), _allowLateCaching(false), _fakeBold(false), _fakeItalic(false),
+	  _shelfX(0), _shelfY(0), _shelfHeight(0), _firstRun(nullptr), _lastRun(nullptr) {
 }
 
 TTFFont::~TTFFont() {
@@ -214,11 +297,15 @@ TTFFont::~TTFFont() {
 		delete[] _ttfFile;
 		_ttfFile = 0;
 
-		for (GlyphCache::iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i)
-			i->_value.image.free();
-
 		_initialized = false;
 	}
+
+	clearTextRuns();
+
+	for (uint i = 0; i < _atlas.size(); ++i) {
+		_atlas[i]->free();
+		delete _atlas[i];
+	}
 }
 
 bool TTFFont::load(Common::SeekableReadStream &stream, int size, TTFSizeMode sizeMode,
@@ -598,8 +685,8 @@ Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
 	} else {
 		const int xOffset = glyphEntry->_value.xOffset;
 		const int yOffset = glyphEntry->_value.yOffset;
-		const Graphics::Surface &image = glyphEntry->_value.image;
-		return Common::Rect(xOffset, yOffset, xOffset + image.w, yOffset + image.h);
+		const Common::Rect &rect = glyphEntry->_value.rect;
+		return Common::Rect(xOffset, yOffset, xOffset + rect.width(), yOffset + rect.height());
 	}
 }
 
@@ -677,19 +764,24 @@ void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
 		return;
 
 	const Glyph &glyph = glyphEntry->_value;
+	drawGlyph(dst, glyph.page, glyph.rect, x + glyph.xOffset, y + glyph.yOffset, color, transparentColor);
+}
 
-	x += glyph.xOffset;
-	y += glyph.yOffset;
-
+void TTFFont::drawGlyph(Surface *dst, uint page, const Common::Rect &rect, int x, int y, uint32 color,
+		const uint32 *transparentColor) const {
 	if (x > dst->w)
 		return;
 	if (y > dst->h)
 		return;
 
-	int w = glyph.image.w;
-	int h = glyph.image.h;
+	int w = rect.width();
+	int h = rect.height();
 
-	const uint8 *srcPos = (const uint8 *)glyph.image.getPixels();
+	if (w <= 0 || h <= 0)
+		return;
+
+	const Surface &image = *_atlas[page];
+	const uint8 *srcPos = (const uint8 *)image.getBasePtr(rect.left, rect.top);
 
 	// Make sure we are not drawing outside the screen bounds
 	if (x < 0) {
@@ -705,7 +797,7 @@ void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
 		return;
 
 	if (y < 0) {
-		srcPos -= y * glyph.image.pitch;
+		srcPos -= y * image.pitch;
 		h += y;
 		y = 0;
 	}
@@ -734,15 +826,183 @@ void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
 			}
 
 			dstPos += dst->pitch;
-			srcPos += glyph.image.pitch;
+			srcPos += image.pitch;
 		}
 	} else if (dst->format.bytesPerPixel == 2) {
-		renderGlyph<uint16>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
+		renderGlyph<uint16>(dstPos, dst->pitch, srcPos, image.pitch, w, h, color, dst->format, transparentColor);
 	} else if (dst->format.bytesPerPixel == 4) {
-		renderGlyph<uint32>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
+		renderGlyph<uint32>(dstPos, dst->pitch, srcPos, image.pitch, w, h, color, dst->format, transparentColor);
 	}
 }
 
+bool TTFFont::drawStringCached(Surface *dst, ManagedSurface *managedDst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const {
+	assert(dst != 0);
+
+	if (!g_textRunCacheSize) {
+		if (!_textRuns.empty())
+			clearTextRuns();
+		return false;
+	}
+
+	TextRunKey key;
+	key.str = str;
+	key.w = w;
+	key.deltax = deltax;
+	key.align = align;
+	key.useEllipsis = useEllipsis;
+
+	TextRun *run;
+	TextRunCache::const_iterator runEntry = _textRuns.find(key);
+	if (runEntry != _textRuns.end()) {
+		++g_textRunCacheHits;
+		run = runEntry->_value;
+		unlinkTextRun(run);
+	} else {
+		++g_textRunCacheMisses;
+		while (_lastRun && _textRuns.size() >= g_textRunCacheSize) {
+			TextRun *oldest = _lastRun;
+			unlinkTextRun(oldest);
+			_textRuns.erase(oldest->key);
+			delete oldest;
+		}
+
+		run = new TextRun();
+		run->key = key;
+		layoutTextRun(*run);
+		_textRuns[key] = run;
+	}
+
+	// Move the run to the front of the LRU list
+	run->prev = nullptr;
+	run->next = _firstRun;
+	if (_firstRun)
+		_firstRun->prev = run;
+	_firstRun = run;
+	if (!_lastRun)
+		_lastRun = run;
+
+	uint32 transColor = 0;
+	const uint32 *transparentColor = nullptr;
+	if (managedDst && managedDst->hasTransparentColor()) {
+		transColor = managedDst->getTransparentColor();
+		transparentColor = &transColor;
+	}
+
+	for (uint i = 0; i < run->glyphs.size(); ++i) {
+		const RunGlyph &glyph = run->glyphs[i];
+		drawGlyph(dst, glyph.page, glyph.rect, x + glyph.x, y + glyph.y, color, transparentColor);
+	}
+
+	if (managedDst && !run->bbox.isEmpty()) {
+		Common::Rect dirty = run->bbox;
+		dirty.translate(x, y);
+		managedDst->addDirtyRect(dirty);
+	}
+
+	return true;
+}
+
+void TTFFont::layoutTextRun(TextRun &run) const {
+	// This follows drawStringImpl in graphics/font.cpp, for a string drawn
+	// at (0, 0).
+	const Common::U32String str = run.key.useEllipsis ? getEllipsizedString(run.key.str, run.key.w) : run.key.str;
+
+	const int rightX = run.key.w + 1;
+	const int width = getStringWidth(str);
+
+	int x = 0;
+	if (run.key.align == kTextAlignCenter)
+		x = (run.key.w - width) / 2;
+	else if (run.key.align == kTextAlignRight)
+		x = run.key.w - width;
+	x += run.key.deltax;
+
+	Common::U32String::unsigned_type last = 0;
+	for (Common::U32String::const_iterator i = str.begin(), end = str.end(); i != end; ++i) {
+		const Common::U32String::unsigned_type cur = *i;
+		x += getKerningOffset(last, cur);
+		last = cur;
+
+		Common::Rect charBox = getBoundingBox(cur);
+		if (x + charBox.right > rightX)
+			break;
+
+		GlyphCache::const_iterator glyphEntry = _glyphs.find(cur);
+		if (x + charBox.right >= 0 && glyphEntry != _glyphs.end() && !glyphEntry->_value.rect.isEmpty()) {
+			const Glyph &glyph = glyphEntry->_value;
+
+			RunGlyph runGlyph;
+			runGlyph.page = glyph.page;
+			runGlyph.rect = glyph.rect;
+			runGlyph.x = x + glyph.xOffset;
+			runGlyph.y = glyph.yOffset;
+			run.glyphs.push_back(runGlyph);
+
+			charBox.translate(x, 0);
+			if (run.bbox.isEmpty())
+				run.bbox = charBox;
+			else
+				run.bbox.extend(charBox);
+		}
+
+		x += getCharWidth(cur);
+	}
+}
+
+void TTFFont::unlinkTextRun(TextRun *run) const {
+	if (run->prev)
+		run->prev->next = run->next;
+	else
+		_firstRun = run->next;
+
+	if (run->next)
+		run->next->prev = run->prev;
+	else
+		_lastRun = run->prev;
+
+	run->prev = run->next = nullptr;
+}
+
+void TTFFont::clearTextRuns() const {
+	for (TextRunCache::iterator i = _textRuns.begin(), end = _textRuns.end(); i != end; ++i)
+		delete i->_value;
+
+	_textRuns.clear();
+	_firstRun = _lastRun = nullptr;
+}
+
+void TTFFont::allocateGlyph(int w, int h, uint &page, Common::Rect &rect) const {
+	if (w <= 0 || h <= 0) {
+		page = 0;
+		rect = Common::Rect(MAX(w, 0), MAX(h, 0));
+		return;
+	}
+
+	Surface *current = _atlas.empty() ? nullptr : _atlas.back();
+	if (current && _shelfX + w > current->w) {
+		// Start a new shelf below the current one
+		_shelfX = 0;
+		_shelfY += _shelfHeight;
+		_shelfHeight = 0;
+	}
+
+	if (!current || _shelfX + w > current->w || _shelfY + h > current->h) {
+		// Glyphs larger than a page get a page of their own
+		current = new Surface();
+		current->create(MAX<int>(w, kAtlasPageSize), MAX<int>(h, kAtlasPageSize), PixelFormat::createFormatCLUT8());
+		memset(current->getPixels(), 0, current->h * current->pitch);
+		_atlas.push_back(current);
+
+		_shelfX = _shelfY = _shelfHeight = 0;
+	}
+
+	page = _atlas.size() - 1;
+	rect = Common::Rect(_shelfX, _shelfY, _shelfX + w, _shelfY + h);
+
+	_shelfX += w;
+	_shelfHeight = MAX(_shelfHeight, h);
+}
+
 bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	FT_UInt slot = FT_Get_Char_Index(_face, chr);
 	if (!slot)
@@ -808,7 +1068,12 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	}
 
 
-	glyph.image.create(bitmap->width, bitmap->rows, PixelFormat::createFormatCLUT8());
+	if (bitmap->pixel_mode != FT_PIXEL_MODE_MONO && bitmap->pixel_mode != FT_PIXEL_MODE_GRAY) {
+		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
+		return false;
+	}
+
+	allocateGlyph(bitmap->width, bitmap->rows, glyph.page, glyph.rect);
 
 	const uint8 *src = bitmap->buffer;
 	int srcPitch = bitmap->pitch;
@@ -817,11 +1082,13 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		srcPitch = -srcPitch;
 	}
 
-	uint8 *dst = (uint8 *)glyph.image.getPixels();
-	memset(dst, 0, glyph.image.h * glyph.image.pitch);
+	// The atlas pages are cleared when created
+	uint8 *dst = glyph.rect.isEmpty() ? nullptr : (uint8 *)_atlas[glyph.page]->getBasePtr(glyph.rect.left, glyph.rect.top);
+	const int dstPitch = glyph.rect.isEmpty() ? 0 : _atlas[glyph.page]->pitch;
 
-	switch (bitmap->pixel_mode) {
-	case FT_PIXEL_MODE_MONO:
+	if (!dst) {
+		// Nothing to draw, e.g. a space
+	} else if (bitmap->pixel_mode == FT_PIXEL_MODE_MONO) {
 		for (int y = 0; y < (int)bitmap->rows; ++y) {
 			const uint8 *curSrc = src;
 			uint8 mask = 0;
@@ -831,28 +1098,20 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 					mask = *curSrc++;
 
 				if (mask & 0x80)
-					*dst = 255;
+					dst[x] = 255;
 
 				mask <<= 1;
-				++dst;
 			}
 
+			dst += dstPitch;
 			src += srcPitch;
 		}
-		break;
-
-	case FT_PIXEL_MODE_GRAY:
+	} else {
 		for (int y = 0; y < (int)bitmap->rows; ++y) {
 			memcpy(dst, src, bitmap->width);
-			dst += glyph.image.pitch;
+			dst += dstPitch;
 			src += srcPitch;
 		}
-		break;
-
-	default:
-		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
-		glyph.image.free();
-		return false;
 	}
 
 #if FAKE_BOLD == 1
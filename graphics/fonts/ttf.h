@@ -141,6 +141,23 @@ Font *findTTFace(const Common::Array<Common::String> &files, const Common::U32St
 
 void shutdownTTF();
 
+/**
+ * Set how many laid out strings each TTF font keeps to speed up drawing
+ * them again. The least recently drawn strings are dropped first.
+ *
+ * @param size  The number of strings per font, 0 disables the cache.
+ */
+void setTTFTextRunCacheSize(uint size);
+
+/**
+ * Return how many strings drawn with TTF fonts were found in the cache,
+ * and how many had to be laid out, since the last reset.
+ */
+void getTTFTextRunCacheStats(uint32 &hits, uint32 &misses);
+
+/** Reset the counters returned by getTTFTextRunCacheStats. */
+void resetTTFTextRunCacheStats();
+
 } // End of namespace Graphics
 
 #endif
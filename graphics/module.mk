@@ -3,6 +3,7 @@ MODULE := graphics
 MODULE_OBJS := \
 	conversion.o \
 	cursorman.o \
+	dirty_region.o \
 	font.o \
 	fontman.o \
 	fonts/amigafont.o \
@@ -23,6 +23,14 @@
 #include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2_HQX
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define USE_NEON_HQX
+#include <arm_neon.h>
+#endif
+
 // RGB-to-YUV lookup table
 extern "C" {
 
@@ -214,6 +222,154 @@ static inline uint32 ConvertYUV(uint32 x) {
 	return RGBtoYUV[r | g | b];
 }
 
+/**
+ * Computes the blending patterns of the HQx filters, one source row at a time.
+ *
+ * Bit n of a pixel's pattern is set when its n-th neighbour (w1-w4, w6-w9)
+ * differs noticeably from it in YUV space. The YUV values of each source
+ * row are looked up once and kept for the next two rows, and the patterns
+ * of a row are then worked out for several pixels at once with SSE2 or
+ * NEON when available.
+ */
+template<typename ColorMask>
+class HQxPatterns {
+	typedef typename ColorMask::PixelType Pixel;
+
+public:
+	HQxPatterns(const Pixel *p, uint32 nextlineSrc, int width) : _nextlineSrc(nextlineSrc), _width(width) {
+		// One extra pixel on either side, and padding for the last vector
+		_rowSize = width + 2 + 4;
+		_buffer = new uint32[3 * _rowSize];
+		memset(_buffer, 0, 3 * _rowSize * sizeof(uint32));
+		_patterns = new uint8[width + 4];
+
+		_above = _buffer;
+		_row = _buffer + _rowSize;
+		_below = _buffer + 2 * _rowSize;
+		convertRow(p - nextlineSrc, _above);
+		convertRow(p, _row);
+	}
+
+	~HQxPatterns() {
+		delete[] _patterns;
+		delete[] _buffer;
+	}
+
+	/**
+	 * Return the patterns of the row starting at p. Rows have to be passed
+	 * in order, starting with the one given to the constructor.
+	 */
+	const uint8 *next(const Pixel *p) {
+		convertRow(p + _nextlineSrc, _below);
+		computePatterns();
+
+		uint32 *tmp = _above;
+		_above = _row;
+		_row = _below;
+		_below = tmp;
+		return _patterns;
+	}
+
+private:
+	void convertRow(const Pixel *p, uint32 *yuv) {
+		for (int i = -1; i <= _width; ++i)
+			yuv[i + 1] = sizeof(Pixel) == 2 ? RGBtoYUV[p[i]] : ConvertYUV<ColorMask>(p[i]);
+	}
+
+#if defined(USE_SSE2_HQX)
+	static inline __m128i diffYUV4(__m128i yuv1, __m128i yuv2, __m128i mask, __m128i threshold) {
+		__m128i diff = _mm_sub_epi32(_mm_and_si128(yuv1, mask), _mm_and_si128(yuv2, mask));
+		const __m128i sign = _mm_srai_epi32(diff, 31);
+		diff = _mm_sub_epi32(_mm_xor_si128(diff, sign), sign);
+		return _mm_cmpgt_epi32(diff, threshold);
+	}
+
+	static inline __m128i diffYUV4(__m128i yuv1, const uint32 *yuv2, int bit) {
+		const __m128i other = _mm_loadu_si128((const __m128i *)yuv2);
+		__m128i diff = diffYUV4(yuv1, other, _mm_set1_epi32(0x0000FF00), _mm_set1_epi32(0x00000700));
+		diff = _mm_or_si128(diff, diffYUV4(yuv1, other, _mm_set1_epi32(0x000000FF), _mm_set1_epi32(0x00000006)));
+		diff = _mm_or_si128(diff, diffYUV4(yuv1, other, _mm_set1_epi32(0x00FF0000), _mm_set1_epi32(0x00300000)));
+		return _mm_and_si128(diff, _mm_set1_epi32(bit));
+	}
+
+	void computePatterns() {
+		for (int x = 0; x < _width; x += 4) {
+			const __m128i yuv5 = _mm_loadu_si128((const __m128i *)(_row + x + 1));
+			__m128i pattern = diffYUV4(yuv5, _above + x, 0x01);
+			pattern = _mm_or_si128(pattern, diffYUV4(yuv5, _above + x + 1, 0x02));
+			pattern = _mm_or_si128(pattern, diffYUV4(yuv5, _above + x + 2, 0x04));
+			pattern = _mm_or_si128(pattern, diffYUV4(yuv5, _row + x, 0x08));
+			pattern = _mm_or_si128(pattern, diffYUV4(yuv5, _row + x + 2, 0x10));
+			pattern = _mm_or_si128(pattern, diffYUV4(yuv5, _below + x, 0x20));
+			pattern = _mm_or_si128(pattern, diffYUV4(yuv5, _below + x + 1, 0x40));
+			pattern = _mm_or_si128(pattern, diffYUV4(yuv5, _below + x + 2, 0x80));
+
+			pattern = _mm_packs_epi32(pattern, pattern);
+			pattern = _mm_packus_epi16(pattern, pattern);
+			const uint32 packed = _mm_cvtsi128_si32(pattern);
+			memcpy(_patterns + x, &packed, 4);
+		}
+	}
+#elif defined(USE_NEON_HQX)
+	static inline uint32x4_t diffYUV4(uint32x4_t yuv1, uint32x4_t yuv2, uint32 mask, int32 threshold) {
+		const int32x4_t component1 = vreinterpretq_s32_u32(vandq_u32(yuv1, vdupq_n_u32(mask)));
+		const int32x4_t component2 = vreinterpretq_s32_u32(vandq_u32(yuv2, vdupq_n_u32(mask)));
+		return vcgtq_s32(vabdq_s32(component1, component2), vdupq_n_s32(threshold));
+	}
+
+	static inline uint32x4_t diffYUV4(uint32x4_t yuv1, const uint32 *yuv2, uint32 bit) {
+		const uint32x4_t other = vld1q_u32(yuv2);
+		uint32x4_t diff = diffYUV4(yuv1, other, 0x0000FF00, 0x00000700);
+		diff = vorrq_u32(diff, diffYUV4(yuv1, other, 0x000000FF, 0x00000006));
+		diff = vorrq_u32(diff, diffYUV4(yuv1, other, 0x00FF0000, 0x00300000));
+		return vandq_u32(diff, vdupq_n_u32(bit));
+	}
+
+	void computePatterns() {
+		for (int x = 0; x < _width; x += 4) {
+			const uint32x4_t yuv5 = vld1q_u32(_row + x + 1);
+			uint32x4_t pattern = diffYUV4(yuv5, _above + x, 0x01);
+			pattern = vorrq_u32(pattern, diffYUV4(yuv5, _above + x + 1, 0x02));
+			pattern = vorrq_u32(pattern, diffYUV4(yuv5, _above + x + 2, 0x04));
+			pattern = vorrq_u32(pattern, diffYUV4(yuv5, _row + x, 0x08));
+			pattern = vorrq_u32(pattern, diffYUV4(yuv5, _row + x + 2, 0x10));
+			pattern = vorrq_u32(pattern, diffYUV4(yuv5, _below + x, 0x20));
+			pattern = vorrq_u32(pattern, diffYUV4(yuv5, _below + x + 1, 0x40));
+			pattern = vorrq_u32(pattern, diffYUV4(yuv5, _below + x + 2, 0x80));
+
+			const uint16x4_t narrow = vmovn_u32(pattern);
+			const uint8x8_t packed = vmovn_u16(vcombine_u16(narrow, narrow));
+			vst1_lane_u32((uint32 *)(_patterns + x), vreinterpret_u32_u8(packed), 0);
+		}
+	}
+#else
+	void computePatterns() {
+		for (int x = 0; x < _width; ++x) {
+			// Equal pixels have equal YUV values, so there is no need to
+			// compare the pixels first
+			const int yuv5 = _row[x + 1];
+			int pattern = 0;
+			if (diffYUV(yuv5, _above[x])) pattern |= 0x0001;
+			if (diffYUV(yuv5, _above[x + 1])) pattern |= 0x0002;
+			if (diffYUV(yuv5, _above[x + 2])) pattern |= 0x0004;
+			if (diffYUV(yuv5, _row[x])) pattern |= 0x0008;
+			if (diffYUV(yuv5, _row[x + 2])) pattern |= 0x0010;
+			if (diffYUV(yuv5, _below[x])) pattern |= 0x0020;
+			if (diffYUV(yuv5, _below[x + 1])) pattern |= 0x0040;
+			if (diffYUV(yuv5, _below[x + 2])) pattern |= 0x0080;
+			_patterns[x] = pattern;
+		}
+	}
+#endif
+
+	const uint32 _nextlineSrc;
+	const int _width;
+	int _rowSize;
+	uint32 *_buffer;
+	uint32 *_above, *_row, *_below;
+	uint8 *_patterns;
+};
+
 /*
  * The HQ2x high quality 2x graphics filter.
  * Original author Maxim Stepin (see http://www.hiend3d.com/hq2x.html).
@@ -242,7 +398,11 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	HQxPatterns<ColorMask> rowPatterns(p, nextlineSrc, width);
+
 	while (height--) {
+		const uint8 *patterns = rowPatterns.next(p);
+
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
 		w7 = *(p - 1 + nextlineSrc);
@@ -259,16 +419,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			const int pattern = *patterns++;
 
 			switch (pattern) {
 			case 0:
@@ -2180,7 +2331,11 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	HQxPatterns<ColorMask> rowPatterns(p, nextlineSrc, width);
+
 	while (height--) {
+		const uint8 *patterns = rowPatterns.next(p);
+
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
 		w7 = *(p - 1 + nextlineSrc);
@@ -2197,16 +2352,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			const int pattern = *patterns++;
 
 			switch (pattern) {
 			case 0:
@@ -21,6 +21,8 @@
 
 #include "graphics/scalerplugin.h"
 
+#include "common/worker-pool.h"
+
 void ScalerPluginObject::initialize(const Graphics::PixelFormat &format) {
 	_format = format;
 }
@@ -47,6 +49,39 @@ void Normal1x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 }
 } // End of anonymous namespace
 
+namespace {
+enum {
+	kMaxBands = 16,
+	kMinBandRows = 4,
+	kMinBandPixels = 4096
+};
+} // End of anonymous namespace
+
+class ScalerPluginObject::BandJob : public Common::WorkerJob {
+public:
+	void run() override {
+		_scaler->scaleIntern(_srcPtr, _srcPitch, _dstPtr, _dstPitch, _width, _height, _x, _y);
+	}
+
+	ScalerPluginObject *_scaler;
+	const uint8 *_srcPtr;
+	uint32 _srcPitch;
+	uint8 *_dstPtr;
+	uint32 _dstPitch;
+	int _width, _height, _x, _y;
+};
+
+uint ScalerPluginObject::getNumBands(int width, int height) const {
+	if (!_workerPool)
+		return 1;
+
+	uint numBands = _numBands ? _numBands : _workerPool->getThreadCount() + 1;
+	numBands = MIN<uint>(numBands, kMaxBands);
+	numBands = MIN<uint>(numBands, height / kMinBandRows);
+	numBands = MIN<uint>(numBands, width * height / kMinBandPixels);
+	return MAX<uint>(numBands, 1);
+}
+
 void ScalerPluginObject::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                           uint32 dstPitch, int width, int height, int x, int y) {
 	if (_factor == 1) {
@@ -55,9 +90,37 @@ void ScalerPluginObject::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstP
 		} else {
 			Normal1x<uint32>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 		}
-	} else {
+		return;
+	}
+
+	const uint numBands = getNumBands(width, height);
+	if (numBands == 1) {
 		scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+	} else {
+		// The bands only write to their own rows of the destination, and
+		// finishScale() runs after all of them, so neighbouring bands still
+		// see the state from before this call in the rows they overlap.
+		BandJob jobs[kMaxBands];
+		for (uint i = 0; i < numBands; ++i) {
+			const int top = height * i / numBands;
+			const int bottom = height * (i + 1) / numBands;
+
+			BandJob &job = jobs[i];
+			job._scaler = this;
+			job._srcPtr = srcPtr + top * srcPitch;
+			job._srcPitch = srcPitch;
+			job._dstPtr = dstPtr + top * _factor * dstPitch;
+			job._dstPitch = dstPitch;
+			job._width = width;
+			job._height = bottom - top;
+			job._x = x;
+			job._y = y + top;
+			_workerPool->addJob(&job);
+		}
+		_workerPool->wait();
 	}
+
+	finishScale(srcPtr, srcPitch, width, height, x, y);
 }
 
 SourceScaler::SourceScaler() : _width(0), _height(0), _oldSrc(NULL), _enable(false) {
@@ -126,8 +189,14 @@ void SourceScaler::scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstP
 		buffer += _bufferedOutput.pitch;
 		dstPtr += dstPitch;
 	}
+}
+
+void SourceScaler::finishScale(const uint8 *srcPtr, uint32 srcPitch, int width, int height, int x, int y) {
+	if (!_enable)
+		return;
 
-	// Update old src
+	// Update old src, once the other bands no longer read it
+	int offset = (_padding + x) * _format.bytesPerPixel + (_padding + y) * srcPitch;
 	byte *oldSrc = _oldSrc + offset;
 	while (height--) {
 		memcpy(oldSrc, srcPtr, width * _format.bytesPerPixel);
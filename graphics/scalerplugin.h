@@ -26,9 +26,14 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+namespace Common {
+class WorkerPool;
+}
+
 class ScalerPluginObject : public PluginObject {
 public:
 
+	ScalerPluginObject() : _workerPool(nullptr), _numBands(0) {}
 	virtual ~ScalerPluginObject() {}
 
 	/**
@@ -47,6 +52,10 @@ public:
 	/**
 	 * Scale a rect.
 	 *
+	 * If a worker pool has been set, large rects are split into horizontal
+	 * bands which are scaled in parallel. Each band still reads the source
+	 * pixels around it, up to extraPixels(), so the result is the same.
+	 *
 	 * @param srcPtr   Pointer to the source buffer.
 	 * @param srcPitch The number of bytes in a scanline of the source.
 	 * @param dstPtr   Pointer to the destination buffer.
@@ -59,6 +68,20 @@ public:
 	void scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	           uint32 dstPitch, int width, int height, int x, int y);
 
+	/**
+	 * Set the pool scale() runs bands on. The pool is not owned by the
+	 * scaler and has to outlive it, or be unset again.
+	 *
+	 * @param pool     The pool to use, or nullptr to scale in the calling thread only.
+	 * @param numBands The maximum number of bands a rect is split into. By
+	 *                 default, one band per pool thread plus one for the
+	 *                 calling thread.
+	 */
+	void setWorkerPool(Common::WorkerPool *pool, uint numBands = 0) {
+		_workerPool = pool;
+		_numBands = numBands;
+	}
+
 	/**
 	 * Increase the factor of scaling.
 	 * @return The new factor
@@ -150,14 +173,30 @@ public:
 
 protected:
 	/**
+	 * Scale a rect, or a band of it. This may be called for several bands
+	 * of the same rect at once, from different threads.
+	 *
 	 * @see scale
 	 */
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                         uint32 dstPitch, int width, int height, int x, int y) = 0;
 
+	/**
+	 * Called by scale() once all bands of a rect have been scaled.
+	 */
+	virtual void finishScale(const uint8 *srcPtr, uint32 srcPitch, int width, int height, int x, int y) {}
+
 	uint _factor;
 	Common::Array<uint> _factors;
 	Graphics::PixelFormat _format;
+
+private:
+	class BandJob;
+
+	uint getNumBands(int width, int height) const;
+
+	Common::WorkerPool *_workerPool;
+	uint _numBands;
 };
 
 /**
@@ -184,12 +223,16 @@ protected:
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                         uint32 dstPitch, int width, int height, int x, int y) final;
 
+	virtual void finishScale(const uint8 *srcPtr, uint32 srcPitch, int width, int height, int x, int y) final;
+
 	/**
 	 * Scalers must implement this function. It will be called by oldSrcScale.
 	 * If by comparing the src and oldsrc images it is discovered that no change
 	 * is necessary, do not write a pixel.
 	 *
 	 * If oldSrcPtr is NULL, do not read from it. Scale every pixel.
+	 *
+	 * Like scaleIntern(), this may run for several bands of a rect at once.
 	 */
 	virtual void internScale(const uint8 *srcPtr, uint32 srcPitch,
 	                         uint8 *dstPtr, uint32 dstPitch,
@@ -211,6 +254,12 @@ class ScalerManager : public Common::Singleton<ScalerManager> {
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 
+	ScalerManager();
+	~ScalerManager();
+
+	Common::WorkerPool *_workerPool;
+	bool _workerPoolCreated;
+
 public:
 	const PluginList &getPlugins() const;
 
@@ -235,6 +284,16 @@ public:
 	 * Update scaler settings from older versions of ScummVM.
 	 */
 	void updateOldSettings();
+
+	/**
+	 * Return the pool shared by all scalers for scaling in bands, which is
+	 * started on first use. The number of threads is taken from the
+	 * "scaler_threads" setting.
+	 *
+	 * @return The pool, or nullptr if scaling should not use extra threads.
+	 * @see ScalerPluginObject::setWorkerPool
+	 */
+	Common::WorkerPool *getWorkerPool();
 };
 
 /** Convenience shortcut for accessing singleton */
@@ -850,6 +850,9 @@ void tglTexCoordPointer(TGLint size, TGLenum type, TGLsizei stride, const TGLvoi
 void tglPolygonOffset(TGLfloat factor, TGLfloat units);
 
 void tglEnableDirtyRects(bool enable);
+// Rasterize in horizontal tiles on worker threads. With numThreads < 0, the
+// count depends on the number of cores, and tiling is off on a single core.
+void tglEnableTiledRendering(bool enable, int numThreads = -1);
 
 void tglDebug(int mode);
 
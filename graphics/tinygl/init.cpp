@@ -235,6 +235,9 @@ void glInit(void *zbuffer1, int textureSize) {
 	c->_drawCallAllocator[1].initialize(kDrawCallMemory);
 	c->_enableDirtyRectangles = true;
 
+	c->_renderPool = nullptr;
+	tglSetupTiledRendering(c, true, -1);
+
 	Graphics::Internal::tglBlitResetScissorRect();
 }
 
@@ -243,6 +246,7 @@ void glClose() {
 
 	tglDisposeDrawCallLists(c);
 	tglDisposeResources(c);
+	tglDisposeTiledRendering(c);
 
 	specbuf_cleanup(c);
 	for (int i = 0; i < 3; i++)
@@ -80,7 +80,7 @@ void memset_l(void *adr, int val, int count) {
 		*p++ = val;
 }
 
-FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &frame_buffer) : _depthWrite(true), _enableScissor(false) {
+FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &frame_buffer) : _zbufAllocated(true), _depthWrite(true), _enableScissor(false) {
 	this->xsize = width;
 	this->ysize = height;
 	this->cmode = frame_buffer.getFormat();
@@ -106,7 +106,7 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &fra
 	_depthFunc = TGL_LESS;
 }
 
-FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &format) : _depthWrite(true), _enableScissor(false) {
+FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &format) : _zbufAllocated(true), _depthWrite(true), _enableScissor(false) {
 	this->xsize = width;
 	this->ysize = height;
 	this->cmode = format;
@@ -133,10 +133,17 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_depthFunc = TGL_LESS;
 }
 
+FrameBuffer::FrameBuffer(const FrameBuffer &other) {
+	*this = other;
+	this->frame_buffer_allocated = 0;
+	_zbufAllocated = false;
+}
+
 FrameBuffer::~FrameBuffer() {
 	if (frame_buffer_allocated)
 		pbuf.free();
-	gl_free(_zbuf);
+	if (_zbufAllocated)
+		gl_free(_zbuf);
 }
 
 Buffer *FrameBuffer::genOffscreenBuffer() {
@@ -103,6 +103,11 @@ struct ZBufferPoint {
 struct FrameBuffer {
 	FrameBuffer(int xsize, int ysize, const Graphics::PixelBuffer &frame_buffer);
 	FrameBuffer(int xsize, int ysize, const Graphics::PixelFormat &format);
+	/**
+	 * Create a view of the color and depth buffers of another frame buffer.
+	 * The view has its own rendering state, but doesn't own the buffers.
+	 */
+	FrameBuffer(const FrameBuffer &other);
 	~FrameBuffer();
 
 	Buffer *genOffscreenBuffer();
@@ -500,6 +505,8 @@ struct FrameBuffer {
 
 private:
 
+	FrameBuffer &operator=(const FrameBuffer &other) = default;
+
 	template <bool kDepthWrite>
 	FORCEINLINE void putPixel(unsigned int pixelOffset, int color, int x, int y, unsigned int z);
 
@@ -516,6 +523,7 @@ private:
 	void drawLine(const ZBufferPoint *p1, const ZBufferPoint *p2);
 
 	unsigned int *_zbuf;
+	bool _zbufAllocated;
 	bool _depthWrite;
 	Graphics::PixelBuffer pbuf;
 	bool _blendingEnabled;
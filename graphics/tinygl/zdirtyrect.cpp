@@ -31,6 +31,7 @@
 #include "graphics/tinygl/gl.h"
 #include "common/debug.h"
 #include "common/math.h"
+#include "common/worker-pool.h"
 
 namespace TinyGL {
 
@@ -113,13 +114,160 @@ void tglDisposeDrawCallLists(TinyGL::GLContext *c) {
 	c->_drawCallsQueue.clear();
 }
 
+enum {
+	kMaxRenderThreads = 7,
+	kTilesPerThread = 4,
+	kMinTileHeight = 16
+};
+
+/**
+ * Replays the draw calls binned into one horizontal band of the frame, on a
+ * context and frame buffer view of its own. Tiles only touch their own rows
+ * of the color and depth buffers, so they can be rasterized in parallel.
+ */
+struct TileRenderer : public Common::WorkerJob {
+	struct BinnedCall {
+		const Graphics::DrawCall *call;
+		Common::Rect clip;
+
+		BinnedCall() : call(nullptr) { }
+		BinnedCall(const Graphics::DrawCall *drawCall, const Common::Rect &clipRect) : call(drawCall), clip(clipRect) { }
+	};
+
+	GLContext *_context;
+	Common::Rect _tile;
+	Common::Array<BinnedCall> _bin;
+
+	TileRenderer() {
+		_context = new GLContext();
+		_context->vertex_max = POLYGON_MAX_VERTEX;
+		_context->vertex = (GLVertex *)gl_malloc(POLYGON_MAX_VERTEX * sizeof(GLVertex));
+	}
+
+	~TileRenderer() {
+		gl_free(_context->vertex);
+		delete _context->fb;
+		delete _context;
+	}
+
+	void begin(const GLContext *c, const Common::Rect &tile) {
+		// The main frame buffer may have switched to an offscreen buffer since the last frame
+		delete _context->fb;
+		_context->fb = new FrameBuffer(*c->fb);
+		_context->renderRect = c->renderRect;
+		_context->render_mode = c->render_mode;
+		_context->current_cull_face = c->current_cull_face;
+		_context->vertex_n = c->vertex_n;
+		_context->_textureSize = c->_textureSize;
+		_tile = tile;
+	}
+
+	void run() override {
+		for (uint i = 0; i < _bin.size(); ++i) {
+			const Graphics::DrawCall *call = _bin[i].call;
+			if (call->getType() == Graphics::DrawCall::DrawCall_Rasterization) {
+				((const Graphics::RasterizationDrawCall *)call)->executeTile(_context, _bin[i].clip);
+			} else {
+				((const Graphics::ClearBufferDrawCall *)call)->executeTile(_context, _bin[i].clip);
+			}
+		}
+		_bin.clear();
+	}
+};
+
+void tglSetupTiledRendering(GLContext *c, bool enable, int numThreads) {
+	tglDisposeTiledRendering(c);
+	if (!enable)
+		return;
+
+	if (numThreads < 0) {
+		// Tiles only pay off when they are rasterized in parallel
+		numThreads = Common::WorkerPool::getDefaultThreadCount(kMaxRenderThreads);
+		if (numThreads == 0)
+			return;
+	}
+
+	c->_renderPool = new Common::WorkerPool(numThreads);
+	const uint numTiles = kTilesPerThread * (c->_renderPool->getThreadCount() + 1);
+	for (uint i = 0; i < numTiles; ++i)
+		c->_tileRenderers.push_back(new TileRenderer());
+}
+
+void tglDisposeTiledRendering(GLContext *c) {
+	delete c->_renderPool;
+	c->_renderPool = nullptr;
+	for (uint i = 0; i < c->_tileRenderers.size(); ++i)
+		delete c->_tileRenderers[i];
+	c->_tileRenderers.clear();
+}
+
+// Execute the draw calls clipped to the given rectangles, with rasterization and
+// clears binned into horizontal tiles. Blits use the global context, they are
+// executed in between on this thread.
+static void tglExecuteTiled(GLContext *c, const Common::List<DirtyRectangle> &rectangles) {
+	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
+	typedef Common::List<TinyGL::DirtyRectangle>::const_iterator RectangleIterator;
+
+	const Common::Rect &renderRect = c->renderRect;
+	const int numTiles = MAX(1, MIN<int>(c->_tileRenderers.size(), renderRect.height() / kMinTileHeight));
+	for (int i = 0; i < numTiles; ++i) {
+		const int top = renderRect.top + renderRect.height() * i / numTiles;
+		const int bottom = renderRect.top + renderRect.height() * (i + 1) / numTiles;
+		c->_tileRenderers[i]->begin(c, Common::Rect(renderRect.left, top, renderRect.right, bottom));
+	}
+
+	DrawCallIterator it = c->_drawCallsQueue.begin();
+	DrawCallIterator end = c->_drawCallsQueue.end();
+	while (it != end) {
+		if ((*it)->getType() == Graphics::DrawCall::DrawCall_Blitting) {
+			if (!c->_enableDirtyRectangles) {
+				(*it)->execute(true);
+			} else {
+				Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+				for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
+					if ((*itRect).rectangle.intersects(drawCallRegion)) {
+						(*it)->execute((*itRect).rectangle, true);
+					}
+				}
+			}
+			++it;
+			continue;
+		}
+
+		// Bin everything up to the next blit
+		for ( ; it != end && (*it)->getType() != Graphics::DrawCall::DrawCall_Blitting; ++it) {
+			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
+				const Common::Rect &dirtyRegion = (*itRect).rectangle;
+				if (!dirtyRegion.intersects(drawCallRegion))
+					continue;
+
+				const Common::Rect region = dirtyRegion.findIntersectingRect(drawCallRegion);
+				int tile = (region.top - renderRect.top) * numTiles / renderRect.height();
+				while (c->_tileRenderers[tile]->_tile.bottom <= region.top)
+					++tile;
+				for ( ; tile < numTiles && c->_tileRenderers[tile]->_tile.top < region.bottom; ++tile) {
+					TileRenderer *renderer = c->_tileRenderers[tile];
+					renderer->_bin.push_back(TileRenderer::BinnedCall(*it, dirtyRegion.findIntersectingRect(renderer->_tile)));
+				}
+			}
+		}
+
+		for (int i = 0; i < numTiles; ++i) {
+			if (!c->_tileRenderers[i]->_bin.empty())
+				c->_renderPool->addJob(c->_tileRenderers[i]);
+		}
+		c->_renderPool->wait();
+	}
+}
+
 static inline void _appendDirtyRectangle(const Graphics::DrawCall &call, Common::List<DirtyRectangle> &rectangles, int r, int g, int b) {
 	Common::Rect dirty_region = call.getDirtyRegion();
 	if (rectangles.empty() || dirty_region != rectangles.back().rectangle)
 		rectangles.push_back(DirtyRectangle(dirty_region, r, g, b));
 }
 
-static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
+static void tglPresentBufferDirtyRects(TinyGL::GLContext *c, bool tiled) {
 	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
 	typedef Common::List<TinyGL::DirtyRectangle>::iterator RectangleIterator;
 
@@ -195,12 +343,16 @@ static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 
 	if (!rectangles.empty()) {
 		// Execute draw calls.
-		for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
-			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
+		if (tiled) {
+			tglExecuteTiled(c, rectangles);
+		} else {
+			for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
+				Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+				for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
+					Common::Rect dirtyRegion = (*itRect).rectangle;
+					if (dirtyRegion.intersects(drawCallRegion)) {
+						(*it)->execute(dirtyRegion, true);
+					}
 				}
 			}
 		}
@@ -239,11 +391,18 @@ static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 	c->_drawCallAllocator[c->_currentAllocatorIndex].reset();
 }
 
-static void tglPresentBufferSimple(TinyGL::GLContext *c) {
+static void tglPresentBufferSimple(TinyGL::GLContext *c, bool tiled) {
 	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
 
+	if (tiled) {
+		Common::List<DirtyRectangle> rectangles;
+		rectangles.push_back(DirtyRectangle(c->renderRect, 0, 0, 0));
+		tglExecuteTiled(c, rectangles);
+	}
+
 	for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
-		(*it)->execute(true);
+		if (!tiled)
+			(*it)->execute(true);
 		delete *it;
 	}
 
@@ -256,10 +415,12 @@ static void tglPresentBufferSimple(TinyGL::GLContext *c) {
 
 void tglPresentBuffer() {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
+	// Selection records hits in the context, it can't be split over tiles
+	bool tiled = c->_renderPool && c->render_mode == TGL_RENDER;
 	if (c->_enableDirtyRectangles) {
-		tglPresentBufferDirtyRects(c);
+		tglPresentBufferDirtyRects(c, tiled);
 	} else {
-		tglPresentBufferSimple(c);
+		tglPresentBufferSimple(c, tiled);
 	}
 }
 
@@ -294,8 +455,8 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	_drawTriangleFront = c->draw_triangle_front;
 	_drawTriangleBack = c->draw_triangle_back;
 	memcpy(_vertex, c->vertex, sizeof(TinyGL::GLVertex) * _vertexCount);
-	_state = captureState();
-	if (c->_enableDirtyRectangles) {
+	_state = captureState(c);
+	if (c->_enableDirtyRectangles || c->_renderPool) {
 		computeDirtyRegion();
 	}
 }
@@ -334,18 +495,35 @@ void RasterizationDrawCall::computeDirtyRegion() {
 }
 
 void RasterizationDrawCall::execute(bool restoreState) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+	rasterize(TinyGL::gl_get_context(), _vertex, restoreState);
+}
 
+void RasterizationDrawCall::executeTile(TinyGL::GLContext *c, const Common::Rect &clippingRectangle) const {
+	// Rasterizing modifies the vertices, which are shared by all tiles
+	if (_vertexCount > c->vertex_max) {
+		while (_vertexCount > c->vertex_max)
+			c->vertex_max <<= 1;
+		TinyGL::gl_free(c->vertex);
+		c->vertex = (TinyGL::GLVertex *)TinyGL::gl_malloc(sizeof(TinyGL::GLVertex) * c->vertex_max);
+	}
+	memcpy(c->vertex, _vertex, sizeof(TinyGL::GLVertex) * _vertexCount);
+
+	c->fb->setScissorRectangle(clippingRectangle);
+	rasterize(c, c->vertex, false);
+	c->fb->resetScissorRectangle();
+}
+
+void RasterizationDrawCall::rasterize(TinyGL::GLContext *c, TinyGL::GLVertex *vertex, bool restoreState) const {
 	RasterizationDrawCall::RasterizationState backupState;
 	if (restoreState) {
-		backupState = captureState();
+		backupState = captureState(c);
 	}
-	applyState(_state);
+	applyState(c, _state);
 
 	TinyGL::GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
 
-	c->vertex = _vertex;
+	c->vertex = vertex;
 	c->vertex_cnt = _vertexCount;
 	c->draw_triangle_front = (TinyGL::gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (TinyGL::gl_draw_triangle_func)_drawTriangleBack;
@@ -429,13 +607,12 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	c->vertex_cnt = prevVertexCount;
 
 	if (restoreState) {
-		applyState(backupState);
+		applyState(c, backupState);
 	}
 }
 
-RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState() const {
+RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState(TinyGL::GLContext *c) const {
 	RasterizationState state;
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	state.alphaTest = c->fb->isAlphaTestEnabled();
 	c->fb->getBlendingFactors(state.sfactor, state.dfactor);
 	state.enableBlending = c->fb->isBlendingEnabled();
@@ -469,8 +646,7 @@ RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState()
 	return state;
 }
 
-void RasterizationDrawCall::applyState(const RasterizationDrawCall::RasterizationState &state) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+void RasterizationDrawCall::applyState(TinyGL::GLContext *c, const RasterizationDrawCall::RasterizationState &state) const {
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->enableAlphaTest(state.alphaTest);
@@ -525,7 +701,8 @@ BlittingDrawCall::BlittingDrawCall(Graphics::BlitImage *image, const BlitTransfo
 	tglIncBlitImageRef(image);
 	_blitState = captureState();
 	_imageVersion = tglGetBlitImageVersion(image);
-	if (TinyGL::gl_get_context()->_enableDirtyRectangles) {
+	TinyGL::GLContext *c = TinyGL::gl_get_context();
+	if (c->_enableDirtyRectangles || c->_renderPool) {
 		computeDirtyRegion();
 	}
 }
@@ -630,7 +807,7 @@ bool BlittingDrawCall::operator==(const BlittingDrawCall &other) const {
 ClearBufferDrawCall::ClearBufferDrawCall(bool clearZBuffer, int zValue, bool clearColorBuffer, int rValue, int gValue, int bValue)
 	: _clearZBuffer(clearZBuffer), _clearColorBuffer(clearColorBuffer), _zValue(zValue), _rValue(rValue), _gValue(gValue), _bValue(bValue), DrawCall(DrawCall_Clear) {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
-	if (c->_enableDirtyRectangles) {
+	if (c->_enableDirtyRectangles || c->_renderPool) {
 		_dirtyRegion = c->renderRect;
 	}
 }
@@ -641,7 +818,10 @@ void ClearBufferDrawCall::execute(bool restoreState) const {
 }
 
 void ClearBufferDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+	executeTile(TinyGL::gl_get_context(), clippingRectangle);
+}
+
+void ClearBufferDrawCall::executeTile(TinyGL::GLContext *c, const Common::Rect &clippingRectangle) const {
 	Common::Rect clearRect = clippingRectangle.findIntersectingRect(getDirtyRegion());
 	c->fb->clearRegion(clearRect.left, clearRect.top, clearRect.width(), clearRect.height(), _clearZBuffer, _zValue, _clearColorBuffer, _rValue, _gValue, _bValue);
 }
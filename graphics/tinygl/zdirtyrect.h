@@ -77,6 +77,8 @@ public:
 	bool operator==(const ClearBufferDrawCall &other) const;
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
+	// Execute on the context of a tile, see TinyGL::TileRenderer
+	void executeTile(TinyGL::GLContext *c, const Common::Rect &clippingRectangle) const;
 
 	void *operator new(size_t size) {
 		return ::Internal::allocateFrame(size);
@@ -96,6 +98,8 @@ public:
 	bool operator==(const RasterizationDrawCall &other) const;
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
+	// Execute on the context of a tile, with a copy of the vertices in the context's own buffer
+	void executeTile(TinyGL::GLContext *c, const Common::Rect &clippingRectangle) const;
 
 	void *operator new(size_t size) {
 		return ::Internal::allocateFrame(size);
@@ -104,6 +108,7 @@ public:
 	void operator delete(void *p) { }
 private:
 	void computeDirtyRegion();
+	void rasterize(TinyGL::GLContext *c, TinyGL::GLVertex *vertex, bool restoreState) const;
 	typedef void (*gl_draw_triangle_func_ptr)(TinyGL::GLContext *c, TinyGL::GLVertex *p0, TinyGL::GLVertex *p1, TinyGL::GLVertex *p2);
 	int _vertexCount;
 	TinyGL::GLVertex *_vertex;
@@ -140,8 +145,8 @@ private:
 
 	RasterizationState _state;
 
-	RasterizationState captureState() const;
-	void applyState(const RasterizationState &state) const;
+	RasterizationState captureState(TinyGL::GLContext *c) const;
+	void applyState(TinyGL::GLContext *c, const RasterizationState &state) const;
 };
 
 // Encapsulate a blit call: it might execute either a color buffer or z buffer blit.
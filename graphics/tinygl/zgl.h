@@ -42,6 +42,10 @@
 #include "graphics/tinygl/zdirtyrect.h"
 #include "graphics/tinygl/texelbuffer.h"
 
+namespace Common {
+class WorkerPool;
+}
+
 namespace TinyGL {
 
 enum {
@@ -250,6 +254,7 @@ private:
 };
 
 struct GLContext;
+struct TileRenderer;
 
 typedef void (*gl_draw_triangle_func)(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex *p2);
 
@@ -388,6 +393,10 @@ struct GLContext {
 
 	bool _enableDirtyRectangles;
 
+	// tiled rendering
+	Common::WorkerPool *_renderPool;
+	Common::Array<TileRenderer *> _tileRenderers;
+
 	// blit test
 	Common::List<Graphics::BlitImage *> _blitImages;
 
@@ -438,6 +447,8 @@ void tglIssueDrawCall(Graphics::DrawCall *drawCall);
 // zdirtyrect.cpp
 void tglDisposeResources(GLContext *c);
 void tglDisposeDrawCallLists(TinyGL::GLContext *c);
+void tglSetupTiledRendering(GLContext *c, bool enable, int numThreads);
+void tglDisposeTiledRendering(GLContext *c);
 
 GLContext *gl_get_context();
 
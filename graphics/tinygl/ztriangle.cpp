@@ -361,7 +361,8 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
 			int x = x1;
-			{
+			// Scanlines outside of the scissor rectangle only need the edges stepped
+			if (!kEnableScissor || (y >= _clipRectangle.top && y < _clipRectangle.bottom)) {
 				if (kDrawLogic == DRAW_DEPTH_ONLY ||
 						(kDrawLogic == DRAW_FLAT && !(kInterpST || kInterpSTZ))) {
 					int pp;
@@ -86,6 +86,16 @@
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
+// The NEON kernels have not been run on ARM hardware yet, so they are only
+// used when building with ENABLE_NEON_YUV defined.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2_YUV
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(ENABLE_NEON_YUV)
+#define USE_NEON_YUV
+#include <arm_neon.h>
+#endif
+
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
 }
@@ -98,12 +108,14 @@ public:
 
 	Graphics::PixelFormat getFormat() const { return _format; }
 	YUVToRGBManager::LuminanceScale getScale() const { return _scale; }
+	bool getAlphaMode() const { return _alphaMode; }
 	const uint32 *getRGBToPix() const { return _rgbToPix; }
 	const uint32 *getAlphaToPix() const { return _alphaToPix; }
 
 private:
 	Graphics::PixelFormat _format;
 	YUVToRGBManager::LuminanceScale _scale;
+	bool _alphaMode;
 	uint32 _rgbToPix[3 * 768]; // 9216 bytes
 	uint32 _alphaToPix[256];   // 958 bytes
 };
@@ -111,6 +123,7 @@ private:
 YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale, bool alphaMode) {
 	_format = format;
 	_scale = scale;
+	_alphaMode = alphaMode;
 
 	int alphaValue = alphaMode ? 0 : 255;
 
@@ -167,8 +180,7 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 }
 
 YUVToRGBManager::YUVToRGBManager() {
-	_lookup = 0;
-	_alphaMode = false;
+	_vectorized = true;
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -190,23 +202,551 @@ YUVToRGBManager::YUVToRGBManager() {
 }
 
 YUVToRGBManager::~YUVToRGBManager() {
-	delete _lookup;
+	for (uint i = 0; i < _lookups.size(); i++)
+		delete _lookups[i];
 }
 
 const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale, bool alphaMode) {
-	if (_lookup && _lookup->getFormat() == format && _lookup->getScale() == scale && _alphaMode == alphaMode)
-		return _lookup;
+	// Videos may be converted on several threads at once, e.g. in bands or
+	// while decoding ahead, so lookups are only created under the lock and
+	// are kept until the end. There are only a few combinations in practice.
+	Common::StackLock lock(_lookupMutex);
+
+	for (uint i = 0; i < _lookups.size(); i++) {
+		const YUVToRGBLookup *lookup = _lookups[i];
+		if (lookup->getFormat() == format && lookup->getScale() == scale && lookup->getAlphaMode() == alphaMode)
+			return lookup;
+	}
 
-	_alphaMode = alphaMode;
-	delete _lookup;
-	_lookup = new YUVToRGBLookup(format, scale, alphaMode);
-	return _lookup;
+	YUVToRGBLookup *lookup = new YUVToRGBLookup(format, scale, alphaMode);
+	_lookups.push_back(lookup);
+	return lookup;
 }
 
 #define PUT_PIXEL(s, d) \
 	L = &rgbToPix[(s)]; \
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
 
+#if defined(USE_SSE2_YUV) || defined(USE_NEON_YUV)
+
+namespace {
+
+/**
+ * The cr_r, crb_g and cb_b values of a row of chroma samples, as looked up
+ * by the scalar code, made relative to the start of the red, green and blue
+ * parts of the rgbToPix table. They are also offset by the bias, which is
+ * the smallest luminance the table does not clamp to black.
+ */
+class ChromaRow {
+public:
+	ChromaRow(const int16 *colorTab, int size, bool itu) : bias(itu ? 16 : 0), _colorTab(colorTab) {
+		_buffer = new int16[3 * size];
+		r = _buffer;
+		g = _buffer + size;
+		b = _buffer + 2 * size;
+	}
+
+	~ChromaRow() {
+		delete[] _buffer;
+	}
+
+	void set(int i, byte u, byte v) {
+		r[i] = _colorTab[v] - (0 * 768 + 256) - bias;
+		g[i] = _colorTab[256 + v] + _colorTab[512 + u] - (1 * 768 + 256) - bias;
+		b[i] = _colorTab[768 + u] - (2 * 768 + 256) - bias;
+	}
+
+	int16 *r, *g, *b;
+	const int bias;
+
+private:
+	const int16 *_colorTab;
+	int16 *_buffer;
+};
+
+/** Where the color components go in the bytes of a 32-bit pixel */
+struct ByteLayout {
+	enum {
+		kRed,
+		kGreen,
+		kBlue,
+		kAlpha,
+		kZero
+	};
+
+	ByteLayout(const Graphics::PixelFormat &format) {
+		// The common 32-bit formats have a byte for each component, so
+		// pixels can be put together by interleaving the components
+		bytes = format.bytesPerPixel == 4 && !format.rLoss && !format.gLoss && !format.bLoss &&
+		        !(format.rShift & 7) && !(format.gShift & 7) && !(format.bShift & 7) &&
+		        (format.aLoss == 8 || (!format.aLoss && !(format.aShift & 7)));
+
+		for (int i = 0; i < 4; i++)
+			components[i] = kZero;
+		if (bytes) {
+			components[byteIndex(format.rShift)] = kRed;
+			components[byteIndex(format.gShift)] = kGreen;
+			components[byteIndex(format.bShift)] = kBlue;
+			if (!format.aLoss)
+				components[byteIndex(format.aShift)] = kAlpha;
+		}
+	}
+
+	static int byteIndex(int shift) {
+#ifdef SCUMM_BIG_ENDIAN
+		return 3 - (shift >> 3);
+#else
+		return shift >> 3;
+#endif
+	}
+
+	bool bytes;
+	int components[4];
+};
+
+#if defined(USE_SSE2_YUV)
+
+/**
+ * Add the luminance to the chroma offsets, giving eight color components.
+ * Like the rgbToPix table, the ITU scale stretches 16..235 to 0..255. The
+ * results still have to be clamped to 0..255.
+ */
+template<bool itu>
+inline __m128i computeComponent(__m128i y, __m128i offset) {
+	const __m128i c = _mm_add_epi16(y, offset);
+	if (!itu)
+		return c;
+
+	// c * 255 / 219, rounded down, for c in 0..219
+	return _mm_add_epi16(c, _mm_mulhi_epi16(c, _mm_set1_epi16(10775)));
+}
+
+inline __m128i loadChroma(const int16 *src, int x, int chromaShift) {
+	if (!chromaShift)
+		return _mm_loadu_si128((const __m128i *)(src + x));
+
+	const __m128i c = _mm_loadl_epi64((const __m128i *)(src + (x >> 1)));
+	return _mm_unpacklo_epi16(c, c);
+}
+
+/**
+ * Multiply the magnitudes of eight chroma values with a fixed point constant
+ * and give the products their signs back. The products are truncated, like
+ * the ones in the chroma tables.
+ */
+template<int shift>
+inline __m128i multiplyChroma(__m128i magnitude, __m128i sign, int multiplier) {
+	const __m128i product = _mm_mulhi_epu16(_mm_slli_epi16(magnitude, shift), _mm_set1_epi16((short)multiplier));
+	return _mm_sub_epi16(_mm_xor_si128(product, sign), sign);
+}
+
+/**
+ * Fill in a row of chroma offsets, eight samples at a time, and return how
+ * many samples were done. The multipliers give the same results as the
+ * chroma tables for all of 0..255.
+ */
+int setChromaVector(ChromaRow &chroma, const byte *uSrc, const byte *vSrc, int width) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i center = _mm_set1_epi16(128);
+	const __m128i bias = _mm_set1_epi16(chroma.bias);
+	int i = 0;
+
+	for (; i + 8 <= width; i += 8) {
+		const __m128i u = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(uSrc + i)), zero), center);
+		const __m128i v = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(vSrc + i)), zero), center);
+		const __m128i uSign = _mm_srai_epi16(u, 15), vSign = _mm_srai_epi16(v, 15);
+		const __m128i uMagnitude = _mm_sub_epi16(_mm_xor_si128(u, uSign), uSign);
+		const __m128i vMagnitude = _mm_sub_epi16(_mm_xor_si128(v, vSign), vSign);
+
+		// (0.419 / 0.299) * Cr, (0.299 / 0.419) * Cr, (0.114 / 0.331) * Cb and (0.587 / 0.331) * Cb
+		const __m128i r = multiplyChroma<1>(vMagnitude, vSign, 45876);
+		const __m128i g = _mm_add_epi16(multiplyChroma<0>(vMagnitude, vSign, 46735), multiplyChroma<0>(uMagnitude, uSign, 22562));
+		const __m128i b = multiplyChroma<1>(uMagnitude, uSign, 58109);
+
+		_mm_storeu_si128((__m128i *)(chroma.r + i), _mm_sub_epi16(r, bias));
+		_mm_storeu_si128((__m128i *)(chroma.g + i), _mm_sub_epi16(_mm_sub_epi16(zero, g), bias));
+		_mm_storeu_si128((__m128i *)(chroma.b + i), _mm_sub_epi16(b, bias));
+	}
+
+	return i;
+}
+
+/** Compute sixteen color components, clamped by packing them to bytes. */
+template<int chromaShift, bool itu>
+inline __m128i computeComponents(__m128i yLo, __m128i yHi, const int16 *chroma, int x) {
+	return _mm_packus_epi16(computeComponent<itu>(yLo, loadChroma(chroma, x, chromaShift)),
+	                        computeComponent<itu>(yHi, loadChroma(chroma, x + 8, chromaShift)));
+}
+
+/** The shift counts to pack color components into pixels of a format */
+struct ShiftCounts {
+	ShiftCounts(const Graphics::PixelFormat &format) :
+		rLoss(_mm_cvtsi32_si128(format.rLoss)), gLoss(_mm_cvtsi32_si128(format.gLoss)),
+		bLoss(_mm_cvtsi32_si128(format.bLoss)), aLoss(_mm_cvtsi32_si128(format.aLoss)),
+		rShift(_mm_cvtsi32_si128(format.rShift)), gShift(_mm_cvtsi32_si128(format.gShift)),
+		bShift(_mm_cvtsi32_si128(format.bShift)), aShift(_mm_cvtsi32_si128(format.aShift)) {
+	}
+
+	__m128i rLoss, gLoss, bLoss, aLoss;
+	__m128i rShift, gShift, bShift, aShift;
+};
+
+/** Pack the components in the given quarter of the bytes into 32-bit pixels. */
+inline __m128i packPixels32(const __m128i *components, int quarter, const ShiftCounts &shifts) {
+	__m128i c[4];
+	for (int i = 0; i < 4; i++) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i c16 = (quarter & 2) ? _mm_unpackhi_epi8(components[i], zero) : _mm_unpacklo_epi8(components[i], zero);
+		c[i] = (quarter & 1) ? _mm_unpackhi_epi16(c16, zero) : _mm_unpacklo_epi16(c16, zero);
+	}
+
+	__m128i pixels = _mm_sll_epi32(_mm_srl_epi32(c[ByteLayout::kRed], shifts.rLoss), shifts.rShift);
+	pixels = _mm_or_si128(pixels, _mm_sll_epi32(_mm_srl_epi32(c[ByteLayout::kGreen], shifts.gLoss), shifts.gShift));
+	pixels = _mm_or_si128(pixels, _mm_sll_epi32(_mm_srl_epi32(c[ByteLayout::kBlue], shifts.bLoss), shifts.bShift));
+	return _mm_or_si128(pixels, _mm_sll_epi32(_mm_srl_epi32(c[ByteLayout::kAlpha], shifts.aLoss), shifts.aShift));
+}
+
+/**
+ * Puts a color component in its place in 16-bit pixels. Shifting by a
+ * constant is done with a multiplication, which is cheaper than shifting
+ * by a count in a register.
+ */
+struct ComponentPacking16 {
+	ComponentPacking16(byte loss, byte shift) {
+		present = loss < 8;
+		mask = _mm_set1_epi16((0xFF << loss) & 0xFF);
+		high = shift < loss;
+		multiplier = _mm_set1_epi16((short)(high ? 1 << (16 - loss + shift) : 1 << (shift - loss)));
+	}
+
+	__m128i pack(__m128i c) const {
+		c = _mm_and_si128(c, mask);
+		return high ? _mm_mulhi_epu16(c, multiplier) : _mm_mullo_epi16(c, multiplier);
+	}
+
+	__m128i mask, multiplier;
+	bool high, present;
+};
+
+struct PixelPacking16 {
+	PixelPacking16(const Graphics::PixelFormat &format) :
+		r(format.rLoss, format.rShift), g(format.gLoss, format.gShift),
+		b(format.bLoss, format.bShift), a(format.aLoss, format.aShift) {
+	}
+
+	ComponentPacking16 r, g, b, a;
+};
+
+template<int half>
+inline __m128i unpackHalf(__m128i c) {
+	return half ? _mm_unpackhi_epi8(c, _mm_setzero_si128()) : _mm_unpacklo_epi8(c, _mm_setzero_si128());
+}
+
+/** Pack the components in the given half of the bytes into 16-bit pixels. */
+template<int half>
+inline __m128i packPixels16(__m128i r, __m128i g, __m128i b, __m128i a, const PixelPacking16 &packing) {
+	__m128i pixels = _mm_or_si128(packing.r.pack(unpackHalf<half>(r)), packing.g.pack(unpackHalf<half>(g)));
+	pixels = _mm_or_si128(pixels, packing.b.pack(unpackHalf<half>(b)));
+	if (packing.a.present)
+		pixels = _mm_or_si128(pixels, packing.a.pack(unpackHalf<half>(a)));
+	return pixels;
+}
+
+/**
+ * Convert a row, sixteen pixels at a time, and return how many pixels were
+ * converted. The chroma is shared by two pixels when chromaShift is 1.
+ */
+template<typename PixelInt, int chromaShift, bool itu>
+int convertRowVector(byte *dst, const Graphics::PixelFormat &format, const byte *ySrc, const byte *aSrc, const ChromaRow &chroma, int width) {
+	const ByteLayout layout(format);
+	const ShiftCounts shifts(format);
+	const PixelPacking16 packing(format);
+	const __m128i zero = _mm_setzero_si128();
+	int x = 0;
+
+	for (; x + 16 <= width; x += 16) {
+		const __m128i y = _mm_loadu_si128((const __m128i *)(ySrc + x));
+		const __m128i yLo = _mm_unpacklo_epi8(y, zero);
+		const __m128i yHi = _mm_unpackhi_epi8(y, zero);
+		const __m128i r = computeComponents<chromaShift, itu>(yLo, yHi, chroma.r, x);
+		const __m128i g = computeComponents<chromaShift, itu>(yLo, yHi, chroma.g, x);
+		const __m128i b = computeComponents<chromaShift, itu>(yLo, yHi, chroma.b, x);
+		const __m128i a = aSrc ? _mm_loadu_si128((const __m128i *)(aSrc + x)) : _mm_set1_epi8(-1);
+
+		if (sizeof(PixelInt) == 2) {
+			_mm_storeu_si128((__m128i *)(dst + x * 2), packPixels16<0>(r, g, b, a, packing));
+			_mm_storeu_si128((__m128i *)(dst + x * 2 + 16), packPixels16<1>(r, g, b, a, packing));
+			continue;
+		}
+
+		const __m128i components[] = { r, g, b, a, zero };
+		if (layout.bytes) {
+			// Interleave the bytes in the order they are in memory
+			const __m128i c0 = components[layout.components[0]];
+			const __m128i c1 = components[layout.components[1]];
+			const __m128i c2 = components[layout.components[2]];
+			const __m128i c3 = components[layout.components[3]];
+			const __m128i lo01 = _mm_unpacklo_epi8(c0, c1), hi01 = _mm_unpackhi_epi8(c0, c1);
+			const __m128i lo23 = _mm_unpacklo_epi8(c2, c3), hi23 = _mm_unpackhi_epi8(c2, c3);
+			_mm_storeu_si128((__m128i *)(dst + x * 4), _mm_unpacklo_epi16(lo01, lo23));
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 16), _mm_unpackhi_epi16(lo01, lo23));
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 32), _mm_unpacklo_epi16(hi01, hi23));
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 48), _mm_unpackhi_epi16(hi01, hi23));
+		} else {
+			for (int i = 0; i < 4; i++)
+				_mm_storeu_si128((__m128i *)(dst + x * 4 + i * 16), packPixels32(components, i, shifts));
+		}
+	}
+
+	return x;
+}
+
+#elif defined(USE_NEON_YUV)
+
+/**
+ * Add the luminance to the chroma offsets, giving eight color components
+ * clamped to 0..255. Like the rgbToPix table, the ITU scale stretches
+ * 16..235 to 0..255.
+ */
+template<bool itu>
+inline uint8x8_t computeComponent(int16x8_t y, int16x8_t offset) {
+	int16x8_t c = vaddq_s16(y, offset);
+
+	if (itu) {
+		// c * 255 / 219, rounded down, for c in 0..219
+		const int16x4_t lo = vshrn_n_s32(vmull_s16(vget_low_s16(c), vdup_n_s16(10775)), 16);
+		const int16x4_t hi = vshrn_n_s32(vmull_s16(vget_high_s16(c), vdup_n_s16(10775)), 16);
+		c = vaddq_s16(c, vcombine_s16(lo, hi));
+	}
+
+	return vqmovun_s16(c);
+}
+
+inline int16x8_t loadChroma(const int16 *src, int x, int chromaShift) {
+	if (!chromaShift)
+		return vld1q_s16(src + x);
+
+	const int16x4_t c = vld1_s16(src + (x >> 1));
+	const int16x4x2_t pairs = vzip_s16(c, c);
+	return vcombine_s16(pairs.val[0], pairs.val[1]);
+}
+
+/**
+ * Multiply the magnitudes of eight chroma values with a fixed point constant
+ * and give the products their signs back. The products are truncated, like
+ * the ones in the chroma tables.
+ */
+template<int shift>
+inline int16x8_t multiplyChroma(uint16x8_t magnitude, uint16x8_t negative, int multiplier) {
+	const uint16x8_t m = vshlq_n_u16(magnitude, shift);
+	const uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(m), vdup_n_u16(multiplier)), 16);
+	const uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(m), vdup_n_u16(multiplier)), 16);
+	const int16x8_t product = vreinterpretq_s16_u16(vcombine_u16(lo, hi));
+	return vbslq_s16(negative, vnegq_s16(product), product);
+}
+
+/**
+ * Fill in a row of chroma offsets, eight samples at a time, and return how
+ * many samples were done. The multipliers give the same results as the
+ * chroma tables for all of 0..255.
+ */
+int setChromaVector(ChromaRow &chroma, const byte *uSrc, const byte *vSrc, int width) {
+	const int16x8_t center = vdupq_n_s16(128);
+	const int16x8_t bias = vdupq_n_s16(chroma.bias);
+	int i = 0;
+
+	for (; i + 8 <= width; i += 8) {
+		const int16x8_t u = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(uSrc + i))), center);
+		const int16x8_t v = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(vSrc + i))), center);
+		const uint16x8_t uNegative = vcltq_s16(u, vdupq_n_s16(0)), vNegative = vcltq_s16(v, vdupq_n_s16(0));
+		const uint16x8_t uMagnitude = vreinterpretq_u16_s16(vabsq_s16(u));
+		const uint16x8_t vMagnitude = vreinterpretq_u16_s16(vabsq_s16(v));
+
+		// (0.419 / 0.299) * Cr, (0.299 / 0.419) * Cr, (0.114 / 0.331) * Cb and (0.587 / 0.331) * Cb
+		const int16x8_t r = multiplyChroma<1>(vMagnitude, vNegative, 45876);
+		const int16x8_t g = vaddq_s16(multiplyChroma<0>(vMagnitude, vNegative, 46735), multiplyChroma<0>(uMagnitude, uNegative, 22562));
+		const int16x8_t b = multiplyChroma<1>(uMagnitude, uNegative, 58109);
+
+		vst1q_s16(chroma.r + i, vsubq_s16(r, bias));
+		vst1q_s16(chroma.g + i, vsubq_s16(vnegq_s16(g), bias));
+		vst1q_s16(chroma.b + i, vsubq_s16(b, bias));
+	}
+
+	return i;
+}
+
+/** Compute sixteen color components, clamped to bytes. */
+template<int chromaShift, bool itu>
+inline uint8x16_t computeComponents(int16x8_t yLo, int16x8_t yHi, const int16 *chroma, int x) {
+	return vcombine_u8(computeComponent<itu>(yLo, loadChroma(chroma, x, chromaShift)),
+	                   computeComponent<itu>(yHi, loadChroma(chroma, x + 8, chromaShift)));
+}
+
+inline uint16x8_t packComponent16(uint8x8_t c, byte loss, byte shift) {
+	return vshlq_u16(vshlq_u16(vmovl_u8(c), vdupq_n_s16(-(int)loss)), vdupq_n_s16(shift));
+}
+
+inline uint32x4_t packComponent32(uint16x4_t c, byte loss, byte shift) {
+	return vshlq_u32(vshlq_u32(vmovl_u16(c), vdupq_n_s32(-(int)loss)), vdupq_n_s32(shift));
+}
+
+/** Pack the components in the given quarter of the bytes into 32-bit pixels. */
+inline uint32x4_t packPixels32(const uint8x16_t *components, int quarter, const Graphics::PixelFormat &format) {
+	uint16x4_t c[4];
+	for (int i = 0; i < 4; i++) {
+		const uint16x8_t c16 = vmovl_u8((quarter & 2) ? vget_high_u8(components[i]) : vget_low_u8(components[i]));
+		c[i] = (quarter & 1) ? vget_high_u16(c16) : vget_low_u16(c16);
+	}
+
+	uint32x4_t pixels = packComponent32(c[ByteLayout::kRed], format.rLoss, format.rShift);
+	pixels = vorrq_u32(pixels, packComponent32(c[ByteLayout::kGreen], format.gLoss, format.gShift));
+	pixels = vorrq_u32(pixels, packComponent32(c[ByteLayout::kBlue], format.bLoss, format.bShift));
+	return vorrq_u32(pixels, packComponent32(c[ByteLayout::kAlpha], format.aLoss, format.aShift));
+}
+
+/** Pack the components in the given half of the bytes into 16-bit pixels. */
+inline uint16x8_t packPixels16(const uint8x16_t *components, int half, const Graphics::PixelFormat &format) {
+	uint8x8_t c[4];
+	for (int i = 0; i < 4; i++)
+		c[i] = half ? vget_high_u8(components[i]) : vget_low_u8(components[i]);
+
+	uint16x8_t pixels = packComponent16(c[ByteLayout::kRed], format.rLoss, format.rShift);
+	pixels = vorrq_u16(pixels, packComponent16(c[ByteLayout::kGreen], format.gLoss, format.gShift));
+	pixels = vorrq_u16(pixels, packComponent16(c[ByteLayout::kBlue], format.bLoss, format.bShift));
+	return vorrq_u16(pixels, packComponent16(c[ByteLayout::kAlpha], format.aLoss, format.aShift));
+}
+
+/**
+ * Convert a row, sixteen pixels at a time, and return how many pixels were
+ * converted. The chroma is shared by two pixels when chromaShift is 1.
+ */
+template<typename PixelInt, int chromaShift, bool itu>
+int convertRowVector(byte *dst, const Graphics::PixelFormat &format, const byte *ySrc, const byte *aSrc, const ChromaRow &chroma, int width) {
+	const ByteLayout layout(format);
+	uint8x16_t components[5];
+	components[ByteLayout::kZero] = vdupq_n_u8(0);
+	int x = 0;
+
+	for (; x + 16 <= width; x += 16) {
+		const uint8x16_t y = vld1q_u8(ySrc + x);
+		const int16x8_t yLo = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(y)));
+		const int16x8_t yHi = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(y)));
+		components[ByteLayout::kRed] = computeComponents<chromaShift, itu>(yLo, yHi, chroma.r, x);
+		components[ByteLayout::kGreen] = computeComponents<chromaShift, itu>(yLo, yHi, chroma.g, x);
+		components[ByteLayout::kBlue] = computeComponents<chromaShift, itu>(yLo, yHi, chroma.b, x);
+		components[ByteLayout::kAlpha] = aSrc ? vld1q_u8(aSrc + x) : vdupq_n_u8(255);
+
+		if (sizeof(PixelInt) == 4 && layout.bytes) {
+			// Interleave the bytes in the order they are in memory
+			uint8x16x4_t pixels;
+			for (int i = 0; i < 4; i++)
+				pixels.val[i] = components[layout.components[i]];
+			vst4q_u8(dst + x * 4, pixels);
+		} else if (sizeof(PixelInt) == 4) {
+			for (int i = 0; i < 4; i++)
+				vst1q_u32((uint32 *)(dst + x * 4 + i * 16), packPixels32(components, i, format));
+		} else {
+			for (int i = 0; i < 2; i++)
+				vst1q_u16((uint16 *)(dst + x * 2 + i * 16), packPixels16(components, i, format));
+		}
+	}
+
+	return x;
+}
+
+#endif
+
+void setChromaRow(ChromaRow &chroma, const byte *uSrc, const byte *vSrc, int width) {
+	for (int i = setChromaVector(chroma, uSrc, vSrc, width); i < width; i++)
+		chroma.set(i, uSrc[i], vSrc[i]);
+}
+
+/** Convert the pixels of a row the vector code left over, with the lookup tables. */
+template<typename PixelInt, int chromaShift>
+void convertRowTail(byte *dst, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *aSrc, const ChromaRow &chroma, int x, int width) {
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const uint32 *aToPix = lookup->getAlphaToPix();
+
+	for (; x < width; x++) {
+		const uint32 *L = &rgbToPix[ySrc[x] + chroma.bias];
+		const int c = x >> chromaShift;
+		uint32 pixel = L[chroma.r[c] + 0 * 768 + 256] | L[chroma.g[c] + 1 * 768 + 256] | L[chroma.b[c] + 2 * 768 + 256];
+		if (aSrc)
+			pixel |= aToPix[aSrc[x]];
+		*((PixelInt *)dst + x) = pixel;
+	}
+}
+
+template<typename PixelInt, int chromaShift, bool itu>
+void convertYUVToRGBVector(Graphics::Surface *dst, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const int chromaWidth = yWidth >> chromaShift;
+	ChromaRow chroma(colorTab, chromaWidth, itu);
+
+	for (int h = 0; h < yHeight; h++) {
+		if (!(h & ((1 << chromaShift) - 1))) {
+			setChromaRow(chroma, uSrc + (h >> chromaShift) * uvPitch, vSrc + (h >> chromaShift) * uvPitch, chromaWidth);
+		}
+
+		byte *dstRow = (byte *)dst->getBasePtr(0, h);
+		const byte *yRow = ySrc + h * yPitch;
+		const byte *aRow = aSrc ? aSrc + h * yPitch : nullptr;
+		const int x = convertRowVector<PixelInt, chromaShift, itu>(dstRow, dst->format, yRow, aRow, chroma, yWidth);
+		convertRowTail<PixelInt, chromaShift>(dstRow, lookup, yRow, aRow, chroma, x, yWidth);
+	}
+}
+
+template<typename PixelInt, bool itu>
+void convertYUV410ToRGBVector(Graphics::Surface *dst, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	ChromaRow chroma(colorTab, yWidth, itu);
+	byte *uInterpolated = new byte[2 * yWidth];
+	byte *vInterpolated = uInterpolated + yWidth;
+
+	for (int y = 0; y < yHeight; y++) {
+		// The same bilinear interpolation of the chroma as convertYUV410ToRGB
+		const int yDiff = y & 3;
+		const byte *uRow = uSrc + (y >> 2) * uvPitch;
+		const byte *vRow = vSrc + (y >> 2) * uvPitch;
+
+		for (int x = 0; x < (yWidth >> 2); x++) {
+			for (int xDiff = 0; xDiff < 4; xDiff++) {
+				const int weightA = (4 - xDiff) * (4 - yDiff), weightB = xDiff * (4 - yDiff);
+				const int weightC = yDiff * (4 - xDiff), weightD = xDiff * yDiff;
+				uInterpolated[x * 4 + xDiff] = (uRow[x] * weightA + uRow[x + 1] * weightB + uRow[x + uvPitch] * weightC + uRow[x + uvPitch + 1] * weightD) >> 4;
+				vInterpolated[x * 4 + xDiff] = (vRow[x] * weightA + vRow[x + 1] * weightB + vRow[x + uvPitch] * weightC + vRow[x + uvPitch + 1] * weightD) >> 4;
+			}
+		}
+
+		setChromaRow(chroma, uInterpolated, vInterpolated, yWidth);
+
+		byte *dstRow = (byte *)dst->getBasePtr(0, y);
+		const byte *yRow = ySrc + y * yPitch;
+		const int x = convertRowVector<PixelInt, 0, itu>(dstRow, dst->format, yRow, nullptr, chroma, yWidth);
+		convertRowTail<PixelInt, 0>(dstRow, lookup, yRow, nullptr, chroma, x, yWidth);
+	}
+
+	delete[] uInterpolated;
+}
+
+template<int chromaShift>
+void convertVector(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const bool itu = (scale == YUVToRGBManager::kScaleITU);
+
+	if (dst->format.bytesPerPixel == 2 && itu)
+		convertYUVToRGBVector<uint16, chromaShift, true>(dst, lookup, colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+	else if (dst->format.bytesPerPixel == 2)
+		convertYUVToRGBVector<uint16, chromaShift, false>(dst, lookup, colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+	else if (itu)
+		convertYUVToRGBVector<uint32, chromaShift, true>(dst, lookup, colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+	else
+		convertYUVToRGBVector<uint32, chromaShift, false>(dst, lookup, colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
+} // End of anonymous namespace
+
+#define USE_VECTOR_YUV
+
+#endif
+
 template<typename PixelInt>
 void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Keep the tables in pointers here to avoid a dereference on each pixel
@@ -246,6 +786,13 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+#ifdef USE_VECTOR_YUV
+	if (_vectorized) {
+		convertVector<0>(dst, scale, lookup, _colorTab, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+#endif
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -302,6 +849,13 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+#ifdef USE_VECTOR_YUV
+	if (_vectorized) {
+		convertVector<1>(dst, scale, lookup, _colorTab, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+#endif
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -366,6 +920,13 @@ void YUVToRGBManager::convert420Alpha(Graphics::Surface *dst, YUVToRGBManager::L
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale, true);
 
+#ifdef USE_VECTOR_YUV
+	if (_vectorized) {
+		convertVector<1>(dst, scale, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+#endif
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUVA420ToRGBA<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -451,6 +1012,22 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+#ifdef USE_VECTOR_YUV
+	if (_vectorized) {
+		const bool itu = (scale == kScaleITU);
+
+		if (dst->format.bytesPerPixel == 2 && itu)
+			convertYUV410ToRGBVector<uint16, true>(dst, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else if (dst->format.bytesPerPixel == 2)
+			convertYUV410ToRGBVector<uint16, false>(dst, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else if (itu)
+			convertYUV410ToRGBVector<uint32, true>(dst, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUV410ToRGBVector<uint32, false>(dst, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+#endif
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -39,6 +39,8 @@
 #define GRAPHICS_YUV_TO_RGB_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/mutex.h"
 #include "common/singleton.h"
 #include "graphics/surface.h"
 
@@ -121,6 +123,13 @@ public:
 	 */
 	void convert410(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/**
+	 * Allow the conversion code to use SSE2, or NEON when it has been built
+	 * with ENABLE_NEON_YUV. This is the default. The results are the same
+	 * either way.
+	 */
+	void setVectorized(bool enable) { _vectorized = enable; }
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
@@ -128,9 +137,10 @@ private:
 
 	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format, LuminanceScale scale, bool alphaMode = false);
 
-	YUVToRGBLookup *_lookup;
+	Common::Array<YUVToRGBLookup *> _lookups;
+	Common::Mutex _lookupMutex;
 	int16 _colorTab[4 * 256]; // 2048 bytes
-	bool _alphaMode;
+	bool _vectorized;
 };
  /** @} */
 } // End of namespace Graphics
@@ -57,9 +57,8 @@ enum {
 
 MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	: Dialog("MassAdd"),
-	_dirsScanned(0),
+	_scan(nullptr),
 	_oldGamesCount(0),
-	_dirTotal(0),
 	_okButton(nullptr),
 	_dirProgressText(nullptr),
 	_gameProgressText(nullptr) {
@@ -67,7 +66,7 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	U32StringArray l;
 
 	// The dir we start our scan at
-	_scanStack.push(startDir);
+	_scan = new DetectionScan(startDir, true);
 
 	// Removed for now... Why would you put a title on mass add dialog called "Mass Add Dialog"?
 	// new StaticTextWidget(this, "massadddialog_caption", "Mass Add Dialog");
@@ -107,6 +106,10 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	}
 }
 
+MassAddDialog::~MassAddDialog() {
+	delete _scan;
+}
+
 struct GameTargetLess {
 	bool operator()(const DetectedGame &x, const DetectedGame &y) const {
 		return x.preferredTarget.compareToIgnoreCase(y.preferredTarget) < 0;
@@ -152,6 +155,8 @@ void MassAddDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data
 		close();
 	} else if (cmd == kCancelCmd) {
 		// User cancelled, so we don't do anything and just leave.
+		delete _scan;
+		_scan = nullptr;
 		_games.clear();
 		close();
 	} else {
@@ -160,22 +165,17 @@ void MassAddDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data
 }
 
 void MassAddDialog::handleTickle() {
-	if (_scanStack.empty())
+	if (!_scan)
 		return;	// We have finished scanning
 
-	uint32 t = g_system->getMillis();
-
-	// Perform a breadth-first scan of the filesystem.
-	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
-		Common::FSNode dir = _scanStack.pop();
-
-		Common::FSList files;
-		if (!dir.getChildren(files, Common::FSNode::kListAll)) {
-			continue;
-		}
+	// The directories are scanned in the background where possible, this
+	// collects what was found so far
+	Common::Array<DetectionScan::Result> results;
+	const bool finished = _scan->update(results, kMaxScanTime);
 
-		// Run the detector on the dir
-		DetectionResults detectionResults = EngineMan.detectGames(files);
+	for (uint i = 0; i < results.size(); i++) {
+		const Common::FSNode &dir = results[i].directory;
+		DetectionResults detectionResults(results[i].games);
 
 		if (detectionResults.foundUnknownGames()) {
 			Common::U32String report = detectionResults.generateUnknownGameReport(false, 80);
@@ -227,30 +227,20 @@ void MassAddDialog::handleTickle() {
 
 			_list->append(result.description);
 		}
-
-
-		// Recurse into all subdirs
-		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-			if (file->isDirectory()) {
-				_scanStack.push(*file);
-
-				_dirTotal++;
-			}
-		}
-
-		_dirsScanned++;
+	}
 
 #if defined(USE_TASKBAR)
-		g_system->getTaskbarManager()->setProgressValue(_dirsScanned, _dirTotal);
-		g_system->getTaskbarManager()->setCount(_games.size());
+	g_system->getTaskbarManager()->setProgressValue(_scan->getScannedCount(), _scan->getDirectoryCount());
+	g_system->getTaskbarManager()->setCount(_games.size());
 #endif
-	}
-
 
 	// Update the dialog
 	Common::U32String buf;
 
-	if (_scanStack.empty()) {
+	if (finished) {
+		delete _scan;
+		_scan = nullptr;
+
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
@@ -261,7 +251,7 @@ void MassAddDialog::handleTickle() {
 		_gameProgressText->setLabel(buf);
 
 	} else {
-		buf = Common::U32String::format(_("Scanned %d directories ..."), _dirsScanned);
+		buf = Common::U32String::format(_("Scanned %d directories ..."), _scan->getScannedCount());
 		_dirProgressText->setLabel(buf);
 
 		buf = Common::U32String::format(_("Discovered %d new games, ignored %d previously added games ..."), _games.size(), _oldGamesCount);
@@ -27,9 +27,10 @@
 #include "gui/widgets/list.h"
 #include "common/fs.h"
 #include "common/hashmap.h"
-#include "common/stack.h"
 #include "common/str.h"
 
+class DetectionScan;
+
 namespace GUI {
 
 class StaticTextWidget;
@@ -39,6 +40,7 @@ class MassAddDialog : public Dialog {
 	typedef Common::Array<Common::U32String> U32StringArray;
 public:
 	MassAddDialog(const Common::FSNode &startDir);
+	~MassAddDialog() override;
 
 	//void open();
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
@@ -51,7 +53,7 @@ public:
 	}
 
 private:
-	Common::Stack<Common::FSNode>  _scanStack;
+	DetectionScan *_scan;
 	DetectedGames _games;
 
 	/**
@@ -61,9 +63,7 @@ private:
 	 */
 	Common::HashMap<Common::String, StringArray>	_pathToTargets;
 
-	int _dirsScanned;
 	int _oldGamesCount;
-	int _dirTotal;
 
 	Widget *_okButton;
 	StaticTextWidget *_dirProgressText;
@@ -0,0 +1,250 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_intern.h"
+#include "audio/decoders/raw.h"
+
+#include "common/memstream.h"
+
+#include "../null_osystem.h"
+
+class MixerTestSuite : public CxxTest::TestSuite {
+private:
+	static Audio::AudioStream *createConstantStream(int16 value, uint frames) {
+		int16 *data = (int16 *)malloc(frames * 2 * sizeof(int16));
+		for (uint i = 0; i < frames * 2; ++i)
+			data[i] = TO_LE_16(value);
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream((const byte *)data, frames * 2 * sizeof(int16), DisposeAfterUse::YES);
+		return Audio::makeRawStream(stream, 22050, Audio::FLAG_16BITS | Audio::FLAG_STEREO | Audio::FLAG_LITTLE_ENDIAN, DisposeAfterUse::YES);
+	}
+
+	static void mixSound(bool lockFree, int16 value, int16 *out, uint frames) {
+		Audio::MixerImpl mixer(22050, lockFree);
+		mixer.setReady(true);
+
+		Audio::SoundHandle handle;
+		((Audio::Mixer &)mixer).playStream(Audio::Mixer::kSFXSoundType, &handle, createConstantStream(value, 4096));
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+
+		mixer.mixCallback((byte *)out, frames * 4);
+	}
+
+	static void mixRenderAhead(bool lockFree, int16 value, uint streamFrames, int16 *out, uint frames, uint callbacks) {
+		Audio::MixerImpl mixer(22050, lockFree);
+		mixer.setRenderAhead(100, 0);
+		mixer.setReady(true);
+
+		Audio::SoundHandle handle;
+		((Audio::Mixer &)mixer).playStream(Audio::Mixer::kSFXSoundType, &handle, createConstantStream(value, streamFrames), -1, 128);
+		mixer.enableRenderAhead(handle);
+
+		for (uint i = 0; i < callbacks; ++i)
+			mixer.mixCallback((byte *)(out + 2 * frames * i), frames * 4);
+
+		TS_ASSERT_EQUALS(mixer.getRenderAheadUnderruns(), 0U);
+	}
+
+public:
+	void test_lockfree_matches_default() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const uint frames = 1000;
+		int16 expected[frames * 2], actual[frames * 2];
+
+		mixSound(false, 1234, expected, frames);
+		mixSound(true, 1234, actual, frames);
+
+		for (uint i = 0; i < frames * 2; ++i)
+			TS_ASSERT_EQUALS(expected[i], actual[i]);
+#endif
+	}
+
+	void test_lockfree_stop() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixer(22050, true);
+		mixer.setReady(true);
+
+		Audio::SoundHandle handle;
+		((Audio::Mixer &)mixer).playStream(Audio::Mixer::kSFXSoundType, &handle, createConstantStream(1000, 4096), 42);
+		TS_ASSERT(mixer.isSoundIDActive(42));
+
+		mixer.stopHandle(handle);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT(!mixer.isSoundIDActive(42));
+
+		int16 buffer[512];
+		mixer.mixCallback((byte *)buffer, sizeof(buffer));
+		for (uint i = 0; i < ARRAYSIZE(buffer); ++i)
+			TS_ASSERT_EQUALS(buffer[i], 0);
+#endif
+	}
+
+	void test_lockfree_finished() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixer(22050, true);
+		mixer.setReady(true);
+
+		Audio::SoundHandle handle;
+		((Audio::Mixer &)mixer).playStream(Audio::Mixer::kSFXSoundType, &handle, createConstantStream(1000, 100));
+
+		// The first callback plays the whole stream, the second one notices
+		// it has finished
+		int16 buffer[512];
+		mixer.mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		mixer.mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+#endif
+	}
+
+	void test_render_ahead_matches_default() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const uint frames = 1000;
+		int16 expected[frames * 2], actual[frames * 2];
+
+		// Half the channel volume, so that the volume has to be applied while mixing
+		for (int lockFree = 0; lockFree < 2; ++lockFree) {
+			Audio::MixerImpl mixer(22050, lockFree);
+			mixer.setReady(true);
+			((Audio::Mixer &)mixer).playStream(Audio::Mixer::kSFXSoundType, nullptr, createConstantStream(1234, 4096), -1, 128);
+			mixer.mixCallback((byte *)expected, sizeof(expected));
+
+			mixRenderAhead(lockFree, 1234, 4096, actual, frames, 1);
+
+			for (uint i = 0; i < frames * 2; ++i)
+				TS_ASSERT_EQUALS(expected[i], actual[i]);
+		}
+#endif
+	}
+
+	void test_render_ahead_finished() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixer(22050);
+		mixer.setRenderAhead(10, 0);
+		mixer.setReady(true);
+
+		Audio::SoundHandle handle;
+		((Audio::Mixer &)mixer).playStream(Audio::Mixer::kSFXSoundType, &handle, createConstantStream(1000, 300));
+		mixer.enableRenderAhead(handle);
+
+		// The ring holds less than the stream, playing it spans several callbacks
+		int16 buffer[2 * 128];
+		mixer.mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT_EQUALS(buffer[0], 1000);
+		mixer.mixCallback((byte *)buffer, sizeof(buffer));
+		mixer.mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT_EQUALS(buffer[2 * 43], 1000);
+		TS_ASSERT_EQUALS(buffer[2 * 44], 0);
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		mixer.mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT_EQUALS(mixer.getRenderAheadUnderruns(), 0U);
+#endif
+	}
+
+	void test_render_ahead_disabled() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Without a latency budget, enabling it for a sound is a no-op
+		Audio::MixerImpl mixer(22050);
+		mixer.setReady(true);
+
+		Audio::SoundHandle handle;
+		((Audio::Mixer &)mixer).playStream(Audio::Mixer::kSFXSoundType, &handle, createConstantStream(1000, 4096));
+		TS_ASSERT_EQUALS(mixer.enableRenderAhead(handle), 0U);
+
+		int16 buffer[512];
+		mixer.mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT_EQUALS(buffer[0], 1000);
+		TS_ASSERT_EQUALS(mixer.getRenderAheadUnderruns(), 0U);
+#endif
+	}
+
+	void test_render_ahead_worker() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		for (int lockFree = 0; lockFree < 2; ++lockFree) {
+			Audio::MixerImpl mixer(22050, lockFree);
+			mixer.setRenderAhead(20, 1);
+			mixer.setReady(true);
+
+			const uint frames = 5000;
+			Audio::SoundHandle handle;
+			((Audio::Mixer &)mixer).playStream(Audio::Mixer::kSFXSoundType, &handle, createConstantStream(1000, frames));
+			TS_ASSERT_LESS_THAN_EQUALS(20U, mixer.enableRenderAhead(handle));
+
+			// The worker may fall behind, but no frame must get lost
+			uint played = 0;
+			int16 buffer[2 * 128];
+			for (int i = 0; i < 10000 && mixer.isSoundHandleActive(handle); ++i) {
+				mixer.mixCallback((byte *)buffer, sizeof(buffer));
+				for (uint j = 0; j < ARRAYSIZE(buffer); j += 2) {
+					if (buffer[j] == 1000)
+						++played;
+					else
+						TS_ASSERT_EQUALS(buffer[j], 0);
+				}
+				g_system->delayMillis(1);
+			}
+
+			TS_ASSERT(!mixer.isSoundHandleActive(handle));
+			TS_ASSERT_EQUALS(played, frames);
+		}
+#endif
+	}
+
+	void test_render_ahead_stop() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixer(22050, true);
+		mixer.setRenderAhead(100, 1);
+		mixer.setReady(true);
+
+		// Stop sounds while the worker is filling their ring
+		int16 buffer[2 * 128];
+		for (int i = 0; i < 50; ++i) {
+			Audio::SoundHandle handle;
+			((Audio::Mixer &)mixer).playStream(Audio::Mixer::kSFXSoundType, &handle, createConstantStream(1000, 100000));
+			mixer.enableRenderAhead(handle);
+			mixer.mixCallback((byte *)buffer, sizeof(buffer));
+			mixer.stopHandle(handle);
+			TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		}
+
+		mixer.mixCallback((byte *)buffer, sizeof(buffer));
+		for (uint i = 0; i < ARRAYSIZE(buffer); ++i)
+			TS_ASSERT_EQUALS(buffer[i], 0);
+#endif
+	}
+
+	void test_lockfree_clips_once() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixer(22050, true);
+		mixer.setReady(true);
+
+		// Two loud sounds and a cancelling one must not saturate early
+		((Audio::Mixer &)mixer).playStream(Audio::Mixer::kSFXSoundType, nullptr, createConstantStream(30000, 1024));
+		((Audio::Mixer &)mixer).playStream(Audio::Mixer::kSFXSoundType, nullptr, createConstantStream(30000, 1024));
+		((Audio::Mixer &)mixer).playStream(Audio::Mixer::kSFXSoundType, nullptr, createConstantStream(-30000, 1024));
+
+		int16 buffer[512];
+		mixer.mixCallback((byte *)buffer, sizeof(buffer));
+		for (uint i = 0; i < ARRAYSIZE(buffer); ++i)
+			TS_ASSERT_DELTA(buffer[i], 30000, 300);
+#endif
+	}
+};
@@ -0,0 +1,94 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/rate.h"
+#include "audio/mixer.h"
+#include "audio/decoders/raw.h"
+
+#include "common/config-manager.h"
+#include "common/memstream.h"
+
+#include <math.h>
+
+class RateConverterTestSuite : public CxxTest::TestSuite {
+private:
+	static Audio::AudioStream *createMonoStream(const int16 *samples, uint count, int rate) {
+		int16 *data = (int16 *)malloc(count * sizeof(int16));
+		for (uint i = 0; i < count; ++i)
+			WRITE_LE_UINT16(&data[i], samples[i]);
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream((const byte *)data, count * sizeof(int16), DisposeAfterUse::YES);
+		return Audio::makeRawStream(stream, rate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN, DisposeAfterUse::YES);
+	}
+
+	static Audio::RateConverter *createPolyphaseConverter(int inrate, int outrate) {
+		ConfMan.set("audio_resampler", "polyphase", Common::ConfigManager::kApplicationDomain);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inrate, outrate, false);
+		ConfMan.removeKey("audio_resampler", Common::ConfigManager::kApplicationDomain);
+		return converter;
+	}
+
+	static void convertSine(int inrate, int outrate, double freq) {
+		const uint inCount = inrate / 4;
+		int16 *in = new int16[inCount];
+		for (uint i = 0; i < inCount; ++i)
+			in[i] = (int16)(sin(2 * M_PI * freq * i / inrate) * 16000);
+
+		Audio::AudioStream *stream = createMonoStream(in, inCount, inrate);
+		Audio::RateConverter *converter = createPolyphaseConverter(inrate, outrate);
+
+		const uint outCount = outrate / 8;
+		int16 *out = new int16[outCount * 2];
+		memset(out, 0, outCount * 2 * sizeof(int16));
+		TS_ASSERT_EQUALS(converter->flow(*stream, out, outCount, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), (int)outCount);
+
+		// Output frame n is centered on the input position n * inrate / outrate.
+		// Skip the start, where the filter still sees the initial silence.
+		for (uint i = 64; i < outCount; ++i) {
+			const int16 expected = (int16)(sin(2 * M_PI * freq * i / outrate) * 16000);
+			TS_ASSERT_DELTA(out[i * 2], expected, 160);
+			TS_ASSERT_EQUALS(out[i * 2], out[i * 2 + 1]);
+		}
+
+		delete converter;
+		delete stream;
+		delete[] out;
+		delete[] in;
+	}
+
+public:
+	void test_polyphase_upsample() {
+		convertSine(11025, 48000, 440.0);
+		convertSine(22050, 48000, 1000.0);
+		convertSine(44100, 48000, 3000.0);
+	}
+
+	void test_polyphase_downsample() {
+		convertSine(48000, 22050, 1000.0);
+	}
+
+	void test_polyphase_uncommon_ratio() {
+		// Too many phases for an exact filter bank
+		convertSine(11127, 48000, 440.0);
+	}
+
+	void test_polyphase_constant() {
+		const uint inCount = 4096;
+		int16 *in = new int16[inCount];
+		for (uint i = 0; i < inCount; ++i)
+			in[i] = 12345;
+
+		Audio::AudioStream *stream = createMonoStream(in, inCount, 22050);
+		Audio::RateConverter *converter = createPolyphaseConverter(22050, 48000);
+
+		int16 out[2 * 1024];
+		memset(out, 0, sizeof(out));
+		TS_ASSERT_EQUALS(converter->flow(*stream, out, 1024, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 1024);
+
+		for (uint i = 64; i < 1024; ++i)
+			TS_ASSERT_DELTA(out[i * 2], 12345, 2);
+
+		delete converter;
+		delete stream;
+		delete[] in;
+	}
+};
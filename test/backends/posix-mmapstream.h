@@ -0,0 +1,123 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/fs.h"
+#include "common/ptr.h"
+
+#include "backends/fs/posix/posix-mmapstream.h"
+
+#include "../null_osystem.h"
+
+static const char *const kMappedFile = "test/engine-data/encoding.dat";
+
+class PosixMmapStreamTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		// FSDirectory and SearchSet need the file system and mutexes
+		Common::install_null_g_system();
+	}
+
+	void test_read() {
+		Common::ScopedPtr<Common::SeekableReadStream> file(Common::FSNode(kMappedFile).createReadStream());
+		Common::ScopedPtr<PosixMmapStream> stream(PosixMmapStream::makeFromPath(kMappedFile));
+		TS_ASSERT(file);
+		TS_ASSERT(stream);
+		if (!file || !stream)
+			return;
+
+		TS_ASSERT_EQUALS(stream->size(), file->size());
+
+		byte expected[256], actual[256];
+		while (!file->eos()) {
+			const uint32 expectedCount = file->read(expected, sizeof(expected));
+			const uint32 actualCount = stream->read(actual, sizeof(actual));
+			TS_ASSERT_EQUALS(actualCount, expectedCount);
+			TS_ASSERT_EQUALS(memcmp(actual, expected, expectedCount), 0);
+		}
+		TS_ASSERT(stream->eos());
+		TS_ASSERT(!stream->err());
+	}
+
+	void test_seek() {
+		Common::ScopedPtr<PosixMmapStream> stream(PosixMmapStream::makeFromPath(kMappedFile));
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+
+		const int64 size = stream->size();
+		TS_ASSERT_LESS_THAN(8, size);
+
+		byte last[4];
+		TS_ASSERT(stream->seek(-4, SEEK_END));
+		TS_ASSERT_EQUALS(stream->pos(), size - 4);
+		TS_ASSERT_EQUALS(stream->read(last, 4), 4U);
+		TS_ASSERT(!stream->eos());
+
+		byte b;
+		TS_ASSERT_EQUALS(stream->read(&b, 1), 0U);
+		TS_ASSERT(stream->eos());
+
+		// Seeking clears the end of stream flag, invalid seeks fail
+		TS_ASSERT(stream->seek(2, SEEK_SET));
+		TS_ASSERT(!stream->eos());
+		TS_ASSERT(stream->seek(2, SEEK_CUR));
+		TS_ASSERT_EQUALS(stream->pos(), 4);
+		TS_ASSERT(!stream->seek(-1, SEEK_SET));
+		TS_ASSERT(!stream->seek(size + 1, SEEK_SET));
+		TS_ASSERT_EQUALS(stream->pos(), 4);
+
+		byte again[4];
+		TS_ASSERT(stream->seek(size - 4, SEEK_SET));
+		TS_ASSERT_EQUALS(stream->read(again, 4), 4U);
+		TS_ASSERT_EQUALS(memcmp(again, last, 4), 0);
+	}
+
+	void test_substream_outlives_parent() {
+		PosixMmapStream *stream = PosixMmapStream::makeFromPath(kMappedFile);
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+
+		byte expected[16];
+		TS_ASSERT(stream->seek(4, SEEK_SET));
+		TS_ASSERT_EQUALS(stream->read(expected, sizeof(expected)), sizeof(expected));
+		TS_ASSERT(stream->seek(4, SEEK_SET));
+
+		Common::ScopedPtr<Common::SeekableReadStream> sub(stream->readStream(sizeof(expected)));
+		TS_ASSERT_EQUALS(stream->pos(), 4 + (int64)sizeof(expected));
+		delete stream;
+
+		TS_ASSERT(sub);
+		if (!sub)
+			return;
+
+		// The substream still reads from the mapping
+		TS_ASSERT_EQUALS(sub->size(), (int64)sizeof(expected));
+		byte actual[sizeof(expected) + 1];
+		TS_ASSERT_EQUALS(sub->read(actual, sizeof(actual)), sizeof(expected));
+		TS_ASSERT(sub->eos());
+		TS_ASSERT_EQUALS(memcmp(actual, expected, sizeof(expected)), 0);
+	}
+
+	void test_archive_threshold() {
+		Common::FSDirectory dir("test/engine-data");
+		Common::SearchSet set;
+		set.add("dir", new Common::FSDirectory("test/engine-data"));
+
+		Common::ScopedPtr<Common::SeekableReadStream> file(dir.createReadStreamForMember("encoding.dat"));
+		TS_ASSERT(file);
+		if (!file)
+			return;
+
+		// Only files of at least the given size are mapped
+		const uint32 size = file->size();
+		Common::ScopedPtr<Common::SeekableReadStream> mapped(dir.createMappedReadStreamForMember("encoding.dat", size));
+		Common::ScopedPtr<Common::SeekableReadStream> small(dir.createMappedReadStreamForMember("encoding.dat", size + 1));
+		TS_ASSERT(dynamic_cast<PosixMmapStream *>(mapped.get()));
+		TS_ASSERT(small && !dynamic_cast<PosixMmapStream *>(small.get()));
+
+		mapped.reset(set.createMappedReadStreamForMember("encoding.dat", size));
+		TS_ASSERT(dynamic_cast<PosixMmapStream *>(mapped.get()));
+		TS_ASSERT(!set.createMappedReadStreamForMember("missing.dat", 0));
+	}
+};
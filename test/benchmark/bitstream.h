@@ -0,0 +1,79 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/bitstream.h"
+#include "common/memstream.h"
+
+#include "../null_osystem.h"
+#include "../benchmark_timer.h"
+
+class BitStreamBenchmarkSuite : public CxxTest::TestSuite {
+private:
+	enum {
+		kDataSize = 1 << 20,
+		kRounds = 20
+	};
+
+	/** Mixed-width reads and peeks, like a codec parsing headers and coefficients. */
+	template<class BITSTREAM>
+	static uint32 parse(BITSTREAM &bits, uint32 &reads) {
+		static const uint8 widths[] = { 1, 3, 7, 2, 12, 1, 5, 16, 4, 9, 1, 24 };
+
+		uint32 checksum = 0;
+		uint i = 0;
+		while (bits.pos() + 32 <= bits.size()) {
+			const uint8 n = widths[i++ % ARRAYSIZE(widths)];
+			if (n == 9)
+				checksum += bits.peekBits(n);
+			checksum += bits.getBits(n);
+			reads++;
+		}
+		return checksum;
+	}
+
+	template<class BITSTREAM, class BITSTREAMMEMORY>
+	static void benchLayout(const char *name) {
+		byte *data = new byte[kDataSize];
+		uint32 seed = 1;
+		for (uint32 i = 0; i < kDataSize; i++) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = seed >> 16;
+		}
+
+		uint32 reads = 0, checksum = 0, checksumMemory = 0;
+		BenchmarkTimer timer;
+		for (int round = 0; round < kRounds; round++) {
+			Common::MemoryReadStream stream(data, kDataSize);
+			BITSTREAM bits(stream);
+			checksum += parse(bits, reads);
+		}
+		timer.report(Common::String::format("%s, read stream", name).c_str(), reads);
+
+		reads = 0;
+		BenchmarkTimer timerMemory;
+		for (int round = 0; round < kRounds; round++) {
+			Common::BitStreamMemoryStream stream(data, kDataSize);
+			BITSTREAMMEMORY bits(stream);
+			checksumMemory += parse(bits, reads);
+		}
+		timerMemory.report(Common::String::format("%s, memory stream", name).c_str(), reads);
+		TS_ASSERT_EQUALS(checksum, checksumMemory);
+
+		delete[] data;
+	}
+
+public:
+	void test_layouts() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// QDM2
+		benchLayout<Common::BitStream32LELSB, Common::BitStreamMemory32LELSB>("32LELSB");
+		// PSX
+		benchLayout<Common::BitStream16LEMSB, Common::BitStreamMemory16LEMSB>("16LEMSB");
+		// JYV1, ADL
+		benchLayout<Common::BitStream8MSB, Common::BitStreamMemory8MSB>("8MSB");
+		// SVQ1
+		benchLayout<Common::BitStream32BEMSB, Common::BitStreamMemory32BEMSB>("32BEMSB");
+#endif
+	}
+};
@@ -0,0 +1,112 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/bitstream.h"
+#include "common/huffman.h"
+#include "common/memstream.h"
+
+#include "audio/decoders/wma.h"
+#include "audio/decoders/wmadata.h"
+#include "video/binkdata.h"
+
+#include "../null_osystem.h"
+#include "../benchmark_timer.h"
+
+class HuffmanBenchmarkSuite : public CxxTest::TestSuite {
+private:
+	enum {
+		kNumSymbols = 2000000,
+		kRounds = 5
+	};
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	/**
+	 * Encode symbols drawn from the codebook, either uniformly or with the
+	 * probabilities the code lengths were made for, as in real streams.
+	 */
+	static byte *encode(const uint32 *codes, const uint8 *lengths, uint32 codeCount, bool msb, bool uniform, uint32 &size) {
+		uint8 maxLength = 0;
+		for (uint32 i = 0; i < codeCount; i++)
+			maxLength = MAX(maxLength, lengths[i]);
+
+		// Symbol i has a weight of 2^(maxLength - length)
+		uint64 *cumulative = new uint64[codeCount];
+		uint64 total = 0;
+		for (uint32 i = 0; i < codeCount; i++) {
+			total += uniform ? 1 : (uint64)1 << (maxLength - lengths[i]);
+			cumulative[i] = total;
+		}
+
+		size = kNumSymbols * maxLength / 8 + 8;
+		byte *data = new byte[size];
+		memset(data, 0, size);
+
+		uint32 seed = 1;
+		uint64 pos = 0;
+		for (uint32 n = 0; n < kNumSymbols; n++) {
+			const uint64 r = (((uint64)nextRandom(seed) << 24) | nextRandom(seed)) % total;
+			uint32 lo = 0, hi = codeCount - 1;
+			while (lo < hi) {
+				const uint32 mid = (lo + hi) / 2;
+				if (cumulative[mid] <= r)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+
+			const uint32 code = codes[lo];
+			const uint8 length = lengths[lo];
+			for (uint8 b = 0; b < length; b++, pos++) {
+				const uint32 bit = msb ? (code >> (length - 1 - b)) & 1 : (code >> b) & 1;
+				data[pos / 8] |= bit << (msb ? 7 - pos % 8 : pos % 8);
+			}
+		}
+
+		delete[] cumulative;
+		return data;
+	}
+
+	template<class BITSTREAM>
+	static void benchCodebook(const char *name, const uint32 *codes, const uint8 *lengths, uint32 codeCount, bool uniform) {
+		Common::Huffman<BITSTREAM> huffman(0, codeCount, codes, lengths);
+
+		uint32 size;
+		byte *data = encode(codes, lengths, codeCount, BITSTREAM::isMSB2LSB(), uniform, size);
+
+		uint32 checksum = 0;
+		BenchmarkTimer timer;
+		for (int round = 0; round < kRounds; round++) {
+			Common::MemoryReadStream stream(data, size);
+			BITSTREAM bits(stream);
+			for (uint32 n = 0; n < kNumSymbols; n++)
+				checksum += huffman.getSymbol(bits);
+		}
+		timer.report(name, kRounds * kNumSymbols);
+		TS_ASSERT_DIFFERS(checksum, 0U);
+
+		delete[] data;
+	}
+
+public:
+	void test_bink() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Bink codebooks only have short codes
+		benchCodebook<Common::BitStream32LELSB>("Bink codebook 13", Video::binkHuffmanCodes[13], Video::binkHuffmanLengths[13], 16, false);
+#endif
+	}
+
+	void test_wma() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		benchCodebook<Common::BitStream8MSB>("WMA coefficients 0", Audio::coef0Huffcodes, Audio::coef0Huffbits, ARRAYSIZE(Audio::coef0Huffbits), false);
+		benchCodebook<Common::BitStream8MSB>("WMA coefficients 2", Audio::coef2Huffcodes, Audio::coef2Huffbits, ARRAYSIZE(Audio::coef2Huffbits), false);
+		benchCodebook<Common::BitStream8MSB>("WMA coefficients 2, uniform", Audio::coef2Huffcodes, Audio::coef2Huffbits, ARRAYSIZE(Audio::coef2Huffbits), true);
+#endif
+	}
+};
@@ -0,0 +1,102 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/worker-pool.h"
+#include "graphics/scalerplugin.h"
+#include "graphics/scaler/dotmatrix.h"
+#include "graphics/scaler/edge.h"
+#include "graphics/scaler/hq.h"
+#include "graphics/scaler/sai.h"
+#include "graphics/scaler/scalebit.h"
+#include "graphics/scaler/tv.h"
+
+#include "../null_osystem.h"
+#include "../benchmark_timer.h"
+
+class ScalerBenchmarkSuite : public CxxTest::TestSuite {
+private:
+	enum {
+		kWidth = 640,
+		kHeight = 480,
+		kPadding = 4,
+		kFrames = 20
+	};
+
+	/**
+	 * Scale full 640x480 frames, as after a screen change, and report the
+	 * time per frame in the calling thread only and in bands on the pool.
+	 */
+	static void benchScaler(ScalerPluginObject &scaler, uint factor, Common::WorkerPool &pool) {
+		const Graphics::PixelFormat format(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		const uint srcPitch = (kWidth + 2 * kPadding) * 2;
+		const uint dstPitch = kWidth * factor * 2;
+		byte *src = new byte[(kHeight + 2 * kPadding) * srcPitch];
+		byte *dst = new byte[kHeight * factor * dstPitch];
+
+		uint16 *pixels = (uint16 *)(src + kPadding * srcPitch + kPadding * 2);
+		for (int y = 0; y < kHeight; ++y) {
+			for (int x = 0; x < kWidth; ++x)
+				pixels[y * srcPitch / 2 + x] = format.RGBToColor((x / 8 + y / 8) % 3 ? 40 : 220, x ^ y, (x * y) & 0xff);
+		}
+
+		scaler.initialize(format);
+		scaler.setFactor(factor);
+
+		for (int threaded = 0; threaded < 2; ++threaded) {
+			scaler.setWorkerPool(threaded ? &pool : nullptr);
+
+			BenchmarkTimer timer;
+			for (int i = 0; i < kFrames; ++i)
+				scaler.scale((const uint8 *)pixels, srcPitch, dst, dstPitch, kWidth, kHeight, 0, 0);
+
+			Common::String label = Common::String::format("%s %ux, %s", scaler.getPrettyName(), factor,
+			                                              threaded ? "bands" : "single thread");
+			Common::String message = Common::String::format("%-40s %8.2f ms/frame", label.c_str(), (double)timer.elapsed() / kFrames);
+			TS_TRACE(message.c_str());
+		}
+
+		scaler.setWorkerPool(nullptr);
+		scaler.deinitialize();
+		delete[] dst;
+		delete[] src;
+	}
+
+public:
+	void test_scalers() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Backends without threads (like the null one) run the bands inline,
+		// which only shows the cost of splitting the rects
+		Common::WorkerPool pool(Common::WorkerPool::getDefaultThreadCount(3));
+		Common::String message = Common::String::format("Scaling with %u extra threads", pool.getThreadCount());
+		TS_TRACE(message.c_str());
+
+#ifdef USE_HQ_SCALERS
+		HQPlugin hq;
+		benchScaler(hq, 2, pool);
+		benchScaler(hq, 3, pool);
+#endif
+#ifdef USE_EDGE_SCALERS
+		EdgePlugin *edge = new EdgePlugin();
+		benchScaler(*edge, 2, pool);
+		benchScaler(*edge, 3, pool);
+		delete edge;
+#endif
+#ifdef USE_SCALERS
+		AdvMamePlugin advMame;
+		benchScaler(advMame, 2, pool);
+		benchScaler(advMame, 3, pool);
+		benchScaler(advMame, 4, pool);
+
+		SAIPlugin sai;
+		benchScaler(sai, 2, pool);
+
+		TVPlugin tv;
+		benchScaler(tv, 2, pool);
+
+		DotMatrixPlugin dotMatrix;
+		benchScaler(dotMatrix, 2, pool);
+#endif
+#endif
+	}
+};
@@ -0,0 +1,102 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+#include "common/ustr.h"
+#include "graphics/font.h"
+#include "graphics/surface.h"
+#include "graphics/fonts/ttf.h"
+
+#include "../null_osystem.h"
+#include "../benchmark_timer.h"
+
+class TTFBenchmarkSuite : public CxxTest::TestSuite {
+private:
+	enum {
+		kWidth = 640,
+		kHeight = 400,
+		kRowHeight = 18,
+		kFrames = 500
+	};
+
+#ifdef USE_FREETYPE2
+	/**
+	 * Redraw a scrolling launcher game list, the way the GUI redraws the
+	 * visible rows of a list widget every frame.
+	 */
+	static void benchGameList(const Graphics::Font &font, uint cacheSize, const char *name) {
+		static const char *const games[] = {
+			"Beneath a Steel Sky (CD/DOS/English)",
+			"Day of the Tentacle (CD/DOS/English)",
+			"Full Throttle (DOS/English)",
+			"Indiana Jones and the Fate of Atlantis (CD/DOS/English)",
+			"Loom (VGA/DOS/English)",
+			"Maniac Mansion (Enhanced/DOS/English)",
+			"Monkey Island 2: LeChuck's Revenge (DOS/English)",
+			"Sam & Max Hit the Road (CD/DOS/English)",
+			"The Curse of Monkey Island (Windows/English)",
+			"The Dig (DOS/English)",
+			"The Secret of Monkey Island (VGA/DOS/English)",
+			"Zak McKracken and the Alien Mindbenders (FM-TOWNS/Japanese)"
+		};
+
+		Common::U32String list[60];
+		for (uint i = 0; i < ARRAYSIZE(list); ++i)
+			list[i] = Common::U32String(Common::String::format("%s #%u", games[i % ARRAYSIZE(games)], i));
+
+		Graphics::Surface surface;
+		surface.create(kWidth, kHeight, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+
+		Graphics::setTTFTextRunCacheSize(cacheSize);
+		Graphics::resetTTFTextRunCacheStats();
+
+		const uint rows = kHeight / kRowHeight;
+		uint strings = 0;
+		BenchmarkTimer timer;
+		for (uint frame = 0; frame < kFrames; ++frame) {
+			surface.fillRect(Common::Rect(kWidth, kHeight), 0);
+
+			// Scroll by a row every 10 frames, with the selection following
+			const uint top = (frame / 10) % (ARRAYSIZE(list) - rows);
+			for (uint row = 0; row < rows; ++row) {
+				const uint32 color = (row == 5) ? 0xFFE0 : 0xFFFF;
+				font.drawString(&surface, list[top + row], 8, row * kRowHeight, 300, color, Graphics::kTextAlignLeft, 0, true);
+				++strings;
+			}
+		}
+		timer.report(name, strings);
+
+		uint32 hits, misses;
+		Graphics::getTTFTextRunCacheStats(hits, misses);
+		if (hits + misses) {
+			Common::String message = Common::String::format("%-40s %5.1f%% hits", name, hits * 100.0 / (hits + misses));
+			TS_TRACE(message.c_str());
+		}
+
+		Graphics::setTTFTextRunCacheSize(256);
+		surface.free();
+	}
+#endif
+
+public:
+	void test_game_list() {
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::SeekableReadStream *stream = Common::FSNode("test/engine-data/FreeSans.ttf").createReadStream();
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+
+		Graphics::Font *font = Graphics::loadTTFFont(*stream, 12, Graphics::kTTFSizeModeCharacter, 0, Graphics::kTTFRenderModeLight);
+		delete stream;
+		TS_ASSERT(font);
+		if (!font)
+			return;
+
+		benchGameList(*font, 0, "Game list, no text run cache");
+		benchGameList(*font, 256, "Game list, text run cache");
+
+		delete font;
+#endif
+	}
+};
@@ -0,0 +1,62 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include "../null_osystem.h"
+#include "../benchmark_timer.h"
+
+class YUVToRGBBenchmarkSuite : public CxxTest::TestSuite {
+private:
+	enum {
+		kWidth = 1280,
+		kHeight = 720,
+		kFrames = 50
+	};
+
+	/** Convert 720p frames, as a Theora or Bink video would. */
+	static void benchConvert(const Graphics::PixelFormat &format, bool alpha, const char *name) {
+		byte *planes = new byte[4 * kWidth * kHeight];
+		for (int i = 0; i < 4 * kWidth * kHeight; ++i)
+			planes[i] = (i * 7 + (i >> 11)) & 0xff;
+
+		const byte *y = planes;
+		const byte *u = planes + kWidth * kHeight;
+		const byte *v = planes + 2 * kWidth * kHeight;
+		const byte *a = planes + 3 * kWidth * kHeight;
+
+		Graphics::Surface surface;
+		surface.create(kWidth, kHeight, format);
+
+		for (int vectorized = 0; vectorized < 2; ++vectorized) {
+			YUVToRGBMan.setVectorized(vectorized);
+
+			BenchmarkTimer timer;
+			for (int i = 0; i < kFrames; ++i) {
+				if (alpha)
+					YUVToRGBMan.convert420Alpha(&surface, Graphics::YUVToRGBManager::kScaleITU, y, u, v, a, kWidth, kHeight, kWidth, kWidth / 2);
+				else
+					YUVToRGBMan.convert420(&surface, Graphics::YUVToRGBManager::kScaleITU, y, u, v, kWidth, kHeight, kWidth, kWidth / 2);
+			}
+
+			Common::String label = Common::String::format("%s, %s", name, vectorized ? "vectorized" : "lookup tables");
+			Common::String message = Common::String::format("%-40s %8.2f ms/frame", label.c_str(), (double)timer.elapsed() / kFrames);
+			TS_TRACE(message.c_str());
+		}
+
+		YUVToRGBMan.setVectorized(true);
+		surface.free();
+		delete[] planes;
+	}
+
+public:
+	void test_convert420() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		benchConvert(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), false, "YUV420 to 565");
+		benchConvert(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), false, "YUV420 to 8888");
+		benchConvert(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), true, "YUVA420 to 8888");
+#endif
+	}
+};
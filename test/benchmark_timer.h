@@ -0,0 +1,33 @@
+#ifndef TEST_BENCHMARK_TIMER_H
+#define TEST_BENCHMARK_TIMER_H
+
+#include <cxxtest/TestSuite.h>
+
+#include "common/str.h"
+#include "common/system.h"
+
+/**
+ * Wall clock timer for the microbenchmarks, reporting through TS_TRACE.
+ * Needs the null OSystem to be installed.
+ */
+class BenchmarkTimer {
+public:
+	BenchmarkTimer() : _start(g_system->getMillis()) {}
+
+	void restart() { _start = g_system->getMillis(); }
+
+	uint32 elapsed() const { return g_system->getMillis() - _start; }
+
+	/** Report the time since the last restart and how much work it was. */
+	void report(const char *name, uint iterations) {
+		const uint32 millis = MAX<uint32>(elapsed(), 1);
+		Common::String message = Common::String::format("%-40s %6u ms, %8.1f ns/iteration", name, millis, millis * 1000000.0 / iterations);
+		TS_TRACE(message.c_str());
+		restart();
+	}
+
+private:
+	uint32 _start;
+};
+
+#endif
@@ -255,4 +255,57 @@ public:
 		tmpl_align_16<Common::MemoryReadStream, Common::BitStream16BELSB>();
 		tmpl_align_16<Common::BitStreamMemoryStream, Common::BitStreamMemory16BELSB>();
 	}
+
+private:
+	/**
+	 * Memory bit streams refill their container a block at a time, they must
+	 * read the same bits as the generic ones, up to and past the end.
+	 */
+	template<class BS, class BSM>
+	void tmpl_memory_matches_generic() {
+		byte contents[101];
+		uint32 seed = 1;
+		for (uint i = 0; i < sizeof(contents); ++i) {
+			seed = seed * 1103515245 + 12345;
+			contents[i] = seed >> 16;
+		}
+
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		Common::BitStreamMemoryStream bms(contents, sizeof(contents));
+		BS bs(ms);
+		BSM bsm(bms);
+		TS_ASSERT_EQUALS(bs.size(), bsm.size());
+
+		for (int pass = 0; pass < 2; ++pass) {
+			while (bs.pos() < bs.size()) {
+				seed = seed * 1103515245 + 12345;
+				const uint32 n = (seed >> 16) % 33;
+				TS_ASSERT_EQUALS(bs.peekBits(n), bsm.peekBits(n));
+				if ((seed >> 8) & 1) {
+					bs.skip(n);
+					bsm.skip(n);
+				} else {
+					TS_ASSERT_EQUALS(bs.getBits(n), bsm.getBits(n));
+				}
+				TS_ASSERT_EQUALS(bs.pos(), bsm.pos());
+				TS_ASSERT_EQUALS(bs.eos(), bsm.eos());
+			}
+
+			bs.rewind();
+			bsm.rewind();
+		}
+	}
+public:
+	void test_memory_matches_generic() {
+		tmpl_memory_matches_generic<Common::BitStream8MSB, Common::BitStreamMemory8MSB>();
+		tmpl_memory_matches_generic<Common::BitStream8LSB, Common::BitStreamMemory8LSB>();
+		tmpl_memory_matches_generic<Common::BitStream16LEMSB, Common::BitStreamMemory16LEMSB>();
+		tmpl_memory_matches_generic<Common::BitStream16LELSB, Common::BitStreamMemory16LELSB>();
+		tmpl_memory_matches_generic<Common::BitStream16BEMSB, Common::BitStreamMemory16BEMSB>();
+		tmpl_memory_matches_generic<Common::BitStream16BELSB, Common::BitStreamMemory16BELSB>();
+		tmpl_memory_matches_generic<Common::BitStream32LEMSB, Common::BitStreamMemory32LEMSB>();
+		tmpl_memory_matches_generic<Common::BitStream32LELSB, Common::BitStreamMemory32LELSB>();
+		tmpl_memory_matches_generic<Common::BitStream32BEMSB, Common::BitStreamMemory32BEMSB>();
+		tmpl_memory_matches_generic<Common::BitStream32BELSB, Common::BitStreamMemory32BELSB>();
+	}
 };
@@ -10,7 +10,63 @@
 * TODO: It could be improved by generating one at runtime.
 */
 class HuffmanTestSuite : public CxxTest::TestSuite {
+	private:
+	/**
+	 * Encode a sequence of symbols of a canonical code with the lengths
+	 * 1, 2, ..., 23, 24, 24 and check that all of them are decoded,
+	 * including those going through several levels of sub tables.
+	 */
+	template<class BITSTREAM>
+	void checkLongCodes(bool msb) {
+		const uint32 codeCount = 25;
+		uint8 lengths[codeCount];
+		uint32 codes[codeCount];
+		uint32 symbols[codeCount];
+
+		uint32 code = 0;
+		for (uint32 i = 0; i < codeCount; i++) {
+			lengths[i] = MIN<uint8>(i + 1, 24);
+			if (i > 0)
+				code = (code + 1) << (lengths[i] - lengths[i - 1]);
+			symbols[i] = 1000 + i;
+			// LSB2MSB streams read the lowest bit of a code first
+			codes[i] = msb ? code : Common::REVERSEBITS(code) >> (32 - lengths[i]);
+		}
+
+		Common::Huffman<BITSTREAM> h(0, codeCount, codes, lengths, symbols);
+
+		byte input[256];
+		memset(input, 0, sizeof(input));
+		uint32 sequence[64];
+		uint32 pos = 0;
+		for (uint32 i = 0; i < ARRAYSIZE(sequence); i++) {
+			sequence[i] = (i * 7) % codeCount;
+			const uint32 c = codes[sequence[i]];
+			const uint8 length = lengths[sequence[i]];
+			for (uint8 b = 0; b < length; b++, pos++) {
+				const uint32 bit = msb ? (c >> (length - 1 - b)) & 1 : (c >> b) & 1;
+				input[pos / 8] |= bit << (msb ? 7 - pos % 8 : pos % 8);
+			}
+		}
+		TS_ASSERT(pos <= sizeof(input) * 8);
+
+		Common::MemoryReadStream ms(input, sizeof(input));
+		BITSTREAM bs(ms);
+
+		for (uint32 i = 0; i < ARRAYSIZE(sequence); i++)
+			TS_ASSERT_EQUALS(h.getSymbol(bs), symbols[sequence[i]]);
+		TS_ASSERT_EQUALS(bs.pos(), pos);
+	}
+
 	public:
+	void test_long_codes_msb() {
+		checkLongCodes<Common::BitStream8MSB>(true);
+	}
+
+	void test_long_codes_lsb() {
+		checkLongCodes<Common::BitStream8LSB>(false);
+	}
+
 	void test_get_with_full_symbols() {
 
 		/*
@@ -0,0 +1,195 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/str-array.h"
+
+#include "../null_osystem.h"
+
+class SearchSetTestSuite : public CxxTest::TestSuite {
+private:
+	// An archive with a fixed set of one-byte members, whose contents are the member's tag
+	class TagArchive : public Common::Archive {
+	public:
+		TagArchive(byte tag) : _tag(tag), _lookups(0) {}
+
+		void addName(const Common::String &name) { _names.push_back(name); }
+		void removeNames() { _names.clear(); }
+
+		bool hasFile(const Common::String &name) const override {
+			++_lookups;
+			for (Common::StringArray::const_iterator i = _names.begin(); i != _names.end(); ++i) {
+				if (i->equalsIgnoreCase(name))
+					return true;
+			}
+			return false;
+		}
+
+		int listMembers(Common::ArchiveMemberList &list) const override {
+			for (Common::StringArray::const_iterator i = _names.begin(); i != _names.end(); ++i)
+				list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(*i, this)));
+			return _names.size();
+		}
+
+		const Common::ArchiveMemberPtr getMember(const Common::String &name) const override {
+			return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(name, this));
+		}
+
+		Common::SeekableReadStream *createReadStreamForMember(const Common::String &name) const override {
+			if (!hasFile(name))
+				return nullptr;
+			return new Common::MemoryReadStream(&_tag, 1);
+		}
+
+		byte _tag;
+		Common::StringArray _names;
+		mutable uint _lookups;
+	};
+
+	static byte readTag(const Common::SearchSet &set, const char *name) {
+		Common::SeekableReadStream *stream = set.createReadStreamForMember(name);
+		if (!stream)
+			return 0;
+		byte tag = stream->readByte();
+		delete stream;
+		return tag;
+	}
+
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		// The member index is guarded by a mutex
+		Common::install_null_g_system();
+#endif
+	}
+
+	void test_priority() {
+		Common::SearchSet set;
+		TagArchive *low = new TagArchive(1);
+		TagArchive *high = new TagArchive(2);
+		low->addName("both");
+		low->addName("low");
+		high->addName("both");
+
+		set.add("low", low, 0);
+		set.add("high", high, 10);
+
+		TS_ASSERT_EQUALS(readTag(set, "both"), 2);
+		TS_ASSERT_EQUALS(readTag(set, "low"), 1);
+		TS_ASSERT_EQUALS(readTag(set, "none"), 0);
+		TS_ASSERT(!set.hasFile("none"));
+
+		set.setPriority("low", 20);
+		TS_ASSERT_EQUALS(readTag(set, "both"), 1);
+
+		set.remove("low");
+		TS_ASSERT_EQUALS(readTag(set, "both"), 2);
+		TS_ASSERT(!set.hasFile("low"));
+	}
+
+	void test_index() {
+		Common::SearchSet set;
+		TagArchive *first = new TagArchive(1);
+		TagArchive *second = new TagArchive(2);
+		second->addName("file");
+
+		set.add("first", first, 10);
+		set.add("second", second, 0);
+
+		TS_ASSERT(set.hasFile("file"));
+		TS_ASSERT(!set.hasFile("missing"));
+		TS_ASSERT_EQUALS(set.getIndexHits(), 0U);
+		TS_ASSERT_EQUALS(set.getIndexMisses(), 2U);
+
+		// Repeated lookups, found or not, don't ask the other archives again
+		const uint lookups = first->_lookups;
+		for (int i = 0; i < 10; ++i) {
+			TS_ASSERT(set.hasFile("file"));
+			TS_ASSERT(!set.hasFile("missing"));
+		}
+		TS_ASSERT_EQUALS(readTag(set, "file"), 2);
+		TS_ASSERT_EQUALS(first->_lookups, lookups);
+		TS_ASSERT_EQUALS(set.getIndexHits(), 21U);
+
+		set.resetIndexStats();
+		TS_ASSERT_EQUALS(set.getIndexHits(), 0U);
+		TS_ASSERT_EQUALS(set.getIndexMisses(), 0U);
+
+		// Archives that change must invalidate the index
+		first->addName("missing");
+		TS_ASSERT(!set.hasFile("missing"));
+		Common::SearchSet::invalidateIndex();
+		TS_ASSERT(set.hasFile("missing"));
+		TS_ASSERT_EQUALS(readTag(set, "missing"), 1);
+	}
+
+	void test_index_ignores_case() {
+		Common::SearchSet set;
+		TagArchive *arc = new TagArchive(1);
+		arc->addName("File.DAT");
+		set.add("arc", arc);
+
+		TS_ASSERT(set.hasFile("file.dat"));
+		TS_ASSERT(set.hasFile("FILE.DAT"));
+		TS_ASSERT_EQUALS(set.getIndexMisses(), 1U);
+		TS_ASSERT_EQUALS(set.getIndexHits(), 1U);
+	}
+
+	void test_index_removed_member() {
+		Common::SearchSet set;
+		TagArchive *first = new TagArchive(1);
+		TagArchive *second = new TagArchive(2);
+		first->addName("file");
+		second->addName("file");
+		set.add("first", first, 10);
+		set.add("second", second, 0);
+
+		TS_ASSERT_EQUALS(readTag(set, "file"), 1);
+
+		// Members which went away aren't reported from the index
+		first->removeNames();
+		TS_ASSERT(set.hasFile("file"));
+		TS_ASSERT_EQUALS(readTag(set, "file"), 2);
+
+		second->removeNames();
+		TS_ASSERT(!set.hasFile("file"));
+		TS_ASSERT_EQUALS(readTag(set, "file"), 0);
+	}
+
+	void test_nested() {
+		Common::SearchSet outer;
+		Common::SearchSet *inner = new Common::SearchSet();
+		outer.add("inner", inner);
+
+		TS_ASSERT(!outer.hasFile("file"));
+
+		// Adding to the inner set is visible through the outer one
+		TagArchive *arc = new TagArchive(3);
+		arc->addName("file");
+		inner->add("arc", arc);
+		TS_ASSERT(outer.hasFile("file"));
+		TS_ASSERT_EQUALS(readTag(outer, "file"), 3);
+
+		inner->clear();
+		TS_ASSERT(!outer.hasFile("file"));
+	}
+
+	void test_index_missing_names() {
+		Common::SearchSet set;
+		TagArchive *arc = new TagArchive(1);
+		arc->addName("file");
+		set.add("arc", arc);
+
+		TS_ASSERT(set.hasFile("file"));
+		TS_ASSERT(!set.hasFile("missing"));
+
+		// Many missing names make the index start over
+		for (int i = 0; i < 2000; ++i)
+			TS_ASSERT(!set.hasFile(Common::String::format("missing%d", i)));
+
+		const uint lookups = arc->_lookups;
+		TS_ASSERT(!set.hasFile("missing"));
+		TS_ASSERT(set.hasFile("file"));
+		TS_ASSERT_EQUALS(arc->_lookups, lookups + 2);
+	}
+};
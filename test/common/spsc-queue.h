@@ -0,0 +1,71 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/spsc-queue.h"
+
+class SPSCQueueTestSuite : public CxxTest::TestSuite {
+public:
+	void test_empty() {
+		Common::SPSCQueue<int, 8> queue;
+		int value = 0;
+
+		TS_ASSERT(queue.empty());
+		TS_ASSERT(!queue.full());
+		TS_ASSERT_EQUALS(queue.size(), 0U);
+		TS_ASSERT(!queue.pop(value));
+		TS_ASSERT(!queue.peek(value));
+	}
+
+	void test_push_pop_order() {
+		Common::SPSCQueue<int, 8> queue;
+		int value = 0;
+
+		TS_ASSERT(queue.push(42));
+		TS_ASSERT(queue.push(-23));
+		TS_ASSERT(queue.push(7));
+		TS_ASSERT_EQUALS(queue.size(), 3U);
+
+		TS_ASSERT(queue.peek(value));
+		TS_ASSERT_EQUALS(value, 42);
+		TS_ASSERT_EQUALS(queue.size(), 3U);
+
+		TS_ASSERT(queue.pop(value));
+		TS_ASSERT_EQUALS(value, 42);
+		TS_ASSERT(queue.pop(value));
+		TS_ASSERT_EQUALS(value, -23);
+		TS_ASSERT(queue.pop(value));
+		TS_ASSERT_EQUALS(value, 7);
+		TS_ASSERT(queue.empty());
+	}
+
+	void test_full() {
+		Common::SPSCQueue<int, 4> queue;
+		int value = 0;
+
+		TS_ASSERT_EQUALS(queue.capacity(), 3U);
+		TS_ASSERT(queue.push(1));
+		TS_ASSERT(queue.push(2));
+		TS_ASSERT(queue.push(3));
+		TS_ASSERT(queue.full());
+		TS_ASSERT(!queue.push(4));
+
+		TS_ASSERT(queue.pop(value));
+		TS_ASSERT_EQUALS(value, 1);
+		TS_ASSERT(!queue.full());
+		TS_ASSERT(queue.push(4));
+	}
+
+	void test_wrap_around() {
+		Common::SPSCQueue<int, 4> queue;
+		int value = 0;
+
+		for (int i = 0; i < 100; ++i) {
+			TS_ASSERT(queue.push(i));
+			TS_ASSERT(queue.push(i + 1000));
+			TS_ASSERT(queue.pop(value));
+			TS_ASSERT_EQUALS(value, i);
+			TS_ASSERT(queue.pop(value));
+			TS_ASSERT_EQUALS(value, i + 1000);
+			TS_ASSERT(queue.empty());
+		}
+	}
+};
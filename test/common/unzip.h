@@ -0,0 +1,270 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/unzip.h"
+#include "common/zlib.h"
+
+class UnzipTestSuite : public CxxTest::TestSuite {
+private:
+	struct Member {
+		const char *name;
+		uint16 method;
+		uint32 crc;
+		uint32 size;
+		const byte *data;
+		uint32 dataSize;
+	};
+
+	static void writeLocalHeader(Common::WriteStream &out, const Member &member) {
+		out.writeUint32LE(0x04034b50);
+		out.writeUint16LE(20);
+		out.writeUint16LE(0);
+		out.writeUint16LE(member.method);
+		out.writeUint32LE(0); // time and date
+		out.writeUint32LE(member.crc);
+		out.writeUint32LE(member.dataSize);
+		out.writeUint32LE(member.size);
+		out.writeUint16LE(strlen(member.name));
+		out.writeUint16LE(0);
+		out.write(member.name, strlen(member.name));
+	}
+
+	static void writeCentralHeader(Common::WriteStream &out, const Member &member, uint32 offset) {
+		out.writeUint32LE(0x02014b50);
+		out.writeUint16LE(20);
+		out.writeUint16LE(20);
+		out.writeUint16LE(0);
+		out.writeUint16LE(member.method);
+		out.writeUint32LE(0); // time and date
+		out.writeUint32LE(member.crc);
+		out.writeUint32LE(member.dataSize);
+		out.writeUint32LE(member.size);
+		out.writeUint16LE(strlen(member.name));
+		out.writeUint16LE(0); // extra field
+		out.writeUint16LE(0); // comment
+		out.writeUint16LE(0); // disk
+		out.writeUint16LE(0); // internal attributes
+		out.writeUint32LE(0); // external attributes
+		out.writeUint32LE(offset);
+		out.write(member.name, strlen(member.name));
+	}
+
+	static Common::Archive *makeArchive(const Member *members, uint count) {
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::NO);
+		uint32 offsets[8];
+
+		for (uint i = 0; i < count; ++i) {
+			offsets[i] = out.pos();
+			writeLocalHeader(out, members[i]);
+			out.write(members[i].data, members[i].dataSize);
+		}
+
+		const uint32 centralDir = out.pos();
+		for (uint i = 0; i < count; ++i)
+			writeCentralHeader(out, members[i], offsets[i]);
+
+		out.writeUint32LE(0x06054b50);
+		out.writeUint16LE(0);
+		out.writeUint16LE(0);
+		out.writeUint16LE(count);
+		out.writeUint16LE(count);
+		out.writeUint32LE(out.pos() - centralDir - 12);
+		out.writeUint32LE(centralDir);
+		out.writeUint16LE(0);
+
+		return Common::makeZipArchive(new Common::MemoryReadStream(out.getData(), out.size(), DisposeAfterUse::YES));
+	}
+
+	static byte *makeData(uint32 size) {
+		byte *data = new byte[size];
+		uint32 seed = 1;
+		for (uint32 i = 0; i < size; ++i) {
+			// Compressible, but not too much
+			seed = seed * 1103515245 + 12345;
+			data[i] = (i / 64) + ((seed >> 16) & 7);
+		}
+		return data;
+	}
+
+	// Raw deflate data and CRC from a gzip stream
+	static byte *deflate(const byte *data, uint32 size, uint32 &compressedSize, uint32 &crc) {
+		Common::MemoryWriteStreamDynamic *out = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *gzip = Common::wrapCompressedWriteStream(out);
+		gzip->write(data, size);
+		gzip->finalize();
+
+		byte *gzipData = out->getData();
+		compressedSize = out->size() - 10 - 8;
+		crc = READ_LE_UINT32(gzipData + out->size() - 8);
+		delete gzip; // Also deletes out
+
+		byte *deflated = new byte[compressedSize];
+		memcpy(deflated, gzipData + 10, compressedSize);
+		free(gzipData);
+		return deflated;
+	}
+
+	static void checkRandomAccess(Common::SeekableReadStream *stream, const byte *data, uint32 size) {
+		byte buffer[20000];
+		uint32 seed = 42;
+
+		for (int i = 0; i < 200; ++i) {
+			seed = seed * 1103515245 + 12345;
+			const uint32 pos = (seed >> 8) % size;
+			seed = seed * 1103515245 + 12345;
+			const uint32 count = MIN<uint32>((seed >> 8) % sizeof(buffer), size - pos);
+
+			TS_ASSERT(stream->seek(pos));
+			TS_ASSERT_EQUALS(stream->read(buffer, count), count);
+			TS_ASSERT_EQUALS(memcmp(buffer, data + pos, count), 0);
+			TS_ASSERT_EQUALS(stream->pos(), pos + count);
+		}
+
+		TS_ASSERT(stream->seek(-1, SEEK_END));
+		TS_ASSERT_EQUALS(stream->readByte(), data[size - 1]);
+		TS_ASSERT(!stream->eos());
+		stream->readByte();
+		TS_ASSERT(stream->eos());
+		TS_ASSERT(!stream->err());
+	}
+
+public:
+	void test_stored() {
+		const uint32 size = 100000;
+		byte *data = makeData(size);
+		uint32 compressedSize, crc;
+		delete[] deflate(data, size, compressedSize, crc);
+
+		const Member member = { "stored.dat", 0, crc, size, data, size };
+		Common::Archive *archive = makeArchive(&member, 1);
+		TS_ASSERT(archive);
+		TS_ASSERT(archive->hasFile("STORED.DAT"));
+
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("stored.dat");
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), size);
+		checkRandomAccess(stream, data, size);
+
+		delete stream;
+		delete archive;
+		delete[] data;
+	}
+
+	void test_deflated() {
+#ifdef USE_ZLIB
+		// Large enough to be streamed, with several checkpoints
+		const uint32 size = 1200000;
+		byte *data = makeData(size);
+		uint32 compressedSize, crc;
+		byte *deflated = deflate(data, size, compressedSize, crc);
+
+		const Member member = { "deflated.dat", 8, crc, size, deflated, compressedSize };
+		Common::Archive *archive = makeArchive(&member, 1);
+		TS_ASSERT(archive);
+
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("deflated.dat");
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), size);
+
+		// Sequential reads of all sizes
+		byte *buffer = new byte[size];
+		uint32 pos = 0;
+		for (uint32 count = 1; pos < size; count = count * 3 + 1) {
+			count = MIN(count % 70000, size - pos);
+			TS_ASSERT_EQUALS(stream->read(buffer + pos, count), count);
+			pos += count;
+		}
+		TS_ASSERT_EQUALS(memcmp(buffer, data, size), 0);
+		TS_ASSERT(!stream->err());
+
+		checkRandomAccess(stream, data, size);
+
+		delete[] buffer;
+		delete stream;
+		delete archive;
+		delete[] deflated;
+		delete[] data;
+#endif
+	}
+
+	void test_small_deflated() {
+#ifdef USE_ZLIB
+		const uint32 size = 1000;
+		byte *data = makeData(size);
+		uint32 compressedSize, crc;
+		byte *deflated = deflate(data, size, compressedSize, crc);
+
+		const Member member = { "small.dat", 8, crc, size, deflated, compressedSize };
+		Common::Archive *archive = makeArchive(&member, 1);
+
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("small.dat");
+		TS_ASSERT(stream);
+		checkRandomAccess(stream, data, size);
+
+		delete stream;
+		delete archive;
+		delete[] deflated;
+		delete[] data;
+#endif
+	}
+
+	void test_independent_members() {
+#ifdef USE_ZLIB
+		const uint32 size = 300000;
+		byte *data = makeData(size);
+		uint32 compressedSize, crc;
+		byte *deflated = deflate(data, size, compressedSize, crc);
+
+		const Member members[] = {
+			{ "a.dat", 0, crc, size, data, size },
+			{ "b.dat", 8, crc, size, deflated, compressedSize }
+		};
+		Common::Archive *archive = makeArchive(members, 2);
+
+		Common::SeekableReadStream *a = archive->createReadStreamForMember("a.dat");
+		Common::SeekableReadStream *b = archive->createReadStreamForMember("b.dat");
+		TS_ASSERT(a && b);
+
+		// Member streams stay usable after the archive is gone
+		delete archive;
+
+		byte bufferA[1000], bufferB[1000];
+		for (uint32 pos = 0; pos + sizeof(bufferA) <= size; pos += sizeof(bufferA)) {
+			TS_ASSERT_EQUALS(a->read(bufferA, sizeof(bufferA)), sizeof(bufferA));
+			TS_ASSERT_EQUALS(b->read(bufferB, sizeof(bufferB)), sizeof(bufferB));
+			TS_ASSERT_EQUALS(memcmp(bufferA, data + pos, sizeof(bufferA)), 0);
+			TS_ASSERT_EQUALS(memcmp(bufferB, data + pos, sizeof(bufferB)), 0);
+		}
+
+		delete a;
+		delete b;
+		delete[] deflated;
+		delete[] data;
+#endif
+	}
+
+	void test_corrupt_crc() {
+#ifdef USE_ZLIB
+		const uint32 size = 100000;
+		byte *data = makeData(size);
+		uint32 compressedSize, crc;
+		byte *deflated = deflate(data, size, compressedSize, crc);
+
+		const Member member = { "corrupt.dat", 8, crc ^ 1, size, deflated, compressedSize };
+		Common::Archive *archive = makeArchive(&member, 1);
+
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("corrupt.dat");
+		TS_ASSERT(stream);
+		byte *buffer = new byte[size];
+		stream->read(buffer, size);
+		TS_ASSERT(stream->err());
+
+		delete[] buffer;
+		delete stream;
+		delete archive;
+		delete[] deflated;
+		delete[] data;
+#endif
+	}
+};
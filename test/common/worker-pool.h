@@ -0,0 +1,51 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/worker-pool.h"
+
+#include "../null_osystem.h"
+
+class WorkerPoolTestSuite : public CxxTest::TestSuite {
+private:
+	class CountingJob : public Common::WorkerJob {
+	public:
+		CountingJob() : _runs(0) {}
+		virtual void run() { ++_runs; }
+
+		int _runs;
+	};
+
+public:
+	void test_jobs_run() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::WorkerPool pool(Common::WorkerPool::getDefaultThreadCount(4));
+		CountingJob jobs[16];
+
+		for (int i = 0; i < ARRAYSIZE(jobs); ++i)
+			pool.addJob(&jobs[i]);
+		pool.addJob(&jobs[0]);
+		pool.wait();
+
+		TS_ASSERT_EQUALS(jobs[0]._runs, 2);
+		for (int i = 1; i < ARRAYSIZE(jobs); ++i)
+			TS_ASSERT_EQUALS(jobs[i]._runs, 1);
+#endif
+	}
+
+	void test_no_threads() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Without threads, jobs run right away in the calling thread
+		Common::WorkerPool pool(0);
+		CountingJob job;
+
+		TS_ASSERT_EQUALS(pool.getThreadCount(), 0U);
+		pool.addJob(&job);
+		TS_ASSERT_EQUALS(job._runs, 1);
+		pool.wait();
+		TS_ASSERT_EQUALS(job._runs, 1);
+#endif
+	}
+};
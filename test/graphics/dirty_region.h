@@ -0,0 +1,124 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/dirty_region.h"
+#include "graphics/surface.h"
+
+class DirtyRegionTestSuite : public CxxTest::TestSuite {
+public:
+	void test_merge_adjacent() {
+		Graphics::DirtyRegion region;
+		region.setBounds(Common::Rect(320, 200));
+
+		// A text line drawn a character at a time
+		for (int x = 10; x < 100; x += 8)
+			region.add(Common::Rect(x, 20, x + 8, 36));
+
+		TS_ASSERT_EQUALS(region.getRects().size(), 1U);
+		TS_ASSERT(region.getRects()[0].equals(Common::Rect(10, 20, 106, 36)));
+		TS_ASSERT_EQUALS(region.getArea(), 96U * 16U);
+	}
+
+	void test_keep_distant() {
+		Graphics::DirtyRegion region;
+		region.setBounds(Common::Rect(320, 200));
+
+		region.add(Common::Rect(0, 0, 10, 10));
+		region.add(Common::Rect(300, 180, 310, 190));
+		// Contained in the first one
+		region.add(Common::Rect(2, 2, 5, 5));
+		// Clipped away
+		region.add(Common::Rect(-20, -20, -5, -5));
+
+		TS_ASSERT_EQUALS(region.getRects().size(), 2U);
+		TS_ASSERT_EQUALS(region.getArea(), 200U);
+		TS_ASSERT(!region.isFull());
+
+		region.clear();
+		TS_ASSERT(region.isEmpty());
+	}
+
+	void test_merge_chain() {
+		Graphics::DirtyRegion region;
+		region.setBounds(Common::Rect(320, 200));
+
+		region.add(Common::Rect(0, 0, 10, 10));
+		region.add(Common::Rect(20, 0, 30, 10));
+		// Bridges the gap, after which all three are merged
+		region.add(Common::Rect(10, 0, 20, 10));
+
+		TS_ASSERT_EQUALS(region.getRects().size(), 1U);
+		TS_ASSERT(region.getRects()[0].equals(Common::Rect(0, 0, 30, 10)));
+	}
+
+	void test_overflow() {
+		Graphics::DirtyRegion region(4);
+		region.setBounds(Common::Rect(320, 200));
+
+		for (int i = 0; i < 10; ++i)
+			region.add(Common::Rect(i * 30, i * 18, i * 30 + 4, i * 18 + 4));
+
+		TS_ASSERT_LESS_THAN_EQUALS(region.getRects().size(), 4U);
+
+		// Everything added is still covered
+		for (int i = 0; i < 10; ++i) {
+			bool covered = false;
+			for (uint j = 0; j < region.getRects().size(); ++j)
+				covered = covered || region.getRects()[j].contains(Common::Rect(i * 30, i * 18, i * 30 + 4, i * 18 + 4));
+			TS_ASSERT(covered);
+		}
+	}
+
+	void test_coverage() {
+		Graphics::DirtyRegion region;
+		region.setBounds(Common::Rect(320, 200));
+
+		region.add(Common::Rect(0, 0, 320, 100));
+		TS_ASSERT(!region.isFull());
+		region.add(Common::Rect(0, 120, 320, 180));
+		TS_ASSERT(region.isFull());
+
+		TS_ASSERT_EQUALS(region.getRects().size(), 1U);
+		TS_ASSERT(region.getRects()[0].equals(Common::Rect(320, 200)));
+		TS_ASSERT_EQUALS(region.getArea(), 320U * 200U);
+	}
+
+	void test_tile_checksums() {
+		Graphics::Surface screen;
+		screen.create(100, 40, Graphics::PixelFormat::createFormatCLUT8());
+		screen.fillRect(Common::Rect(100, 40), 7);
+
+		Graphics::TileChecksums checksums;
+		checksums.reset(100, 40);
+
+		// Everything counts as changed at first
+		Common::Array<Common::Rect> changed;
+		checksums.findChanged(screen, Common::Rect(100, 40), changed);
+		TS_ASSERT_EQUALS(changed.size(), 3U);
+		TS_ASSERT(changed[2].equals(Common::Rect(0, 32, 100, 40)));
+
+		// Nothing changed
+		changed.clear();
+		checksums.findChanged(screen, Common::Rect(100, 40), changed);
+		TS_ASSERT(changed.empty());
+
+		// Two separate tiles in the second row of tiles, and the partial last tile
+		screen.setPixel(20, 20, 1);
+		screen.setPixel(60, 30, 1);
+		screen.setPixel(99, 39, 1);
+		changed.clear();
+		checksums.findChanged(screen, Common::Rect(5, 5, 100, 40), changed);
+		TS_ASSERT_EQUALS(changed.size(), 3U);
+		TS_ASSERT(changed[0].equals(Common::Rect(16, 16, 32, 32)));
+		TS_ASSERT(changed[1].equals(Common::Rect(48, 16, 64, 32)));
+		TS_ASSERT(changed[2].equals(Common::Rect(96, 32, 100, 40)));
+
+		// Invalidated tiles are reported again
+		checksums.invalidate(Common::Rect(0, 0, 1, 1));
+		changed.clear();
+		checksums.findChanged(screen, Common::Rect(100, 40), changed);
+		TS_ASSERT_EQUALS(changed.size(), 1U);
+		TS_ASSERT(changed[0].equals(Common::Rect(0, 0, 16, 16)));
+
+		screen.free();
+	}
+};
@@ -0,0 +1,91 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/md5.h"
+#include "common/memstream.h"
+#include "graphics/scaler/hq.h"
+
+#include "../null_osystem.h"
+
+class HQScalerTestSuite : public CxxTest::TestSuite {
+private:
+	enum {
+		kWidth = 123,
+		kHeight = 45,
+		kPadding = 1
+	};
+
+	/**
+	 * Scale a fixed image and return the MD5 of the output. The image mixes
+	 * flat areas, hard edges and nearly equal colors around the thresholds
+	 * of the YUV comparison, so that most of the blending rules get used.
+	 */
+	static Common::String scaleImage(const Graphics::PixelFormat &format, uint factor) {
+		static const byte palette[][3] = {
+			{ 0, 0, 0 }, { 255, 255, 255 }, { 200, 40, 40 }, { 206, 44, 38 },
+			{ 40, 200, 40 }, { 30, 60, 220 }, { 128, 128, 128 }, { 140, 128, 120 }
+		};
+
+		const uint bpp = format.bytesPerPixel;
+		const uint srcPitch = (kWidth + 2 * kPadding) * bpp;
+		const uint dstPitch = kWidth * factor * bpp;
+		const uint dstSize = kHeight * factor * dstPitch;
+		byte *src = new byte[(kHeight + 2 * kPadding) * srcPitch];
+		byte *dst = new byte[dstSize];
+
+		uint32 seed = 1;
+		for (uint y = 0; y < kHeight + 2 * kPadding; ++y) {
+			for (uint x = 0; x < kWidth + 2 * kPadding; ++x) {
+				seed = seed * 1103515245 + 12345;
+				uint index = ((x / 3) ^ (y / 2)) & 7;
+				if (((seed >> 16) & 7) == 0)
+					index = (seed >> 20) & 7;
+
+				const uint32 color = format.RGBToColor(palette[index][0], palette[index][1], palette[index][2]);
+				if (bpp == 2)
+					WRITE_UINT16(src + y * srcPitch + x * bpp, color);
+				else
+					WRITE_UINT32(src + y * srcPitch + x * bpp, color);
+			}
+		}
+
+		HQPlugin scaler;
+		scaler.initialize(format);
+		scaler.setFactor(factor);
+		scaler.scale(src + kPadding * srcPitch + kPadding * bpp, srcPitch, dst, dstPitch, kWidth, kHeight, 0, 0);
+		scaler.deinitialize();
+
+		// Hash the pixels in little endian order, for the same result everywhere
+		for (uint i = 0; i < dstSize; i += bpp) {
+			if (bpp == 2)
+				WRITE_LE_UINT16(dst + i, READ_UINT16(dst + i));
+			else
+				WRITE_LE_UINT32(dst + i, READ_UINT32(dst + i));
+		}
+
+		Common::MemoryReadStream stream(dst, dstSize);
+		Common::String md5 = Common::computeStreamMD5AsString(stream);
+
+		delete[] dst;
+		delete[] src;
+		return md5;
+	}
+
+public:
+	void test_golden() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_HQ_SCALERS) && !defined(USE_NASM)
+		Common::install_null_g_system();
+
+		const Graphics::PixelFormat format565(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		const Graphics::PixelFormat format555(2, 5, 5, 5, 0, 10, 5, 0, 0);
+		const Graphics::PixelFormat format8888(4, 8, 8, 8, 8, 24, 16, 8, 0);
+
+		// Output of the original per-pixel implementation
+		TS_ASSERT_EQUALS(scaleImage(format565, 2), "97b78df9a1b133a20929ff2043df9e81");
+		TS_ASSERT_EQUALS(scaleImage(format565, 3), "89f28e9acc6b7a5d6bcd68de4431b058");
+		TS_ASSERT_EQUALS(scaleImage(format555, 2), "7322c00026e52d38fbad88825637a669");
+		TS_ASSERT_EQUALS(scaleImage(format555, 3), "70d415f6659a9056a940bd14c3e86314");
+		TS_ASSERT_EQUALS(scaleImage(format8888, 2), "940829533c981b236e4a83e4fb92cabf");
+		TS_ASSERT_EQUALS(scaleImage(format8888, 3), "9ffa9ccd7172535acf5754fca6c220b2");
+#endif
+	}
+};
@@ -0,0 +1,125 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/worker-pool.h"
+#include "graphics/scalerplugin.h"
+#include "graphics/scaler/edge.h"
+#include "graphics/scaler/hq.h"
+#include "graphics/scaler/sai.h"
+
+#include "../null_osystem.h"
+
+class ScalerPluginTestSuite : public CxxTest::TestSuite {
+private:
+	enum {
+		kWidth = 320,
+		kHeight = 200,
+		kPadding = 4
+	};
+
+	/** A padded source image, as the backends keep it. */
+	struct Source {
+		Source(const Graphics::PixelFormat &format) : _bpp(format.bytesPerPixel), _pitch((kWidth + 2 * kPadding) * _bpp) {
+			_data = new byte[(kHeight + 2 * kPadding) * _pitch];
+			memset(_data, 0, (kHeight + 2 * kPadding) * _pitch);
+		}
+		~Source() { delete[] _data; }
+
+		byte *pixels() { return _data + kPadding * _pitch + kPadding * _bpp; }
+
+		/** Stripes and blocks, so that every scaler finds some edges. */
+		void draw(const Graphics::PixelFormat &format, uint frame) {
+			for (int y = 0; y < kHeight; ++y) {
+				for (int x = 0; x < kWidth; ++x) {
+					const uint v = ((x + frame) / 7 + y / 5) % 4 == 0 ? 255 : (x * y + frame) & 0x3f;
+					const uint32 color = format.RGBToColor(v, (x + y) & 0xff, ((x / 16 + y / 16) & 1) ? 200 : v);
+					byte *p = pixels() + y * _pitch + x * _bpp;
+					if (_bpp == 2)
+						*(uint16 *)p = color;
+					else
+						*(uint32 *)p = color;
+				}
+			}
+		}
+
+		uint _bpp, _pitch;
+		byte *_data;
+	};
+
+	/**
+	 * Scale two frames of the source, the second one only partially changed,
+	 * and return the destination of the second one.
+	 */
+	static byte *scaleFrames(ScalerPluginObject &scaler, const Graphics::PixelFormat &format, uint factor,
+	                         Common::WorkerPool *pool, uint numBands) {
+		Source src(format);
+		const uint dstPitch = kWidth * factor * format.bytesPerPixel;
+		byte *dst = new byte[kHeight * factor * dstPitch];
+
+		scaler.initialize(format);
+		scaler.setFactor(factor);
+		scaler.setWorkerPool(pool, numBands);
+		if (scaler.useOldSource()) {
+			scaler.setSource(src._data, src._pitch, kWidth, kHeight, kPadding);
+			scaler.enableSource(true);
+		}
+
+		src.draw(format, 0);
+		scaler.scale(src.pixels(), src._pitch, dst, dstPitch, kWidth, kHeight, 0, 0);
+		src.draw(format, 1);
+		scaler.scale(src.pixels(), src._pitch, dst, dstPitch, kWidth, kHeight, 0, 0);
+
+		scaler.setWorkerPool(nullptr);
+		scaler.deinitialize();
+		return dst;
+	}
+
+	static void checkBands(ScalerPluginObject &scaler, uint factor) {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+
+		// Without threads, the pool runs the bands one after the other
+		Common::WorkerPool pool(0);
+
+		for (uint i = 0; i < ARRAYSIZE(formats); ++i) {
+			const uint size = kWidth * kHeight * factor * factor * formats[i].bytesPerPixel;
+			byte *expected = scaleFrames(scaler, formats[i], factor, nullptr, 0);
+			byte *actual = scaleFrames(scaler, formats[i], factor, &pool, 7);
+			TS_ASSERT_EQUALS(memcmp(expected, actual, size), 0);
+			delete[] expected;
+			delete[] actual;
+		}
+	}
+
+public:
+	void test_hq_bands() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_HQ_SCALERS)
+		Common::install_null_g_system();
+
+		HQPlugin scaler;
+		checkBands(scaler, 2);
+		checkBands(scaler, 3);
+#endif
+	}
+
+	void test_edge_bands() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_EDGE_SCALERS)
+		Common::install_null_g_system();
+
+		EdgePlugin *scaler = new EdgePlugin();
+		checkBands(*scaler, 2);
+		checkBands(*scaler, 3);
+		delete scaler;
+#endif
+	}
+
+	void test_sai_bands() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_SCALERS)
+		Common::install_null_g_system();
+
+		SAIPlugin scaler;
+		checkBands(scaler, 2);
+#endif
+	}
+};
@@ -0,0 +1,127 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/tinygl/zgl.h"
+
+#include "../null_osystem.h"
+
+class TinyGLTestSuite : public CxxTest::TestSuite {
+private:
+	enum {
+		kWidth = 320,
+		kHeight = 200
+	};
+
+	static Graphics::PixelFormat getFormat() {
+		return Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+	}
+
+	/** Overlapping, blended and clipped primitives, with a blit in between. */
+	static void drawScene(int frame, Graphics::BlitImage *image) {
+		tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+		tglEnable(TGL_DEPTH_TEST);
+		tglShadeModel(TGL_SMOOTH);
+
+		tglBegin(TGL_TRIANGLES);
+		for (int i = 0; i < 16; ++i) {
+			// Only the last triangle moves, the others stay the same between frames
+			const float x = -1.2f + 0.17f * i + (i == 15 ? 0.1f * frame : 0.0f);
+			const float y = -0.9f + 0.11f * ((i * 7) % 9);
+			tglColor3f((i & 1) ? 1.0f : 0.2f, (i & 2) ? 1.0f : 0.3f, (i & 4) ? 1.0f : 0.4f);
+			tglVertex3f(x, y, 0.5f - 0.06f * i);
+			tglColor3f(0.9f, 0.5f, 0.1f);
+			tglVertex3f(x + 0.7f, y + 0.2f, -0.5f + 0.05f * i);
+			tglColor3f(0.1f, 0.8f, 0.6f);
+			tglVertex3f(x + 0.2f, y + 0.9f, 0.1f);
+		}
+		tglEnd();
+
+		Graphics::tglBlit(image, 40 + frame * 10, 60);
+
+		tglEnable(TGL_BLEND);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+		tglBegin(TGL_QUADS);
+		tglColor4f(1.0f, 1.0f, 0.0f, 0.5f);
+		tglVertex3f(-0.6f, -0.6f, -0.9f);
+		tglVertex3f(0.7f, -0.5f, -0.9f);
+		tglVertex3f(0.6f, 0.6f, -0.9f);
+		tglVertex3f(-0.5f, 0.7f, -0.9f);
+		tglEnd();
+		tglDisable(TGL_BLEND);
+
+		tglBegin(TGL_LINE_STRIP);
+		tglColor3f(1.0f, 0.0f, 1.0f);
+		for (int i = 0; i < 8; ++i)
+			tglVertex3f(-0.9f + 0.25f * i, (i & 1) ? 0.8f : -0.8f, -0.95f);
+		tglEnd();
+
+		tglDisable(TGL_DEPTH_TEST);
+	}
+
+	static void render(bool dirtyRects, bool tiled, byte *pixels, unsigned int *depth) {
+		TinyGL::FrameBuffer *fb = new TinyGL::FrameBuffer(kWidth, kHeight, getFormat());
+		TinyGL::glInit(fb, 256);
+		tglEnableDirtyRects(dirtyRects);
+		tglEnableTiledRendering(tiled, 0);
+
+		Graphics::Surface surface;
+		surface.create(48, 32, getFormat());
+		for (int y = 0; y < surface.h; ++y) {
+			for (int x = 0; x < surface.w; ++x)
+				*(uint32 *)surface.getBasePtr(x, y) = getFormat().ARGBToColor(255, x * 5, y * 7, (x ^ y) * 8);
+		}
+		Graphics::BlitImage *image = Graphics::tglGenBlitImage();
+		Graphics::tglUploadBlitImage(image, surface, 0, false);
+
+		for (int frame = 0; frame < 3; ++frame) {
+			drawScene(frame, image);
+			TinyGL::tglPresentBuffer();
+		}
+
+		memcpy(pixels, fb->getPixelBuffer(), kWidth * kHeight * 4);
+		memcpy(depth, fb->getZBuffer(), kWidth * kHeight * sizeof(unsigned int));
+
+		Graphics::tglDeleteBlitImage(image);
+		TinyGL::glClose();
+		delete fb;
+		surface.free();
+	}
+
+	static void compareTiled(bool dirtyRects) {
+		byte *expectedPixels = new byte[kWidth * kHeight * 4];
+		byte *actualPixels = new byte[kWidth * kHeight * 4];
+		unsigned int *expectedDepth = new unsigned int[kWidth * kHeight];
+		unsigned int *actualDepth = new unsigned int[kWidth * kHeight];
+
+		render(dirtyRects, false, expectedPixels, expectedDepth);
+		render(dirtyRects, true, actualPixels, actualDepth);
+
+		TS_ASSERT_EQUALS(memcmp(expectedPixels, actualPixels, kWidth * kHeight * 4), 0);
+		TS_ASSERT_EQUALS(memcmp(expectedDepth, actualDepth, kWidth * kHeight * sizeof(unsigned int)), 0);
+
+		delete[] expectedPixels;
+		delete[] actualPixels;
+		delete[] expectedDepth;
+		delete[] actualDepth;
+	}
+
+public:
+	void test_tiled_matches_serial() {
+#if defined(USE_TINYGL) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		compareTiled(false);
+#endif
+	}
+
+	void test_tiled_dirty_rects_match_serial() {
+#if defined(USE_TINYGL) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		compareTiled(true);
+#endif
+	}
+};
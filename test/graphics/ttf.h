@@ -0,0 +1,139 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+#include "common/ustr.h"
+#include "graphics/font.h"
+#include "graphics/managed_surface.h"
+#include "graphics/fonts/ttf.h"
+
+#include "../null_osystem.h"
+
+class TTFTestSuite : public CxxTest::TestSuite {
+private:
+	enum {
+		kWidth = 160,
+		kHeight = 40
+	};
+
+#ifdef USE_FREETYPE2
+	static Graphics::Font *loadFont(int size, Graphics::TTFRenderMode renderMode) {
+		Common::SeekableReadStream *stream = Common::FSNode("test/engine-data/FreeSans.ttf").createReadStream();
+		if (!stream)
+			return nullptr;
+
+		Graphics::Font *font = Graphics::loadTTFFont(*stream, size, Graphics::kTTFSizeModeCharacter, 0, renderMode);
+		delete stream;
+		return font;
+	}
+
+	/** Strings which are clipped, shortened, kerned and drawn partly off the surface. */
+	static void drawStrings(const Graphics::Font &font, Graphics::ManagedSurface &surface, uint32 color) {
+		static const char *const strings[] = {
+			"AVAST! Wavy Toffee",
+			"The Secret of Monkey Island (VGA/DOS/English) with a long title",
+			"...",
+			"",
+			"Ti\xc3\xa8 \xe2\x82\xac 123 W.A.V.E.",
+			"Beneath a Steel Sky..."
+		};
+
+		const Graphics::TextAlign aligns[] = { Graphics::kTextAlignLeft, Graphics::kTextAlignCenter, Graphics::kTextAlignRight };
+
+		for (int pass = 0; pass < 2; ++pass) {
+			for (uint i = 0; i < ARRAYSIZE(strings); ++i) {
+				const Common::U32String str(strings[i]);
+				for (uint a = 0; a < ARRAYSIZE(aligns); ++a) {
+					const int x = (int)(i * 7 + a * 13) % 60 - 20;
+					const int y = (int)(i * 11 + a * 5) % 40 - 8;
+					font.drawString(&surface, str, x, y, 40 + i * 20, color, aligns[a], a * 3 - 2, (a + i) & 1);
+					font.drawString(surface.surfacePtr(), str, x + 3, y + 2, 120, color, aligns[a], 0, true);
+				}
+			}
+		}
+	}
+
+	static void compareCached(Graphics::TTFRenderMode renderMode, const Graphics::PixelFormat &format, bool transparent) {
+		Graphics::Font *font = loadFont(14, renderMode);
+		TS_ASSERT(font);
+		if (!font)
+			return;
+
+		Graphics::ManagedSurface expected(kWidth, kHeight, format);
+		Graphics::ManagedSurface actual(kWidth, kHeight, format);
+		const uint32 background = format.bytesPerPixel == 1 ? 3 : format.RGBToColor(40, 80, 120);
+		const uint32 color = format.bytesPerPixel == 1 ? 15 : format.RGBToColor(250, 240, 10);
+		expected.fillRect(Common::Rect(kWidth, kHeight), background);
+		actual.fillRect(Common::Rect(kWidth, kHeight), background);
+		if (transparent) {
+			expected.setTransparentColor(background);
+			actual.setTransparentColor(background);
+		}
+
+		Graphics::setTTFTextRunCacheSize(0);
+		drawStrings(*font, expected, color);
+		Graphics::setTTFTextRunCacheSize(4);
+		drawStrings(*font, actual, color);
+		Graphics::setTTFTextRunCacheSize(256);
+
+		for (int y = 0; y < kHeight; ++y)
+			TS_ASSERT_EQUALS(memcmp(expected.getBasePtr(0, y), actual.getBasePtr(0, y), kWidth * format.bytesPerPixel), 0);
+
+		delete font;
+	}
+#endif
+
+public:
+	void test_cached_strings_match() {
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		compareCached(Graphics::kTTFRenderModeLight, Graphics::PixelFormat::createFormatCLUT8(), false);
+		compareCached(Graphics::kTTFRenderModeLight, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), false);
+		compareCached(Graphics::kTTFRenderModeNormal, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), true);
+		compareCached(Graphics::kTTFRenderModeMonochrome, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), false);
+#endif
+	}
+
+	void test_cache_hits() {
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Graphics::Font *font = loadFont(12, Graphics::kTTFRenderModeLight);
+		TS_ASSERT(font);
+		if (!font)
+			return;
+
+		Graphics::Surface surface;
+		surface.create(kWidth, kHeight, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+
+		Graphics::setTTFTextRunCacheSize(2);
+		Graphics::resetTTFTextRunCacheStats();
+
+		const Common::U32String a("Loom"), b("Zak McKracken"), c("Maniac Mansion");
+		font->drawString(&surface, a, 0, 0, kWidth, 0xFFFF);
+		font->drawString(&surface, b, 0, 0, kWidth, 0xFFFF);
+		font->drawString(&surface, a, 0, 0, kWidth, 0xFFFF);
+		// Another color and position can reuse the layout, another width can't
+		font->drawString(&surface, a, 10, 10, kWidth, 0x1234);
+		font->drawString(&surface, a, 0, 0, kWidth - 1, 0xFFFF);
+
+		uint32 hits, misses;
+		Graphics::getTTFTextRunCacheStats(hits, misses);
+		TS_ASSERT_EQUALS(hits, 2U);
+		TS_ASSERT_EQUALS(misses, 3U);
+
+		// The cache holds two strings, c replaces the least recently drawn one
+		font->drawString(&surface, a, 0, 0, kWidth, 0xFFFF);
+		font->drawString(&surface, c, 0, 0, kWidth, 0xFFFF);
+		font->drawString(&surface, a, 0, 0, kWidth, 0xFFFF);
+		font->drawString(&surface, a, 0, 0, kWidth - 1, 0xFFFF);
+		Graphics::getTTFTextRunCacheStats(hits, misses);
+		TS_ASSERT_EQUALS(hits, 4U);
+		TS_ASSERT_EQUALS(misses, 5U);
+
+		Graphics::setTTFTextRunCacheSize(256);
+		surface.free();
+		delete font;
+#endif
+	}
+};
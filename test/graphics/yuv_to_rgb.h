@@ -0,0 +1,139 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include "../null_osystem.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+private:
+	enum {
+		// Not a multiple of the vector width, to cover the scalar tail
+		kWidth = 92,
+		kHeight = 36,
+		kPitch = 100,
+		kPlaneSize = kPitch * (kHeight + 1)
+	};
+
+	enum Layout {
+		k444,
+		k420,
+		k420Alpha,
+		k410
+	};
+
+	static void fillPlane(byte *plane, uint32 seed) {
+		for (int i = 0; i < kPlaneSize; ++i) {
+			// Mostly smooth, with the extremes of the range every now and then
+			seed = seed * 1103515245 + 12345;
+			const uint32 r = seed >> 16;
+			plane[i] = (r & 0x70) == 0 ? ((r & 0x80) ? 255 : 0) : (byte)(i * 3 + (r & 15));
+		}
+	}
+
+	static void convert(Layout layout, Graphics::Surface &dst, Graphics::YUVToRGBManager::LuminanceScale scale, const byte *y, const byte *u, const byte *v, const byte *a) {
+		switch (layout) {
+		case k444:
+			YUVToRGBMan.convert444(&dst, scale, y, u, v, kWidth, kHeight, kPitch, kPitch);
+			break;
+		case k420:
+			YUVToRGBMan.convert420(&dst, scale, y, u, v, kWidth, kHeight, kPitch, kPitch);
+			break;
+		case k420Alpha:
+			YUVToRGBMan.convert420Alpha(&dst, scale, y, u, v, a, kWidth, kHeight, kPitch, kPitch);
+			break;
+		case k410:
+			YUVToRGBMan.convert410(&dst, scale, y, u, v, kWidth, kHeight, kPitch, kPitch);
+			break;
+		}
+	}
+
+	static void compareVectorized(Layout layout, const Graphics::PixelFormat &format) {
+		byte *planes = new byte[4 * kPlaneSize];
+		for (int i = 0; i < 4; ++i)
+			fillPlane(planes + i * kPlaneSize, i + 1);
+
+		const Graphics::YUVToRGBManager::LuminanceScale scales[] = { Graphics::YUVToRGBManager::kScaleFull, Graphics::YUVToRGBManager::kScaleITU };
+		for (int s = 0; s < 2; ++s) {
+			Graphics::Surface expected, actual;
+			expected.create(kWidth, kHeight, format);
+			actual.create(kWidth, kHeight, format);
+
+			YUVToRGBMan.setVectorized(false);
+			convert(layout, expected, scales[s], planes, planes + kPlaneSize, planes + 2 * kPlaneSize, planes + 3 * kPlaneSize);
+			YUVToRGBMan.setVectorized(true);
+			convert(layout, actual, scales[s], planes, planes + kPlaneSize, planes + 2 * kPlaneSize, planes + 3 * kPlaneSize);
+
+			for (int y = 0; y < kHeight; ++y)
+				TS_ASSERT_EQUALS(memcmp(expected.getBasePtr(0, y), actual.getBasePtr(0, y), kWidth * format.bytesPerPixel), 0);
+
+			expected.free();
+			actual.free();
+		}
+
+		delete[] planes;
+	}
+
+	static void compareFormats(Layout layout) {
+		compareVectorized(layout, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		compareVectorized(layout, Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15));
+		compareVectorized(layout, Graphics::PixelFormat(2, 4, 4, 4, 4, 12, 8, 4, 0));
+		compareVectorized(layout, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		compareVectorized(layout, Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24));
+		compareVectorized(layout, Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0));
+	}
+
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		// The manager guards its lookup tables with a mutex
+		Common::install_null_g_system();
+#endif
+	}
+
+	void test_convert444() {
+		compareFormats(k444);
+	}
+
+	void test_convert420() {
+		compareFormats(k420);
+	}
+
+	void test_convert420_alpha() {
+		compareFormats(k420Alpha);
+	}
+
+	void test_convert410() {
+		compareFormats(k410);
+	}
+
+	void test_all_chroma() {
+		// Every pair of chroma values, with a luminance close to the clamping
+		byte *planes = new byte[3 * 256 * 256];
+		for (int i = 0; i < 256 * 256; ++i) {
+			planes[i] = (i * 5) & 0xff;
+			planes[256 * 256 + i] = i & 0xff;
+			planes[2 * 256 * 256 + i] = i >> 8;
+		}
+
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		const Graphics::YUVToRGBManager::LuminanceScale scales[] = { Graphics::YUVToRGBManager::kScaleFull, Graphics::YUVToRGBManager::kScaleITU };
+		for (int s = 0; s < 2; ++s) {
+			Graphics::Surface expected, actual;
+			expected.create(256, 256, format);
+			actual.create(256, 256, format);
+
+			YUVToRGBMan.setVectorized(false);
+			YUVToRGBMan.convert444(&expected, scales[s], planes, planes + 256 * 256, planes + 2 * 256 * 256, 256, 256, 256, 256);
+			YUVToRGBMan.setVectorized(true);
+			YUVToRGBMan.convert444(&actual, scales[s], planes, planes + 256 * 256, planes + 2 * 256 * 256, 256, 256, 256, 256);
+
+			TS_ASSERT_EQUALS(memcmp(expected.getPixels(), actual.getPixels(), 256 * 256 * 4), 0);
+
+			expected.free();
+			actual.free();
+		}
+
+		delete[] planes;
+	}
+};
@@ -5,7 +5,8 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/video/*.h
+BENCHMARKS   := $(srcdir)/test/benchmark/*.h
 TEST_LIBS    :=
 
 ifdef POSIX
@@ -13,9 +14,13 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/posix/posix-fs-factory.o \
 	backends/fs/posix/posix-fs.o \
 	backends/fs/posix/posix-iostream.o \
+	backends/fs/posix/posix-mmapstream.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
-	backends/modular-backend.o
+	backends/modular-backend.o \
+	backends/mutex/pthread/pthread-mutex.o
+
+TESTS += $(srcdir)/test/backends/*.h
 endif
 
 ifdef WIN32
@@ -27,7 +32,7 @@ TEST_LIBS += test/null_osystem.o \
 	backends/modular-backend.o
 endif
 
-TEST_LIBS +=	audio/libaudio.a math/libmath.a common/libcommon.a image/libimage.a graphics/libgraphics.a
+TEST_LIBS +=	video/libvideo.a audio/libaudio.a math/libmath.a image/libimage.a graphics/libgraphics.a common/libcommon.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
@@ -45,6 +50,10 @@ TEST_CFLAGS  := $(CFLAGS) -I$(srcdir)/test/cxxtest
 TEST_LDFLAGS := $(LDFLAGS) $(LIBS)
 TEST_CXXFLAGS := $(filter-out -Wglobal-constructors,$(CXXFLAGS))
 
+ifdef POSIX
+TEST_LDFLAGS += -lpthread
+endif
+
 ifdef WIN32
 TEST_LDFLAGS := $(filter-out -mwindows,$(TEST_LDFLAGS))
 endif
@@ -72,15 +81,28 @@ test/runner.cpp: $(TESTS) $(srcdir)/test/module.mk
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
+benchmark: test/benchmark-runner
+	./test/benchmark-runner
+test/benchmark-runner: test/benchmark-runner.cpp $(TEST_LIBS) copy-dat
+	+$(QUIET_CXX)$(LD) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ test/benchmark-runner.cpp $(TEST_LIBS) $(TEST_LDFLAGS)
+test/benchmark-runner.cpp: $(BENCHMARKS) $(srcdir)/test/module.mk
+	@mkdir -p test
+	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
+
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat
+	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/engine-data/FreeSans.ttf
+	-$(RM) test/benchmark-runner.cpp test/benchmark-runner
 	-rmdir test/engine-data
 
 test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
 	$(MKDIR) test/engine-data
 	$(CP) $(srcdir)/dists/engine-data/encoding.dat test/engine-data/encoding.dat
 
-copy-dat: test/engine-data/encoding.dat
+test/engine-data/FreeSans.ttf: $(srcdir)/gui/themes/fonts/FreeSans.ttf
+	$(MKDIR) test/engine-data
+	$(CP) $(srcdir)/gui/themes/fonts/FreeSans.ttf test/engine-data/FreeSans.ttf
+
+copy-dat: test/engine-data/encoding.dat test/engine-data/FreeSans.ttf
 
-.PHONY: test clean-test copy-dat
+.PHONY: test benchmark clean-test copy-dat
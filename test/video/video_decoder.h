@@ -0,0 +1,186 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/atomic.h"
+#include "common/worker-pool.h"
+#include "graphics/surface.h"
+#include "video/video_decoder.h"
+
+#include "../null_osystem.h"
+
+class VideoDecoderTestSuite : public CxxTest::TestSuite {
+private:
+	enum {
+		kWidth = 16,
+		kHeight = 8,
+		kFrameCount = 40
+	};
+
+	/** A video whose frames and palette are made up from the frame number. */
+	class TestVideoDecoder : public Video::VideoDecoder {
+	public:
+		TestVideoDecoder() : _framesDecoded(0) {}
+
+		virtual bool loadStream(Common::SeekableReadStream *stream) {
+			close();
+			addTrack(new TestVideoTrack(_framesDecoded));
+			return true;
+		}
+
+		/** The number of frames the track decoded, on whichever thread. */
+		uint32 getFramesDecoded() const { return Common::atomicLoadAcquire(_framesDecoded); }
+
+	private:
+		class TestVideoTrack : public FixedRateVideoTrack {
+		public:
+			TestVideoTrack(uint32 &framesDecoded) : _framesDecoded(framesDecoded), _curFrame(-1), _dirtyPalette(false) {
+				_surface.create(kWidth, kHeight, Graphics::PixelFormat::createFormatCLUT8());
+				memset(_palette, 0, sizeof(_palette));
+			}
+
+			virtual ~TestVideoTrack() { _surface.free(); }
+
+			virtual bool isSeekable() const { return true; }
+			virtual bool seek(const Audio::Timestamp &time) {
+				_curFrame = getFrameAtTime(time) - 1;
+				return true;
+			}
+
+			virtual uint16 getWidth() const { return kWidth; }
+			virtual uint16 getHeight() const { return kHeight; }
+			virtual Graphics::PixelFormat getPixelFormat() const { return _surface.format; }
+			virtual int getCurFrame() const { return _curFrame; }
+			virtual int getFrameCount() const { return kFrameCount; }
+
+			virtual const Graphics::Surface *decodeNextFrame() {
+				Common::atomicFetchAdd(_framesDecoded, 1U);
+				++_curFrame;
+				for (int y = 0; y < kHeight; ++y)
+					for (int x = 0; x < kWidth; ++x)
+						*(byte *)_surface.getBasePtr(x, y) = _curFrame * 7 + x + y;
+
+				// A new palette every 8 frames
+				_dirtyPalette = (_curFrame % 8) == 0;
+				if (_dirtyPalette)
+					memset(_palette, _curFrame, sizeof(_palette));
+
+				return &_surface;
+			}
+
+			virtual const byte *getPalette() const { _dirtyPalette = false; return _palette; }
+			virtual bool hasDirtyPalette() const { return _dirtyPalette; }
+
+		protected:
+			virtual Common::Rational getFrameRate() const { return 30; }
+
+		private:
+			uint32 &_framesDecoded;
+			Graphics::Surface _surface;
+			int _curFrame;
+			byte _palette[256 * 3];
+			mutable bool _dirtyPalette;
+		};
+
+		uint32 _framesDecoded;
+	};
+
+	/** Check that the frame is the given one of the test video. */
+	static void checkFrame(Video::VideoDecoder &decoder, const Graphics::Surface *surface, int frame) {
+		TS_ASSERT(surface);
+		if (!surface)
+			return;
+
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), frame);
+		TS_ASSERT_EQUALS(*(const byte *)surface->getBasePtr(0, 0), (byte)(frame * 7));
+		TS_ASSERT_EQUALS(*(const byte *)surface->getBasePtr(kWidth - 1, kHeight - 1), (byte)(frame * 7 + kWidth + kHeight - 2));
+
+		TS_ASSERT_EQUALS(decoder.hasDirtyPalette(), frame % 8 == 0);
+		if (decoder.hasDirtyPalette())
+			TS_ASSERT_EQUALS(decoder.getPalette()[255 * 3], (byte)frame);
+	}
+
+public:
+	void test_decode_ahead() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		for (uint ahead = 0; ahead < 6; ahead += 5) {
+			TestVideoDecoder decoder;
+			decoder.setDecodeAhead(ahead);
+			decoder.loadStream(0);
+			decoder.start();
+
+			for (int frame = 0; frame < kFrameCount; ++frame) {
+				TS_ASSERT(!decoder.endOfVideo());
+				checkFrame(decoder, decoder.decodeNextFrame(), frame);
+			}
+
+			TS_ASSERT(decoder.endOfVideo());
+			TS_ASSERT(!decoder.decodeNextFrame());
+			TS_ASSERT_EQUALS(decoder.getCurFrame(), kFrameCount - 1);
+			TS_ASSERT_EQUALS(decoder.getDroppedFrameCount(), 0U);
+			decoder.close();
+		}
+#endif
+	}
+
+	void test_seek_and_rewind() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		TestVideoDecoder decoder;
+		decoder.setDecodeAhead(4);
+		decoder.loadStream(0);
+		decoder.start();
+
+		for (int frame = 0; frame < 10; ++frame)
+			checkFrame(decoder, decoder.decodeNextFrame(), frame);
+
+		// The frames decoded ahead are dropped, not shown
+		TS_ASSERT(decoder.seekToFrame(24));
+		TS_ASSERT_LESS_THAN_EQUALS(decoder.getDroppedFrameCount(), 4U);
+		for (int frame = 24; frame < 30; ++frame)
+			checkFrame(decoder, decoder.decodeNextFrame(), frame);
+
+		TS_ASSERT(decoder.rewind());
+		for (int frame = 0; frame < 3; ++frame)
+			checkFrame(decoder, decoder.decodeNextFrame(), frame);
+
+		// Pausing leaves the queue alone
+		decoder.pauseVideo(true);
+		decoder.pauseVideo(false);
+		checkFrame(decoder, decoder.decodeNextFrame(), 3);
+
+		// Turning it off shows the frames decoded so far first
+		decoder.setDecodeAhead(0);
+		for (int frame = 4; frame < 12; ++frame)
+			checkFrame(decoder, decoder.decodeNextFrame(), frame);
+
+		decoder.close();
+#endif
+	}
+
+	void test_decode_ahead_worker() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		TestVideoDecoder decoder;
+		decoder.setDecodeAhead(4);
+		decoder.loadStream(0);
+		decoder.start();
+		checkFrame(decoder, decoder.decodeNextFrame(), 0);
+
+		// Without threads the frames are decoded when asked for
+		const uint32 expected = Common::WorkerPool(1).getThreadCount() ? 5 : 1;
+
+		// The worker fills the queue while nothing else asks for frames
+		for (int i = 0; i < 5000 && decoder.getFramesDecoded() < expected; ++i)
+			g_system->delayMillis(1);
+		TS_ASSERT_EQUALS(decoder.getFramesDecoded(), expected);
+
+		for (int frame = 1; frame < 10; ++frame)
+			checkFrame(decoder, decoder.decodeNextFrame(), frame);
+
+		// Destroying the decoder while the job runs stops it first
+#endif
+	}
+};
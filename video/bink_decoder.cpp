@@ -39,6 +39,7 @@
 #include "common/rdft.h"
 #include "common/dct.h"
 #include "common/system.h"
+#include "common/worker-pool.h"
 
 #include "graphics/yuv_to_rgb.h"
 #include "graphics/surface.h"
@@ -46,6 +47,19 @@
 #include "video/binkdata.h"
 #include "video/bink_decoder.h"
 
+// The NEON IDCT has not been run on ARM hardware yet, so it is only used when
+// building with ENABLE_NEON_BINK defined.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2_BINK
+#include <emmintrin.h>
+#ifdef __SSE4_1__
+#include <smmintrin.h>
+#endif
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(ENABLE_NEON_BINK)
+#define USE_NEON_BINK
+#include <arm_neon.h>
+#endif
+
 static const uint32 kBIKfID = MKTAG('B', 'I', 'K', 'f');
 static const uint32 kBIKgID = MKTAG('B', 'I', 'K', 'g');
 static const uint32 kBIKhID = MKTAG('B', 'I', 'K', 'h');
@@ -242,6 +256,18 @@ BinkDecoder::AudioInfo::~AudioInfo() {
 	delete dct;
 }
 
+/** Converts a band of rows of a frame. */
+class BinkDecoder::BinkVideoTrack::ConvertJob : public Common::WorkerJob {
+public:
+	ConvertJob(BinkVideoTrack *track, int top, int bottom) : _track(track), _top(top), _bottom(bottom) {}
+
+	void run() override { _track->convertRows(_top, _bottom); }
+
+private:
+	BinkVideoTrack *_track;
+	int _top, _bottom;
+};
+
 BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const Graphics::PixelFormat &format, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id) :
 		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id) {
 	_curFrame = -1;
@@ -314,6 +340,7 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 
 	initBundles();
 	initHuffman();
+	initConvertJobs();
 }
 
 BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
@@ -329,9 +356,80 @@ BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
 		_huffman[i] = 0;
 	}
 
+	delete _convertPool;
+	for (uint i = 0; i < _convertJobs.size(); i++)
+		delete _convertJobs[i];
+
 	_surface.free();
 }
 
+void BinkDecoder::BinkVideoTrack::initConvertJobs() {
+	_convertPool = 0;
+
+	// Small videos are not worth the synchronization
+	if (_surfaceHeight < 128)
+		return;
+
+	const uint threads = Common::WorkerPool::getDefaultThreadCount(3);
+	if (threads == 0)
+		return;
+
+	_convertPool = new Common::WorkerPool(threads);
+	if (_convertPool->getThreadCount() == 0) {
+		delete _convertPool;
+		_convertPool = 0;
+		return;
+	}
+
+	// A few more bands than threads, to even out the load. The bands start
+	// on even rows, so that each one begins with a new row of chroma.
+	const int bandCount = 4 * (_convertPool->getThreadCount() + 1);
+	const int bandHeight = MAX<int>(16, ((_surfaceHeight + bandCount - 1) / bandCount + 1) & ~1);
+
+	for (int top = 0; top < _surfaceHeight; top += bandHeight)
+		_convertJobs.push_back(new ConvertJob(this, top, MIN<int>(top + bandHeight, _surfaceHeight)));
+}
+
+void BinkDecoder::BinkVideoTrack::convertFrame() {
+	if (!_convertPool) {
+		convertRows(0, _surfaceHeight);
+		return;
+	}
+
+	// The bands share the conversion lookup tables, which YUVToRGBMan
+	// hands out safely to several threads at once
+	for (uint i = 0; i < _convertJobs.size(); i++)
+		_convertPool->addJob(_convertJobs[i]);
+
+	_convertPool->wait();
+}
+
+void BinkDecoder::BinkVideoTrack::convertRows(int top, int bottom) {
+	// Convert the YUV data we have to our format
+	// The width used here is the surface-width, and not the video-width
+	// to allow for odd-sized videos.
+	const uint32 yPitch = _yBlockWidth * 8;
+	const uint32 uvPitch = _uvBlockWidth * 8;
+
+	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && (!_hasAlpha || _curPlanes[3]));
+
+	Graphics::Surface band;
+	band.init(_surfaceWidth, bottom - top, _surface.pitch, _surface.getBasePtr(0, top), _surface.format);
+
+	const byte *y = _curPlanes[0] + top * yPitch;
+	const byte *u = _curPlanes[1] + (top / 2) * uvPitch;
+	const byte *v = _curPlanes[2] + (top / 2) * uvPitch;
+
+	if (_hasAlpha) {
+		const byte *a = _curPlanes[3] + top * yPitch;
+		YUVToRGBMan.convert420Alpha(&band, Graphics::YUVToRGBManager::kScaleITU, y, u, v, a,
+				_surfaceWidth, bottom - top, yPitch, uvPitch);
+	} else {
+		YUVToRGBMan.convert420(&band, Graphics::YUVToRGBManager::kScaleITU, y, u, v,
+				_surfaceWidth, bottom - top, yPitch, uvPitch);
+	}
+}
+
 /**
  * An AudioStream that just returns silent samples and runs infinitely.
  */
@@ -492,18 +590,7 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 			break;
 	}
 
-	// Convert the YUV data we have to our format
-	// The width used here is the surface-width, and not the video-width
-	// to allow for odd-sized videos.
-	if (_hasAlpha) {
-		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
-		YUVToRGBMan.convert420Alpha(&_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
-				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
-	} else {
-		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2]);
-		YUVToRGBMan.convert420(&_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
-				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
-	}
+	convertFrame();
 
 	// And swap the planes with the reference planes
 	for (int i = 0; i < 4; i++)
@@ -959,11 +1046,7 @@ void BinkDecoder::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
 
 	readResidue(*ctx.video, block, v);
 
-	byte  *dst = ctx.dest;
-	int16 *src = block;
-	for (int i = 0; i < 8; i++, dst += ctx.pitch, src += 8)
-		for (int j = 0; j < 8; j++)
-			dst[j] += src[j];
+	residueAdd(ctx, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
@@ -1474,7 +1557,211 @@ static inline void IDCTCol(int32 *dest, const int32 *src) {
 	}
 }
 
+#if defined(USE_SSE2_BINK) || defined(USE_NEON_BINK)
+
+namespace {
+
+// Four lanes of the 32-bit IDCT arithmetic. Storing a result into a byte
+// truncates it, as the scalar code does.
+
+#if defined(USE_SSE2_BINK)
+
+typedef __m128i IDCTVector;
+
+FORCEINLINE IDCTVector idctLoad(const int32 *src) { return _mm_loadu_si128((const __m128i *)src); }
+FORCEINLINE void idctStore(int32 *dst, IDCTVector v) { _mm_storeu_si128((__m128i *)dst, v); }
+FORCEINLINE IDCTVector idctAdd(IDCTVector a, IDCTVector b) { return _mm_add_epi32(a, b); }
+FORCEINLINE IDCTVector idctSub(IDCTVector a, IDCTVector b) { return _mm_sub_epi32(a, b); }
+
+/**
+ * (c * v) >> 11. Without SSE4.1, the 32-bit multiplication is made from
+ * two 64-bit ones, whose low halves are the same for signed values.
+ */
+template<int c>
+FORCEINLINE IDCTVector idctMulShift(IDCTVector v) {
+#ifdef __SSE4_1__
+	const __m128i product = _mm_mullo_epi32(v, _mm_set1_epi32(c));
+#else
+	const __m128i factor = _mm_set1_epi32(c);
+	const __m128i even = _mm_mul_epu32(v, factor);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(v, 32), factor);
+	const __m128i product = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+	return _mm_srai_epi32(product, 11);
+}
+
+FORCEINLINE IDCTVector idctRound(IDCTVector v) {
+	return _mm_srai_epi32(_mm_add_epi32(v, _mm_set1_epi32(0x7F)), 8);
+}
+
+FORCEINLINE void idctTranspose(IDCTVector &r0, IDCTVector &r1, IDCTVector &r2, IDCTVector &r3) {
+	const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+	const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+	const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+	const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+	r0 = _mm_unpacklo_epi64(t0, t1);
+	r1 = _mm_unpackhi_epi64(t0, t1);
+	r2 = _mm_unpacklo_epi64(t2, t3);
+	r3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+/** The low bytes of eight values. */
+FORCEINLINE __m128i idctBytes(IDCTVector lo, IDCTVector hi) {
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i words = _mm_packs_epi32(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+	return _mm_packus_epi16(words, words);
+}
+
+FORCEINLINE void idctPutRow(byte *dst, IDCTVector lo, IDCTVector hi) {
+	_mm_storel_epi64((__m128i *)dst, idctBytes(lo, hi));
+}
+
+FORCEINLINE void idctAddRow(byte *dst, IDCTVector lo, IDCTVector hi) {
+	const __m128i old = _mm_loadl_epi64((const __m128i *)dst);
+	_mm_storel_epi64((__m128i *)dst, _mm_add_epi8(old, idctBytes(lo, hi)));
+}
+
+FORCEINLINE void residueAddRow(byte *dst, const int16 *src) {
+	const __m128i words = _mm_and_si128(_mm_loadu_si128((const __m128i *)src), _mm_set1_epi16(0xFF));
+	const __m128i old = _mm_loadl_epi64((const __m128i *)dst);
+	_mm_storel_epi64((__m128i *)dst, _mm_add_epi8(old, _mm_packus_epi16(words, words)));
+}
+
+#elif defined(USE_NEON_BINK)
+
+typedef int32x4_t IDCTVector;
+
+FORCEINLINE IDCTVector idctLoad(const int32 *src) { return vld1q_s32(src); }
+FORCEINLINE void idctStore(int32 *dst, IDCTVector v) { vst1q_s32(dst, v); }
+FORCEINLINE IDCTVector idctAdd(IDCTVector a, IDCTVector b) { return vaddq_s32(a, b); }
+FORCEINLINE IDCTVector idctSub(IDCTVector a, IDCTVector b) { return vsubq_s32(a, b); }
+
+template<int c>
+FORCEINLINE IDCTVector idctMulShift(IDCTVector v) {
+	return vshrq_n_s32(vmulq_n_s32(v, c), 11);
+}
+
+FORCEINLINE IDCTVector idctRound(IDCTVector v) {
+	return vshrq_n_s32(vaddq_s32(v, vdupq_n_s32(0x7F)), 8);
+}
+
+FORCEINLINE void idctTranspose(IDCTVector &r0, IDCTVector &r1, IDCTVector &r2, IDCTVector &r3) {
+	const int32x4x2_t t01 = vtrnq_s32(r0, r1);
+	const int32x4x2_t t23 = vtrnq_s32(r2, r3);
+	r0 = vcombine_s32(vget_low_s32(t01.val[0]), vget_low_s32(t23.val[0]));
+	r1 = vcombine_s32(vget_low_s32(t01.val[1]), vget_low_s32(t23.val[1]));
+	r2 = vcombine_s32(vget_high_s32(t01.val[0]), vget_high_s32(t23.val[0]));
+	r3 = vcombine_s32(vget_high_s32(t01.val[1]), vget_high_s32(t23.val[1]));
+}
+
+/** The low bytes of eight values. */
+FORCEINLINE uint8x8_t idctBytes(IDCTVector lo, IDCTVector hi) {
+	return vmovn_u16(vreinterpretq_u16_s16(vcombine_s16(vmovn_s32(lo), vmovn_s32(hi))));
+}
+
+FORCEINLINE void idctPutRow(byte *dst, IDCTVector lo, IDCTVector hi) {
+	vst1_u8(dst, idctBytes(lo, hi));
+}
+
+FORCEINLINE void idctAddRow(byte *dst, IDCTVector lo, IDCTVector hi) {
+	vst1_u8(dst, vadd_u8(vld1_u8(dst), idctBytes(lo, hi)));
+}
+
+FORCEINLINE void residueAddRow(byte *dst, const int16 *src) {
+	vst1_u8(dst, vadd_u8(vld1_u8(dst), vmovn_u16(vreinterpretq_u16_s16(vld1q_s16(src)))));
+}
+
+#endif
+
+/** IDCT_TRANSFORM on four columns at once, in place. */
+FORCEINLINE void idctTransform(IDCTVector &s0, IDCTVector &s1, IDCTVector &s2, IDCTVector &s3, IDCTVector &s4, IDCTVector &s5, IDCTVector &s6, IDCTVector &s7) {
+	const IDCTVector a0 = idctAdd(s0, s4);
+	const IDCTVector a1 = idctSub(s0, s4);
+	const IDCTVector a2 = idctAdd(s2, s6);
+	const IDCTVector a3 = idctMulShift<A1>(idctSub(s2, s6));
+	const IDCTVector a4 = idctAdd(s5, s3);
+	const IDCTVector a5 = idctSub(s5, s3);
+	const IDCTVector a6 = idctAdd(s1, s7);
+	const IDCTVector a7 = idctSub(s1, s7);
+	const IDCTVector b0 = idctAdd(a4, a6);
+	const IDCTVector b1 = idctMulShift<A3>(idctAdd(a5, a7));
+	const IDCTVector b2 = idctAdd(idctSub(idctMulShift<A4>(a5), b0), b1);
+	const IDCTVector b3 = idctSub(idctMulShift<A1>(idctSub(a6, a4)), b2);
+	const IDCTVector b4 = idctSub(idctAdd(idctMulShift<A2>(a7), b3), b1);
+
+	const IDCTVector c0 = idctAdd(a0, a2);
+	const IDCTVector c1 = idctSub(idctAdd(a1, a3), a2);
+	const IDCTVector c2 = idctAdd(idctSub(a1, a3), a2);
+	const IDCTVector c3 = idctSub(a0, a2);
+
+	s0 = idctAdd(c0, b0);
+	s1 = idctAdd(c1, b2);
+	s2 = idctAdd(c2, b3);
+	s3 = idctSub(c3, b4);
+	s4 = idctAdd(c3, b4);
+	s5 = idctSub(c2, b3);
+	s6 = idctSub(c1, b2);
+	s7 = idctSub(c0, b0);
+}
+
+/**
+ * The row pass on four rows, given as the left and right halves of their
+ * column pass results. The rows are transformed as the columns of the
+ * transposed halves, then transposed back.
+ */
+FORCEINLINE void idctRows(IDCTVector &l0, IDCTVector &l1, IDCTVector &l2, IDCTVector &l3, IDCTVector &r0, IDCTVector &r1, IDCTVector &r2, IDCTVector &r3) {
+	idctTranspose(l0, l1, l2, l3);
+	idctTranspose(r0, r1, r2, r3);
+	idctTransform(l0, l1, l2, l3, r0, r1, r2, r3);
+
+	l0 = idctRound(l0); l1 = idctRound(l1); l2 = idctRound(l2); l3 = idctRound(l3);
+	r0 = idctRound(r0); r1 = idctRound(r1); r2 = idctRound(r2); r3 = idctRound(r3);
+
+	idctTranspose(l0, l1, l2, l3);
+	idctTranspose(r0, r1, r2, r3);
+}
+
+/**
+ * Both passes of the IDCT, with row i of the result in out[2 * i] and
+ * out[2 * i + 1]. The column pass does not need the scalar shortcut for
+ * columns without AC coefficients, which gives the same result.
+ */
+FORCEINLINE void idctVector(const int32 *block, IDCTVector *out) {
+	IDCTVector l0 = idctLoad(block +  0), r0 = idctLoad(block +  4);
+	IDCTVector l1 = idctLoad(block +  8), r1 = idctLoad(block + 12);
+	IDCTVector l2 = idctLoad(block + 16), r2 = idctLoad(block + 20);
+	IDCTVector l3 = idctLoad(block + 24), r3 = idctLoad(block + 28);
+	IDCTVector l4 = idctLoad(block + 32), r4 = idctLoad(block + 36);
+	IDCTVector l5 = idctLoad(block + 40), r5 = idctLoad(block + 44);
+	IDCTVector l6 = idctLoad(block + 48), r6 = idctLoad(block + 52);
+	IDCTVector l7 = idctLoad(block + 56), r7 = idctLoad(block + 60);
+
+	idctTransform(l0, l1, l2, l3, l4, l5, l6, l7);
+	idctTransform(r0, r1, r2, r3, r4, r5, r6, r7);
+
+	idctRows(l0, l1, l2, l3, r0, r1, r2, r3);
+	out[0] = l0; out[1] = r0; out[2] = l1; out[3] = r1;
+	out[4] = l2; out[5] = r2; out[6] = l3; out[7] = r3;
+
+	idctRows(l4, l5, l6, l7, r4, r5, r6, r7);
+	out[ 8] = l4; out[ 9] = r4; out[10] = l5; out[11] = r5;
+	out[12] = l6; out[13] = r6; out[14] = l7; out[15] = r7;
+}
+
+} // End of anonymous namespace
+
+#define USE_VECTOR_BINK
+
+#endif
+
 void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
+#ifdef USE_VECTOR_BINK
+	IDCTVector out[16];
+	idctVector(block, out);
+
+	for (int i = 0; i < 16; i++)
+		idctStore(block + 4 * i, out[i]);
+#else
 	int i;
 	int32 temp[64];
 
@@ -1483,9 +1770,18 @@ void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
 	for (i = 0; i < 8; i++) {
 		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
 	}
+#endif
 }
 
 void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
+#ifdef USE_VECTOR_BINK
+	IDCTVector out[16];
+	idctVector(block, out);
+
+	byte *dest = ctx.dest;
+	for (int i = 0; i < 8; i++, dest += ctx.pitch)
+		idctAddRow(dest, out[2 * i], out[2 * i + 1]);
+#else
 	int i, j;
 
 	IDCT(block);
@@ -1493,9 +1789,18 @@ void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
 	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
 		for (j = 0; j < 8; j++)
 			 dest[j] += block[j];
+#endif
 }
 
 void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
+#ifdef USE_VECTOR_BINK
+	IDCTVector out[16];
+	idctVector(block, out);
+
+	byte *dest = ctx.dest;
+	for (int i = 0; i < 8; i++, dest += ctx.pitch)
+		idctPutRow(dest, out[2 * i], out[2 * i + 1]);
+#else
 	int i;
 	int32 temp[64];
 	for (i = 0; i < 8; i++)
@@ -1503,6 +1808,20 @@ void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
 	for (i = 0; i < 8; i++) {
 		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
 	}
+#endif
+}
+
+void BinkDecoder::BinkVideoTrack::residueAdd(DecodeContext &ctx, const int16 *block) {
+	byte *dst = ctx.dest;
+
+#ifdef USE_VECTOR_BINK
+	for (int i = 0; i < 8; i++, dst += ctx.pitch, block += 8)
+		residueAddRow(dst, block);
+#else
+	for (int i = 0; i < 8; i++, dst += ctx.pitch, block += 8)
+		for (int j = 0; j < 8; j++)
+			dst[j] += block[j];
+#endif
 }
 
 BinkDecoder::BinkAudioTrack::BinkAudioTrack(BinkDecoder::AudioInfo &audio, Audio::Mixer::SoundType soundType) :
@@ -51,6 +51,7 @@ class Huffman;
 
 class RDFT;
 class DCT;
+class WorkerPool;
 }
 
 namespace Graphics {
@@ -270,6 +271,11 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		class ConvertJob;
+
+		Common::WorkerPool *_convertPool;         ///< Threads converting the frames in bands, if any.
+		Common::Array<ConvertJob *> _convertJobs; ///< The bands of the frame, one job each.
+
 		/** Initialize the bundles. */
 		void initBundles();
 		/** Deinitialize the bundles. */
@@ -278,6 +284,13 @@ private:
 		/** Initialize the Huffman decoders. */
 		void initHuffman();
 
+		/** Split the frame conversion into bands, if there are threads to spare. */
+		void initConvertJobs();
+		/** Convert the current planes to our format. */
+		void convertFrame();
+		/** Convert the rows [top, bottom) of the current planes to our format. */
+		void convertRows(int top, int bottom);
+
 		/** Decode a plane. */
 		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
 
@@ -329,6 +342,9 @@ private:
 		void IDCT(int32 *block);
 		void IDCTPut(DecodeContext &ctx, int32 *block);
 		void IDCTAdd(DecodeContext &ctx, int32 *block);
+
+		/** Add a residue block to the motion compensated one. */
+		void residueAdd(DecodeContext &ctx, const int16 *block);
 	};
 
 	class BinkAudioTrack : public AudioTrack {
@@ -27,12 +27,39 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/rect.h"
 #include "common/system.h"
+#include "common/worker-pool.h"
 
 #include "graphics/palette.h"
+#include "graphics/surface.h"
 
 namespace Video {
 
+/** A frame decoded ahead, along with the state of its track after decoding it. */
+struct VideoDecoder::DecodedFrame {
+	Graphics::Surface surface;
+	bool hasSurface;
+	bool dirtyPalette;
+	byte palette[256 * 3];
+	int curFrame;
+	uint32 nextFrameStartTime;
+	bool endOfTrack;
+
+	DecodedFrame() : hasSurface(false), dirtyPalette(false), curFrame(-1), nextFrameStartTime(0), endOfTrack(false) {}
+	~DecodedFrame() { surface.free(); }
+};
+
+class VideoDecoder::DecodeAheadJob : public Common::WorkerJob {
+public:
+	DecodeAheadJob(VideoDecoder *decoder) : _decoder(decoder) {}
+
+	virtual void run() { _decoder->decodeAhead(); }
+
+private:
+	VideoDecoder *_decoder;
+};
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -49,6 +76,21 @@ VideoDecoder::VideoDecoder() {
 	_nextVideoTrack = 0;
 	_mainAudioTrack = 0;
 	_canSetDither = true;
+	_decodeAheadFrames = 0;
+	_decodeAheadPool = 0;
+	_decodeAheadJob = 0;
+	_frameDecoded = 0;
+	_decodingAhead = false;
+	_decodedFrames = 0;
+	_decodedFrameCount = 0;
+	_decodedRead = 0;
+	_decodedWrite = 0;
+	_decodeAheadQueued = false;
+	_decodeAheadCancel = false;
+	_waitingForFrame = false;
+	_decodeAheadPalette = 0;
+	_lateFrames = 0;
+	_droppedFrames = 0;
 
 	// Find the best format for output
 	_defaultHighColorFormat = g_system->getScreenFormat();
@@ -57,7 +99,20 @@ VideoDecoder::VideoDecoder() {
 		_defaultHighColorFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0);
 }
 
+VideoDecoder::~VideoDecoder() {
+	// Subclasses usually close the video in their destructors already, but
+	// the job must not outlive the frames it decodes into
+	stopDecodeAhead();
+	freeDecodedFrames();
+	delete _decodeAheadPool;
+	delete _decodeAheadJob;
+	delete _frameDecoded;
+}
+
 void VideoDecoder::close() {
+	stopDecodeAhead();
+	freeDecodedFrames();
+
 	if (isPlaying())
 		stop();
 
@@ -80,6 +135,8 @@ void VideoDecoder::close() {
 	_nextVideoTrack = 0;
 	_mainAudioTrack = 0;
 	_canSetDither = true;
+	_lateFrames = 0;
+	_droppedFrames = 0;
 }
 
 bool VideoDecoder::loadFile(const Common::String &filename) {
@@ -188,6 +245,15 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_needsUpdate = false;
 	_canSetDither = false;
 
+	// Once decoding ahead was turned off or resized, the frames already
+	// decoded are shown before going on with the new setting
+	if (_decodingAhead) {
+		if (_decodedFrameCount == _decodeAheadFrames + 1 || hasDecodedFrames())
+			return takeDecodedFrame();
+
+		stopDecodeAhead();
+	}
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -195,24 +261,260 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	if (!_nextVideoTrack)
 		return 0;
 
-	const Graphics::Surface *frame = _nextVideoTrack->decodeNextFrame();
+	VideoTrack *track = _nextVideoTrack;
+	const Graphics::Surface *frame = track->decodeNextFrame();
 
-	if (_nextVideoTrack->hasDirtyPalette()) {
-		_palette = _nextVideoTrack->getPalette();
+	if (track->hasDirtyPalette()) {
+		_palette = track->getPalette();
 		_dirtyPalette = true;
 	}
 
 	// Look for the next video track here for the next decode.
 	findNextVideoTrack();
 
+	if (_decodeAheadFrames && canDecodeAhead(track))
+		return startDecodeAhead(frame, track);
+
 	return frame;
 }
 
+void VideoDecoder::setDecodeAhead(uint frames) {
+	_decodeAheadFrames = frames;
+
+	if (!frames || _decodeAheadPool)
+		return;
+
+	_decodeAheadPool = new Common::WorkerPool(1);
+	_frameDecoded = new Common::Semaphore();
+
+	if (_decodeAheadPool->getThreadCount() == 0 || !_frameDecoded->isValid()) {
+		// Keep decoding in decodeNextFrame()
+		delete _decodeAheadPool;
+		delete _frameDecoded;
+		_decodeAheadPool = 0;
+		_frameDecoded = 0;
+		return;
+	}
+
+	_decodeAheadJob = new DecodeAheadJob(this);
+}
+
+bool VideoDecoder::canDecodeAhead(const VideoTrack *track) const {
+	if (!_decodeAheadPool || track->isReversed() || track->endOfTrack())
+		return false;
+
+	// The decoded frames keep the state of the one track they come from
+	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo && *it != track)
+			return false;
+
+	// Internal audio tracks are fed by readNextPacket(), which the job calls
+	// while the mixer reads them, and not all packetized streams lock their
+	// queue. External ones play from their own file.
+	for (TrackList::const_iterator it = _internalTracks.begin(); it != _internalTracks.end(); it++)
+		if ((*it)->getTrackType() == Track::kTrackTypeAudio)
+			return false;
+
+	return true;
+}
+
+const Graphics::Surface *VideoDecoder::startDecodeAhead(const Graphics::Surface *frame, const VideoTrack *track) {
+	if (_decodedFrameCount != _decodeAheadFrames + 1) {
+		freeDecodedFrames();
+		_decodedFrameCount = _decodeAheadFrames + 1;
+		_decodedFrames = new DecodedFrame[_decodedFrameCount];
+		_decodeAheadPalette = new byte[256 * 3];
+	}
+
+	// The frame was decoded into the track, which is about to decode the
+	// next ones, so it is shown from a copy like the frames to come
+	storeDecodedFrame(_decodedFrames[0], frame, track);
+	if (_palette) {
+		memcpy(_decodeAheadPalette, _palette, 256 * 3);
+		_palette = _decodeAheadPalette;
+	}
+
+	_decodedRead = 0;
+	_decodedWrite = 1;
+	_decodeAheadQueued = true;
+	_decodeAheadCancel = false;
+	_waitingForFrame = false;
+	_decodingAhead = true;
+	_decodeAheadPool->addJob(_decodeAheadJob);
+
+	return frame ? &_decodedFrames[0].surface : 0;
+}
+
+void VideoDecoder::stopDecodeAhead() {
+	if (!_decodingAhead)
+		return;
+
+	_decodeAheadMutex.lock();
+	_decodeAheadCancel = true;
+	_decodeAheadMutex.unlock();
+
+	_decodeAheadPool->wait();
+
+	// The buffers stay allocated, so that the frame on screen remains valid
+	_droppedFrames += _decodedWrite - _decodedRead - 1;
+	_decodingAhead = false;
+}
+
+void VideoDecoder::freeDecodedFrames() {
+	if (_palette == _decodeAheadPalette)
+		_palette = 0;
+
+	delete[] _decodedFrames;
+	delete[] _decodeAheadPalette;
+	_decodedFrames = 0;
+	_decodeAheadPalette = 0;
+	_decodedFrameCount = 0;
+}
+
+bool VideoDecoder::hasDecodedFrames() {
+	Common::StackLock lock(_decodeAheadMutex);
+	return _decodedWrite - _decodedRead > 1 || _decodeAheadQueued;
+}
+
+const Graphics::Surface *VideoDecoder::takeDecodedFrame() {
+	const bool current = _decodedFrameCount == _decodeAheadFrames + 1;
+	bool late = false;
+
+	_decodeAheadMutex.lock();
+	while (_decodedWrite - _decodedRead == 1) {
+		if (_decodedFrames[_decodedRead % _decodedFrameCount].endOfTrack) {
+			// Like the track, return no frame past its end
+			_decodeAheadMutex.unlock();
+			return 0;
+		}
+
+		if (!_decodeAheadQueued) {
+			if (!current) {
+				_decodeAheadMutex.unlock();
+				return 0;
+			}
+
+			_decodeAheadQueued = true;
+			_decodeAheadMutex.unlock();
+			_decodeAheadPool->addJob(_decodeAheadJob);
+			_decodeAheadMutex.lock();
+			continue;
+		}
+
+		late = true;
+		_waitingForFrame = true;
+		_decodeAheadMutex.unlock();
+		_frameDecoded->wait();
+		_decodeAheadMutex.lock();
+	}
+
+	// Hand the buffer of the previous frame back to the job
+	++_decodedRead;
+	const DecodedFrame &decoded = _decodedFrames[_decodedRead % _decodedFrameCount];
+
+	bool queueJob = false;
+	if (current && !_decodeAheadQueued && !decoded.endOfTrack) {
+		_decodeAheadQueued = true;
+		queueJob = true;
+	}
+	_decodeAheadMutex.unlock();
+
+	if (queueJob)
+		_decodeAheadPool->addJob(_decodeAheadJob);
+
+	if (late)
+		++_lateFrames;
+
+	if (decoded.dirtyPalette) {
+		memcpy(_decodeAheadPalette, decoded.palette, 256 * 3);
+		_palette = _decodeAheadPalette;
+		_dirtyPalette = true;
+	}
+
+	return decoded.hasSurface ? &decoded.surface : 0;
+}
+
+void VideoDecoder::storeDecodedFrame(DecodedFrame &decoded, const Graphics::Surface *frame, const VideoTrack *track) const {
+	decoded.hasSurface = frame != 0;
+
+	if (frame) {
+		// Reuse the buffer unless the frame size changed
+		if (decoded.surface.w != frame->w || decoded.surface.h != frame->h || decoded.surface.format != frame->format) {
+			decoded.surface.free();
+			decoded.surface.create(frame->w, frame->h, frame->format);
+		}
+
+		decoded.surface.copyRectToSurface(*frame, 0, 0, Common::Rect(frame->w, frame->h));
+	}
+
+	decoded.dirtyPalette = track->hasDirtyPalette();
+	if (decoded.dirtyPalette)
+		memcpy(decoded.palette, track->getPalette(), 256 * 3);
+
+	decoded.curFrame = track->getCurFrame();
+	decoded.nextFrameStartTime = track->getNextFrameStartTime();
+	decoded.endOfTrack = track->endOfTrack();
+}
+
+void VideoDecoder::decodeAhead() {
+	while (true) {
+		_decodeAheadMutex.lock();
+
+		const uint32 write = _decodedWrite;
+		const bool full = write - _decodedRead == _decodedFrameCount;
+		if (_decodeAheadCancel || full || _decodedFrames[(write - 1) % _decodedFrameCount].endOfTrack) {
+			_decodeAheadQueued = false;
+			if (_waitingForFrame) {
+				_waitingForFrame = false;
+				_frameDecoded->signal();
+			}
+			_decodeAheadMutex.unlock();
+			return;
+		}
+
+		_decodeAheadMutex.unlock();
+
+		readNextPacket();
+
+		VideoTrack *track = _nextVideoTrack;
+		const Graphics::Surface *frame = track->decodeNextFrame();
+		storeDecodedFrame(_decodedFrames[write % _decodedFrameCount], frame, track);
+		findNextVideoTrack();
+
+		_decodeAheadMutex.lock();
+		_decodedWrite = write + 1;
+		if (_waitingForFrame) {
+			_waitingForFrame = false;
+			_frameDecoded->signal();
+		}
+		_decodeAheadMutex.unlock();
+	}
+}
+
+const VideoDecoder::DecodedFrame *VideoDecoder::getShownFrame() const {
+	return _decodingAhead ? &_decodedFrames[_decodedRead % _decodedFrameCount] : 0;
+}
+
+bool VideoDecoder::videoTrackEnded(const VideoTrack *track) const {
+	const DecodedFrame *shown = getShownFrame();
+	return shown ? shown->endOfTrack : track->endOfTrack();
+}
+
+uint32 VideoDecoder::getVideoTrackNextFrameStartTime(const VideoTrack *track) const {
+	const DecodedFrame *shown = getShownFrame();
+	return shown ? shown->nextFrameStartTime : track->getNextFrameStartTime();
+}
+
 bool VideoDecoder::setReverse(bool reverse) {
 	// Can only reverse video-only videos
 	if (reverse && hasAudio())
 		return false;
 
+	// Frames are only decoded ahead while playing forward, and the track
+	// belongs to the job until the video is seeked or rewound
+	if (_decodingAhead)
+		return !reverse;
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
@@ -233,6 +535,9 @@ const byte *VideoDecoder::getPalette() {
 }
 
 int VideoDecoder::getCurFrame() const {
+	if (const DecodedFrame *shown = getShownFrame())
+		return shown->curFrame;
+
 	int32 frame = -1;
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
@@ -274,13 +579,14 @@ uint32 VideoDecoder::getTime() const {
 }
 
 uint32 VideoDecoder::getTimeToNextFrame() const {
-	if (endOfVideo() || _needsUpdate || !_nextVideoTrack)
+	const DecodedFrame *shown = getShownFrame();
+	if (endOfVideo() || _needsUpdate || (shown ? shown->endOfTrack : !_nextVideoTrack))
 		return 0;
 
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+	uint32 nextFrameStartTime = shown ? shown->nextFrameStartTime : _nextVideoTrack->getNextFrameStartTime();
 
-	if (_nextVideoTrack->isReversed()) {
+	if (!shown && _nextVideoTrack->isReversed()) {
 		// For reversed videos, we need to handle the time difference the opposite way.
 		if (nextFrameStartTime >= currentTime)
 			return 0;
@@ -298,9 +604,10 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 bool VideoDecoder::endOfVideo() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		const Track *track = *it;
+		const bool isVideo = track->getTrackType() == Track::kTrackTypeVideo;
 
-		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && isVideo && getVideoTrackNextFrameStartTime((const VideoTrack *)track) >= (uint)_endTime.msecs();
+		bool endReached = (isVideo ? videoTrackEnded((const VideoTrack *)track) : track->endOfTrack()) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return false;
 	}
@@ -323,6 +630,8 @@ bool VideoDecoder::rewind() {
 	if (!isRewindable())
 		return false;
 
+	stopDecodeAhead();
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
@@ -357,6 +666,8 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (!isSeekable())
 		return false;
 
+	stopDecodeAhead();
+
 	// Stop all tracks so they can be seeked
 	if (isPlaying())
 		stopAudio();
@@ -864,7 +1175,7 @@ const VideoDecoder::Track *VideoDecoder::getTrack(uint track) const {
 
 bool VideoDecoder::endOfVideoTracks() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
-		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !(*it)->endOfTrack())
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !videoTrackEnded((const VideoTrack *)*it))
 			return false;
 
 	return true;
@@ -924,8 +1235,8 @@ bool VideoDecoder::hasFramesLeft() const {
 
 		const VideoTrack *track = (const VideoTrack *)*it;
 
-		bool videoEndTimeReached = _endTimeSet && track->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && getVideoTrackNextFrameStartTime(track) >= (uint)_endTime.msecs();
+		bool endReached = videoTrackEnded(track) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return true;
 	}
@@ -26,6 +26,7 @@
 #include "audio/mixer.h"
 #include "audio/timestamp.h"	// TODO: Move this to common/ ?
 #include "common/array.h"
+#include "common/mutex.h"
 #include "common/rational.h"
 #include "common/str.h"
 #include "graphics/pixelformat.h"
@@ -38,6 +39,7 @@ class SeekableAudioStream;
 
 namespace Common {
 class SeekableReadStream;
+class WorkerPool;
 }
 
 namespace Graphics {
@@ -52,7 +54,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -396,6 +398,48 @@ public:
 	 */
 	bool setDitheringPalette(const byte *palette);
 
+	/**
+	 * Decode frames ahead of playback on a worker thread.
+	 *
+	 * Up to the given number of frames are decoded and copied into a queue
+	 * of recycled surfaces while the engine shows the current one, so that
+	 * a slow frame does not stall the engine in decodeNextFrame(). Passing
+	 * 0, the default, decodes each frame when it is asked for.
+	 *
+	 * This only applies to videos with a single video track played forward
+	 * and no audio tracks of their own, as the worker thread also reads the
+	 * packets which feed them. Audio added with addStreamFileTrack() is fine.
+	 * It falls back to decoding in decodeNextFrame() when the backend has no
+	 * threads. Seeking, rewinding and closing the video discard the queue.
+	 * When the number of frames changes during playback, the frames already
+	 * decoded are shown first.
+	 *
+	 * @note While decoding ahead, the tracks are used by the worker thread,
+	 *       so they must not be accessed directly until the video is
+	 *       closed, seeked or rewound.
+	 * @note A surface returned by decodeNextFrame() is valid until the next
+	 *       call, as it would be when decoding synchronously.
+	 * @param frames The number of frames to decode ahead
+	 */
+	void setDecodeAhead(uint frames);
+
+	/**
+	 * Returns the number of frames to decode ahead of playback.
+	 */
+	uint getDecodeAhead() const { return _decodeAheadFrames; }
+
+	/**
+	 * Returns the number of frames which decodeNextFrame() had to wait for,
+	 * because they were not decoded ahead in time.
+	 */
+	uint32 getLateFrameCount() const { return _lateFrames; }
+
+	/**
+	 * Returns the number of frames which were decoded ahead but discarded
+	 * without being shown, because the video was seeked or rewound.
+	 */
+	uint32 getDroppedFrameCount() const { return _droppedFrames; }
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -959,6 +1003,45 @@ private:
 	// Default PixelFormat settings
 	Graphics::PixelFormat _defaultHighColorFormat;
 
+	// Decoding ahead on a worker thread
+	class DecodeAheadJob;
+	struct DecodedFrame;
+
+	bool canDecodeAhead(const VideoTrack *track) const;
+	const Graphics::Surface *startDecodeAhead(const Graphics::Surface *frame, const VideoTrack *track);
+	void stopDecodeAhead();
+	void freeDecodedFrames();
+	bool hasDecodedFrames();
+	const Graphics::Surface *takeDecodedFrame();
+	void storeDecodedFrame(DecodedFrame &decoded, const Graphics::Surface *frame, const VideoTrack *track) const;
+	void decodeAhead();
+
+	/** State of the frame last returned by decodeNextFrame(), or 0 when not decoding ahead. */
+	const DecodedFrame *getShownFrame() const;
+	bool videoTrackEnded(const VideoTrack *track) const;
+	uint32 getVideoTrackNextFrameStartTime(const VideoTrack *track) const;
+
+	uint _decodeAheadFrames;
+	Common::WorkerPool *_decodeAheadPool;
+	DecodeAheadJob *_decodeAheadJob;
+	Common::Semaphore *_frameDecoded;
+	bool _decodingAhead;
+
+	// Ring of decoded frames, with the shown one at _decodedRead. The job
+	// decodes into the free ones from _decodedWrite. Guarded by the mutex.
+	Common::Mutex _decodeAheadMutex;
+	DecodedFrame *_decodedFrames;
+	uint _decodedFrameCount;
+	uint32 _decodedRead;
+	uint32 _decodedWrite;
+	bool _decodeAheadQueued;
+	bool _decodeAheadCancel;
+	bool _waitingForFrame;
+	byte *_decodeAheadPalette;
+
+	uint32 _lateFrames;
+	uint32 _droppedFrames;
+
 protected:
 	// Internal helper functions
 	void stopAudio();